@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_H_
 #define MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_H_
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <future>
@@ -26,42 +28,130 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "asio/io_service_strand.hpp"
 #include "boost/filesystem/path.hpp"
+#include "boost/optional.hpp"
 
 #include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/error.h"
 #include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/passport.h"
 
+#include "maidsafe/vault_manager/vault_event.h"
+#include "maidsafe/vault_manager/vault_output.h"
+#include "maidsafe/vault_manager/vault_stats.h"
+#include "maidsafe/vault_manager/vault_status.h"
+
 namespace maidsafe {
 
 namespace vault_manager {
 
 namespace detail {
 
-template <typename ResultType, typename MessageType>
-struct PromiseAndTimer;
+template <typename ResultType>
+struct HandlerAndTimer;
 
 }  // namespace detail
 
 struct Challenge;
+class HandlerGuard;
+struct HostStatsResponse;
+struct ListVaultsResponse;
 struct LogMessage;
+struct ResumeSessionResponse;
+struct SessionTicket;
+struct TailVaultOutputResponse;
+struct VaultEventNotification;
 struct VaultRunningResponse;
+struct VaultSpawned;
 struct VaultStartedResponse;
 
+// Describes one vault to be started via ClientInterface::StartVaults.  An empty 'vault_dir' causes
+// the VaultManager to choose a default location.
+struct VaultSpec {
+  VaultSpec() : vault_dir(), max_disk_usage(0) {}
+  VaultSpec(boost::filesystem::path vault_dir_in, DiskUsage max_disk_usage_in)
+      : vault_dir(std::move(vault_dir_in)), max_disk_usage(max_disk_usage_in) {}
+
+  boost::filesystem::path vault_dir;
+  DiskUsage max_disk_usage;
+#ifdef USE_VLOGGING
+  std::string vlog_session_id;
+#endif
+#ifdef TESTING
+  boost::optional<int> pmid_list_index;
+#endif
+};
+
+// The blocking constructors and std::future-returning functions are convenient for simple tools.
+// Applications managing many vaults should prefer Connect and the Async functions.  Handlers are
+// invoked on the thread running the ClientInterface's io_service; they must not block, and must not
+// destroy the ClientInterface which invoked them.
+//
+// Unless an io_service is passed in, each ClientInterface runs its own single-threaded io_service.
+// A passed-in io_service must be run by at least one thread other than those calling the blocking
+// functions here, and may outlive the ClientInterface.
+//
+// If the connection to the VaultManager is lost, the ClientInterface reconnects with randomised
+// exponential backoff, resumes its session via the ticket issued on validation (falling back to a
+// full Challenge if the ticket is rejected), then re-sends any requests still awaiting a response.
+// These keep their original timeouts.  A vault event subscription is renewed from the last event
+// received, so no retained events are missed.
+//
+// A vault being started must be spawned by the VaultManager within 10 minutes of being requested,
+// which allows for generating its keys and queueing behind other vaults, then must report itself
+// running within 30 seconds of being spawned.
 class ClientInterface {
  public:
+  typedef std::function<void(maidsafe_error)> ValidatedHandler;
+  typedef std::function<void(maidsafe_error, std::unique_ptr<passport::PmidAndSigner>)>
+      VaultResultHandler;
+  // Invoked once per vault, with the index of that vault's VaultSpec.
+  typedef std::function<void(std::size_t, maidsafe_error,
+                             std::unique_ptr<passport::PmidAndSigner>)> BatchVaultResultHandler;
+  typedef std::function<void(maidsafe_error, std::vector<VaultStatus>)> VaultStatusesHandler;
+  typedef std::function<void(maidsafe_error, VaultStatus)> VaultStatusHandler;
+  typedef std::function<void(const VaultEvent&)> VaultEventHandler;
+  typedef std::function<void(maidsafe_error, HostStats)> HostStatsHandler;
+  typedef std::function<void(maidsafe_error, VaultOutput)> VaultOutputHandler;
+
   ClientInterface(const ClientInterface&) = delete;
   ClientInterface(ClientInterface&&) = delete;
   ClientInterface& operator=(ClientInterface) = delete;
 
+  // Blocks until the VaultManager's validation challenge has been answered.
   explicit ClientInterface(const passport::Maid& maid);
+  ClientInterface(const passport::Maid& maid, asio::io_service& io_service);
   ~ClientInterface();
 
+  // Connects to the VaultManager and returns without waiting for the validation challenge.
+  // 'on_validated' is invoked once the challenge has been answered, or with an error if it doesn't
+  // arrive in time.  No other requests should be made until then.  Throws if no VaultManager can be
+  // reached.
+  static std::unique_ptr<ClientInterface> Connect(const passport::Maid& maid,
+                                                  ValidatedHandler on_validated);
+  static std::unique_ptr<ClientInterface> Connect(const passport::Maid& maid,
+                                                  asio::io_service& io_service,
+                                                  ValidatedHandler on_validated);
+
+  void AsyncTakeOwnership(const NonEmptyString& label, const boost::filesystem::path& vault_dir,
+                          DiskUsage max_disk_usage, VaultResultHandler handler);
+#ifdef USE_VLOGGING
+  void AsyncStartVault(const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
+                       const std::string& vlog_session_id, VaultResultHandler handler);
+#else
+  void AsyncStartVault(const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
+                       VaultResultHandler handler);
+#endif
+  void AsyncStartVaults(const std::vector<VaultSpec>& vault_specs, int max_concurrent_starts,
+                        BatchVaultResultHandler handler);
+
   std::future<std::unique_ptr<passport::PmidAndSigner>> TakeOwnership(
       const NonEmptyString& label, const boost::filesystem::path& vault_dir,
       DiskUsage max_disk_usage);
@@ -75,6 +165,44 @@ class ClientInterface {
       const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage);
 #endif
 
+  // Starts all the vaults via a single request.  The returned futures are in the same order as
+  // 'vault_specs'.  If 'max_concurrent_starts' is non-zero, the VaultManager won't have more than
+  // that many of these vaults starting at once (it also applies its own limit).
+  std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> StartVaults(
+      const std::vector<VaultSpec>& vault_specs, int max_concurrent_starts = 0);
+
+  // These are answered from the VaultManager's in-memory state, so are cheap enough to be polled.
+  // GetVaultStatus fails with CommonErrors::no_such_element if there is no vault with 'label'.
+  void AsyncListVaults(VaultStatusesHandler handler);
+  void AsyncGetVaultStatus(const NonEmptyString& label, VaultStatusHandler handler);
+  std::future<std::vector<VaultStatus>> ListVaults();
+  std::future<VaultStatus> GetVaultStatus(const NonEmptyString& label);
+
+  // Returns the latest stats reported by each vault along with totals for the host.
+  void AsyncGetHostStats(HostStatsHandler handler);
+  std::future<HostStats> GetHostStats();
+
+  // Returns the vault's most recent stdout and stderr output from 'cursor' onwards, limited in size
+  // per call.  Pass the returned 'next_cursor' to the next call to follow the output.  Output is
+  // only captured if the VaultManager's capture_vault_output option is set (see
+  // VaultManagerOptions), and never on Windows.  Fails with CommonErrors::no_such_element if there
+  // is no vault with 'label', or with CommonErrors::invalid_argument if the vault isn't owned by
+  // this client.
+  void AsyncTailVaultOutput(const NonEmptyString& label, std::uint64_t cursor,
+                            VaultOutputHandler handler);
+  std::future<VaultOutput> TailVaultOutput(const NonEmptyString& label, std::uint64_t cursor = 0);
+
+  // Streams lifecycle events of all vaults to 'handler', in sequence order and without duplicates.
+  // Events still retained by the VaultManager with a sequence number greater than
+  // 'after_sequence_number' are replayed first; pass the last sequence number seen by a previous
+  // subscriber to resume from there.  A further call replaces the handler.
+  void SubscribeToVaultEvents(VaultEventHandler handler, std::uint64_t after_sequence_number = 0);
+  // Once this returns, the handler isn't executing and won't be invoked again, so anything it uses
+  // can be destroyed.  This also applies to the handler replaced by a further call to
+  // SubscribeToVaultEvents.  If called from within the handler, it returns without waiting for the
+  // handler itself to return.
+  void UnsubscribeFromVaultEvents();
+
 #ifdef TESTING
   // This function sets up global variables specifying:
   // * the desired TCP listening port of the VaultManager (VM)
@@ -84,9 +212,15 @@ class ClientInterface {
   //
   // 'test_env_root_dir' must exist when this call is made or an error will be thrown.
   // The function should only be called once - further calls are no-ops.
+  //
+  // If 'key_chain_path' is non-empty, the PublicPmids are loaded from that key chain file, which is
+  // created (or extended) and saved if it holds fewer than 'pmid_list_size' key chains, so repeated
+  // runs can skip the key generation.
   static void SetTestEnvironment(uint16_t test_vault_manager_port,
                                  boost::filesystem::path test_env_root_dir,
-                                 boost::filesystem::path path_to_vault, int pmid_list_size);
+                                 boost::filesystem::path path_to_vault, int pmid_list_size,
+                                 boost::filesystem::path key_chain_path =
+                                     boost::filesystem::path());
 
 #ifdef USE_VLOGGING
   std::future<std::unique_ptr<passport::PmidAndSigner>> StartVault(
@@ -110,14 +244,57 @@ class ClientInterface {
 #endif
 
  private:
-  typedef detail::PromiseAndTimer<std::unique_ptr<passport::PmidAndSigner>, VaultStartedResponse>
-      VaultRequest;
+  typedef detail::HandlerAndTimer<std::unique_ptr<passport::PmidAndSigner>> VaultRequest;
+  typedef detail::HandlerAndTimer<std::vector<VaultStatus>> StatusRequest;
+  typedef detail::HandlerAndTimer<HostStats> StatsRequest;
+  typedef detail::HandlerAndTimer<VaultOutput> OutputRequest;
+  struct Unvalidated {};
 
+  ClientInterface(const passport::Maid& maid, asio::io_service* io_service, Unvalidated);
   std::shared_ptr<tcp::Connection> ConnectToVaultManager();
+  void RequestValidation(ValidatedHandler on_validated);
+  void RequestResumption(crypto::CipherText ticket);
+  void Revalidate();
+  void OnSessionEstablished();
+  void OnConnectionClosed();
+  void ScheduleReconnect();
+  void Reconnect();
+  tcp::ConnectionPtr GetConnection();
+  // Sends 'request' once validated, and retains it for re-sending after a reconnect until all of
+  // 'labels' have been answered or have timed out.
+  template <typename Request>
+  void SendRequest(const std::vector<NonEmptyString>& labels, Request request);
+  // Registers 'handler' in 'ongoing_requests' under a new request ID, then sends the request which
+  // 'make_request' builds from that ID.  As with SendRequest, it is sent once validated and is
+  // retained for re-sending after a reconnect until answered or timed out.
+  template <typename ResultType, typename MakeRequest>
+  void SendIdentifiedRequest(
+      std::map<std::uint32_t, std::shared_ptr<detail::HandlerAndTimer<ResultType>>>&
+          ongoing_requests,
+      typename detail::HandlerAndTimer<ResultType>::Handler handler, MakeRequest make_request);
+  // Removes and returns the request with 'request_id', or returns nullptr if there's none pending.
+  template <typename ResultType>
+  std::shared_ptr<detail::HandlerAndTimer<ResultType>> TakeIdentifiedRequest(
+      std::map<std::uint32_t, std::shared_ptr<detail::HandlerAndTimer<ResultType>>>&
+          ongoing_requests,
+      std::uint32_t request_id);
   std::future<std::unique_ptr<passport::PmidAndSigner>> AddVaultRequest(
-      const NonEmptyString& label);
+      const NonEmptyString& label,
+      std::chrono::steady_clock::duration timeout = std::chrono::seconds(30));
+  void AddVaultRequest(const NonEmptyString& label, VaultResultHandler handler,
+                       std::chrono::steady_clock::duration timeout = std::chrono::seconds(30));
   void HandleReceivedMessage(tcp::Message&& message);
   void HandleVaultRunningResponse(VaultRunningResponse&& vault_running_response);
+  void HandleVaultSpawned(VaultSpawned&& vault_spawned);
+  void SendListVaultsRequest(boost::optional<NonEmptyString> vault_label,
+                             VaultStatusesHandler handler);
+  void HandleListVaultsResponse(ListVaultsResponse&& list_vaults_response);
+  void HandleHostStatsResponse(HostStatsResponse&& host_stats_response);
+  void HandleTailVaultOutputResponse(TailVaultOutputResponse&& tail_vault_output_response);
+  void HandleVaultEventNotification(VaultEventNotification&& vault_event_notification);
+  void CloseVaultEventGuard(const std::shared_ptr<HandlerGuard>& guard);
+  void HandleSessionTicket(SessionTicket&& session_ticket);
+  void HandleResumeSessionResponse(ResumeSessionResponse&& resume_session_response);
 #ifdef TESTING
   void HandleNetworkStableResponse();
 #endif
@@ -130,11 +307,28 @@ class ClientInterface {
   std::promise<void> network_stable_;
   std::once_flag network_stable_flag_;
   std::map<NonEmptyString, std::shared_ptr<VaultRequest>> ongoing_vault_requests_;
-  AsioService asio_service_;
+  std::uint32_t next_status_request_id_;
+  std::map<std::uint32_t, std::shared_ptr<StatusRequest>> ongoing_status_requests_;
+  std::map<std::uint32_t, std::shared_ptr<StatsRequest>> ongoing_stats_requests_;
+  std::map<std::uint32_t, std::shared_ptr<OutputRequest>> ongoing_output_requests_;
+  VaultEventHandler on_vault_event_;
+  // Closed when 'on_vault_event_' is replaced or removed, to wait for any invocation in progress.
+  std::shared_ptr<HandlerGuard> vault_event_guard_;
+  std::uint64_t last_vault_event_sequence_number_;
+  std::function<void(ResumeSessionResponse&&)> on_resume_session_response_;
+  std::unique_ptr<crypto::CipherText> session_ticket_;
+  std::map<NonEmptyString, std::shared_ptr<tcp::Message>> unanswered_requests_;
+  std::map<std::uint32_t, std::shared_ptr<tcp::Message>> unanswered_identified_requests_;
+  bool validated_, stopping_;
+  int reconnect_attempt_;
+  std::unique_ptr<AsioService> asio_service_;
+  asio::io_service& io_service_;
   asio::io_service::strand strand_;
+  std::shared_ptr<HandlerGuard> handler_guard_;
   std::shared_ptr<tcp::Connection> tcp_connection_;
-  // We need to ensure the connection is closed in the event of the constructor throwing, or the
-  // asio_service destructor will hang.
+  // We need to ensure the connection is closed and our handlers are drained in the event of the
+  // constructor throwing, or the asio_service destructor will hang (or, if the io_service isn't
+  // ours, handlers could run after we're destroyed).
   on_scope_exit connection_closer_;
 };
 
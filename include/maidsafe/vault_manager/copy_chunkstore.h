@@ -0,0 +1,47 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_COPY_CHUNKSTORE_H_
+#define MAIDSAFE_VAULT_MANAGER_COPY_CHUNKSTORE_H_
+
+#include <cstdint>
+#include <functional>
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+typedef std::function<void(std::uint64_t bytes_copied, std::uint64_t bytes_total)>
+    CopyProgressFunctor;
+
+// Copies each file under 'source' to the same relative path under 'target' at no more than
+// 'max_bytes_per_second' (0 for unlimited), so that a vault can carry on serving from 'source'
+// meanwhile.  Each file is written under a temporary name and renamed once complete, so 'target'
+// never holds a partial file, and files already in 'target' with the right size are skipped, so an
+// interrupted copy can be resumed.  'on_progress' is invoked after each file.  Throws on failure.
+void CopyChunkstore(const boost::filesystem::path& source, const boost::filesystem::path& target,
+                    std::uint64_t max_bytes_per_second,
+                    CopyProgressFunctor on_progress = nullptr);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_COPY_CHUNKSTORE_H_
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_VAULT_CONFIG_H_
 #define MAIDSAFE_VAULT_MANAGER_VAULT_CONFIG_H_
 
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -41,6 +42,8 @@ struct VaultConfig {
   passport::Pmid pmid;
   boost::filesystem::path vault_dir;
   DiskUsage max_disk_usage;
+  // How often the VaultInterface sends heartbeats to the VaultManager.  0 if they're disabled.
+  std::chrono::milliseconds heartbeat_interval;
 #ifdef TESTING
   enum class TestType : int32_t {
     kNone,
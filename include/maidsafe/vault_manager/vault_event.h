@@ -0,0 +1,64 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+enum class VaultEventType : std::int32_t {
+  kSpawned,     // The process has been launched.
+  kStarted,     // The process has connected to the VaultManager.
+  kJoined,      // The vault has joined the network.
+  kExited,      // The process has exited or been terminated.
+  kRestarting,  // The process exited unexpectedly and is being restarted.
+  kStopped      // The process has exited after being asked to stop.
+};
+
+// A change in a vault's lifecycle, as published by the VaultManager to subscribed clients.
+//
+// Sequence numbers are seeded from the system clock when the VaultManager starts, so they keep
+// increasing across VaultManager restarts.  Within one run they're contiguous, so a gap means the
+// subscriber has missed events which are no longer retained by the VaultManager.
+struct VaultEvent {
+  VaultEvent() : sequence_number(0), type(VaultEventType::kSpawned), label(), process_id(0),
+                 exit_code(0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(sequence_number, type, label, process_id, exit_code);
+  }
+
+  std::uint64_t sequence_number;
+  VaultEventType type;
+  NonEmptyString label;
+  std::uint64_t process_id;
+  std::int32_t exit_code;  // Only meaningful for kExited; -1 if the process was terminated.
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_VAULT_INTERFACE_H_
 #define MAIDSAFE_VAULT_MANAGER_VAULT_INTERFACE_H_
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
@@ -28,36 +30,93 @@
 #include <string>
 
 #include "asio/io_service_strand.hpp"
+#include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
 #include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/vault_manager/vault_config.h"
+#include "maidsafe/vault_manager/vault_stats.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
+class HandlerGuard;
+struct MaxDiskUsageUpdate;
+struct MoveChunkstoreRequest;
+struct VaultShutdownRequest;
 struct VaultStartedResponse;
 
 class VaultInterface {
  public:
+  typedef std::function<void(DiskUsage)> OnMaxDiskUsageUpdateFunctor;
+  typedef std::function<void(boost::filesystem::path vault_dir,
+                             std::uint64_t max_bytes_per_second)> OnMoveChunkstoreFunctor;
+  typedef std::function<void(std::chrono::steady_clock::time_point deadline)> OnDrainFunctor;
+
   VaultInterface(const VaultInterface&) = delete;
   VaultInterface(VaultInterface&&) = delete;
   VaultInterface& operator=(VaultInterface) = delete;
 
+  // Both constructors block until the vault's configuration has been received.  Unless an
+  // io_service is passed in, the VaultInterface runs its own single-threaded io_service.  A
+  // passed-in io_service must be run by a thread other than the one constructing the
+  // VaultInterface, and may outlive it.
   explicit VaultInterface(tcp::Port vault_manager_port);
+  VaultInterface(tcp::Port vault_manager_port, asio::io_service& io_service);
+  ~VaultInterface();
 
+  // Reflects any updates to the disk usage limit received since construction.
   VaultConfig GetConfiguration();
 
-  // Doesn't throw.
+  // 'functor' is invoked with the new limit each time the VaultManager changes this vault's
+  // max_disk_usage, after GetConfiguration has been updated.  It runs on the io_service thread.
+  void SetMaxDiskUsageUpdateFunctor(OnMaxDiskUsageUpdateFunctor functor);
+
+  // 'functor' is invoked when the VaultManager asks this vault to move its chunkstore to
+  // 'vault_dir'.  It runs on the io_service thread, so should hand the work off.  The vault should
+  // carry on serving from its current dir while copying its data across (e.g. via CopyChunkstore,
+  // throttled to 'max_bytes_per_second'), call ReportChunkstoreMoveProgress periodically, then
+  // switch over and call ChunkstoreMoved.  If no functor is set, the request is refused and the
+  // VaultManager instead restarts the vault using the new dir.
+  void SetMoveChunkstoreFunctor(OnMoveChunkstoreFunctor functor);
+  void ReportChunkstoreMoveProgress(std::uint64_t bytes_moved, std::uint64_t bytes_total);
+  // Pass success once the vault is using 'vault_dir', or the reason the move was abandoned.  The
+  // VaultManager only records the new dir as the vault's once it has succeeded.
+  void ChunkstoreMoved(const boost::filesystem::path& vault_dir, const maidsafe_error& result);
+
+  // 'functor' is invoked when the VaultManager asks this vault to stop.  It runs on the io_service
+  // thread, so should hand the work off.  The vault should stop accepting new work, finish or hand
+  // off its in-flight work before 'deadline', calling ReportDrainProgress periodically, then call
+  // DrainComplete, after which WaitForExit returns 0.  A vault still running at the deadline is
+  // sent SIGTERM, then killed.  If no functor is set, WaitForExit returns 0 as soon as the request
+  // arrives.
+  void SetDrainFunctor(OnDrainFunctor functor);
+  void ReportDrainProgress(std::uint64_t remaining);
+  void DrainComplete();
+
+  // Doesn't throw.  If the connection to the VaultManager is lost, the VaultInterface keeps trying
+  // to reconnect (to a restarted VaultManager, found via its discovery file) for up to
+  // kVaultReconnectTimeout, and only then returns VaultManagerErrors::connection_aborted.
   int WaitForExit();
 
   void SendJoined();
 
+  // Heartbeats are sent to the VaultManager automatically, but only show that this interface is
+  // running.  A vault should call this from its main event loop at least once per
+  // VaultConfig::heartbeat_interval; once it has, the VaultManager restarts the vault if its
+  // heartbeats stop showing progress.  Threadsafe and cheap.
+  void ReportProgress();
+
+  // Records the vault's current stats.  The most recent record is sent to the VaultManager once per
+  // stats interval, so this can be called as often as is convenient.  Threadsafe.
+  void ReportStats(const VaultStats& stats);
+
 #ifdef TESTING
   void KillConnection();
   void SendInvalidMessage();
@@ -65,22 +124,45 @@ class VaultInterface {
 #endif
 
  private:
+  VaultInterface(tcp::Port vault_manager_port, asio::io_service* io_service);
+
   void HandleReceivedMessage(tcp::Message&& message);
   void OnConnectionClosed();
+  void ScheduleReconnect();
+  void Reconnect();
+  tcp::ConnectionPtr GetConnection();
 
   void HandleVaultStartedResponse(VaultStartedResponse&& vault_started_response);
-  void HandleVaultShutdownRequest();
+  void HandleVaultShutdownRequest(VaultShutdownRequest&& vault_shutdown_request);
+  void HandleMaxDiskUsageUpdate(MaxDiskUsageUpdate&& max_disk_usage_update);
+  void HandleMoveChunkstoreRequest(MoveChunkstoreRequest&& move_chunkstore_request);
+  void SendHeartbeat();
+  void SendStats();
 
   std::promise<int> exit_code_promise_;
   std::once_flag exit_code_flag_;
   tcp::Port vault_manager_port_;
   std::function<void(VaultStartedResponse&&)> on_vault_started_response_;
+  std::mutex config_mutex_;
   std::unique_ptr<VaultConfig> vault_config_;
-  AsioService asio_service_;
+  OnMaxDiskUsageUpdateFunctor on_max_disk_usage_update_;
+  OnMoveChunkstoreFunctor on_move_chunkstore_;
+  OnDrainFunctor on_drain_;
+  std::atomic<std::uint64_t> progress_;
+  std::mutex stats_mutex_;
+  std::unique_ptr<VaultStats> pending_stats_;
+  std::unique_ptr<AsioService> asio_service_;
+  asio::io_service& io_service_;
   asio::io_service::strand strand_;
+  std::shared_ptr<HandlerGuard> handler_guard_;
+  std::mutex connection_mutex_;
+  bool stopping_;
+  int reconnect_attempt_;
+  std::chrono::steady_clock::time_point reconnect_deadline_;
   std::shared_ptr<tcp::Connection> tcp_connection_;
-  // We need to ensure the connection is closed in the event of the constructor throwing, or the
-  // asio_service destructor will hang.
+  // We need to ensure the connection is closed and our handlers are drained in the event of the
+  // constructor throwing, or the asio_service destructor will hang (or, if the io_service isn't
+  // ours, handlers could run after we're destroyed).
   on_scope_exit connection_closer_;
 };
 
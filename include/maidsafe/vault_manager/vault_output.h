@@ -0,0 +1,51 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_OUTPUT_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_OUTPUT_H_
+
+#include <cstdint>
+#include <string>
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// A section of a vault's combined stdout and stderr, as retained by the VaultManager.  Positions
+// count bytes written by the vault (across restarts) since the VaultManager started.
+struct VaultOutput {
+  VaultOutput() : data(), begin(0), next_cursor(0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(data, begin, next_cursor);
+  }
+
+  std::string data;
+  // Position of the first byte of 'data'.  This is beyond the requested cursor if the output in
+  // between has already been overwritten.
+  std::uint64_t begin;
+  // Pass as the cursor of the next request to continue from the end of 'data'.
+  std::uint64_t next_cursor;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_OUTPUT_H_
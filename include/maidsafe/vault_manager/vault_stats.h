@@ -0,0 +1,92 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_STATS_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_STATS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Reported by a vault via VaultInterface::ReportStats.  The request counts are cumulative since the
+// vault process started; the VaultManager derives rates from them.
+struct VaultStats {
+  VaultStats()
+      : chunk_count(0), bytes_used(0), get_requests(0), put_requests(0), routing_table_size(0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(chunk_count, bytes_used, get_requests, put_requests, routing_table_size);
+  }
+
+  std::uint64_t chunk_count;
+  std::uint64_t bytes_used;
+  std::uint64_t get_requests;
+  std::uint64_t put_requests;
+  std::uint32_t routing_table_size;
+};
+
+// The most recent stats of one vault, with request rates averaged over the VaultManager's retained
+// history for that vault.
+struct VaultStatsSummary {
+  VaultStatsSummary()
+      : label(), max_disk_usage(0), latest(), get_requests_per_second(0.0),
+        put_requests_per_second(0.0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(label, max_disk_usage, latest, get_requests_per_second, put_requests_per_second);
+  }
+
+  NonEmptyString label;
+  DiskUsage max_disk_usage;
+  VaultStats latest;
+  double get_requests_per_second;
+  double put_requests_per_second;
+};
+
+// Totals across all vaults on the host which have reported stats.
+struct HostStats {
+  HostStats()
+      : vaults(), chunk_count(0), bytes_used(0), max_disk_usage(0), get_requests_per_second(0.0),
+        put_requests_per_second(0.0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vaults, chunk_count, bytes_used, max_disk_usage, get_requests_per_second,
+            put_requests_per_second);
+  }
+
+  std::vector<VaultStatsSummary> vaults;
+  std::uint64_t chunk_count;
+  std::uint64_t bytes_used;
+  DiskUsage max_disk_usage;
+  double get_requests_per_second;
+  double put_requests_per_second;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_STATS_H_
@@ -0,0 +1,71 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_STATUS_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_STATUS_H_
+
+#include <chrono>
+#include <cstdint>
+
+#include "maidsafe/common/identity.h"
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+enum class ProcessStatus : std::int32_t { kBeforeStarted, kStarting, kRunning, kStopping };
+
+// A vault as seen by the VaultManager at the time of a ClientInterface::ListVaults request.
+struct VaultStatus {
+  VaultStatus()
+      : label(), status(ProcessStatus::kBeforeStarted), process_id(0), uptime(0),
+        restart_count(0), max_disk_usage(0), owner_name(), disk_usage(0), disk_usage_growth(0) {}
+
+  template <typename Archive>
+  void load(Archive& archive) {
+    std::int64_t uptime_seconds(0);
+    archive(label, status, process_id, uptime_seconds, restart_count, max_disk_usage, owner_name,
+            disk_usage, disk_usage_growth);
+    uptime = std::chrono::seconds(uptime_seconds);
+  }
+
+  template <typename Archive>
+  void save(Archive& archive) const {
+    archive(label, status, process_id, static_cast<std::int64_t>(uptime.count()), restart_count,
+            max_disk_usage, owner_name, disk_usage, disk_usage_growth);
+  }
+
+  NonEmptyString label;
+  ProcessStatus status;
+  std::uint64_t process_id;  // Zero if the process hasn't been started.
+  std::chrono::seconds uptime;  // Time since the process was started.
+  std::int32_t restart_count;
+  DiskUsage max_disk_usage;
+  Identity owner_name;  // Uninitialised if the vault has no owner.
+  // Size of the files below the vault dir as at the VaultManager's last scan of it (zero if not yet
+  // scanned), and its rate of change in bytes per second between the last two scans.
+  std::uint64_t disk_usage;
+  std::int64_t disk_usage_growth;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_STATUS_H_
@@ -0,0 +1,102 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/admission_control.h"
+
+#include <algorithm>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+AdmissionControl::AdmissionControl(const VaultManagerOptions& options)
+    : kMaxNewConnections_(options.max_new_connections),
+      kMaxUnvalidatedClients_(options.max_unvalidated_clients),
+      kMaxAcceptsPerSecond_(options.max_accepts_per_second),
+      kAcceptBurst_(std::max(options.accept_burst, 1U)),
+      accept_tokens_(static_cast<double>(kAcceptBurst_)),
+      last_refill_(std::chrono::steady_clock::now()),
+      shedding_(false),
+      accepted_(0),
+      rejected_new_connections_(0),
+      rejected_unvalidated_clients_(0),
+      rejected_rate_limited_(0) {}
+
+bool AdmissionControl::AdmitNewConnection(std::size_t new_connection_count) {
+  if (new_connection_count >= kMaxNewConnections_) {
+    ++rejected_new_connections_;
+    LogRejection("too many unidentified connections");
+    return false;
+  }
+  if (!TakeAcceptToken()) {
+    ++rejected_rate_limited_;
+    LogRejection("accept rate limit exceeded");
+    return false;
+  }
+  if (shedding_) {
+    LOG(kInfo) << "Resuming accepting new connections.";
+    shedding_ = false;
+  }
+  ++accepted_;
+  return true;
+}
+
+bool AdmissionControl::AdmitUnvalidatedClient(std::size_t unvalidated_client_count) {
+  if (unvalidated_client_count < kMaxUnvalidatedClients_)
+    return true;
+  ++rejected_unvalidated_clients_;
+  LogRejection("too many unvalidated clients");
+  return false;
+}
+
+AdmissionCounters AdmissionControl::GetCounters() const {
+  AdmissionCounters counters;
+  counters.accepted = accepted_;
+  counters.rejected_new_connections = rejected_new_connections_;
+  counters.rejected_unvalidated_clients = rejected_unvalidated_clients_;
+  counters.rejected_rate_limited = rejected_rate_limited_;
+  return counters;
+}
+
+bool AdmissionControl::TakeAcceptToken() {
+  if (kMaxAcceptsPerSecond_ == 0)
+    return true;
+  const auto now(std::chrono::steady_clock::now());
+  const std::chrono::duration<double> elapsed(now - last_refill_);
+  last_refill_ = now;
+  accept_tokens_ = std::min(static_cast<double>(kAcceptBurst_),
+                            accept_tokens_ + elapsed.count() * kMaxAcceptsPerSecond_);
+  if (accept_tokens_ < 1.0)
+    return false;
+  accept_tokens_ -= 1.0;
+  return true;
+}
+
+void AdmissionControl::LogRejection(const char* reason) {
+  // Only log the transition into shedding, otherwise a misbehaving peer can flood the log too.
+  if (shedding_)
+    return;
+  LOG(kWarning) << "Rejecting new connections: " << reason;
+  shedding_ = true;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,79 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_ADMISSION_CONTROL_H_
+#define MAIDSAFE_VAULT_MANAGER_ADMISSION_CONTROL_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "maidsafe/vault_manager/vault_manager_options.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+struct AdmissionCounters {
+  AdmissionCounters()
+      : accepted(0), rejected_new_connections(0), rejected_unvalidated_clients(0),
+        rejected_rate_limited(0) {}
+  std::uint64_t accepted;
+  std::uint64_t rejected_new_connections;
+  std::uint64_t rejected_unvalidated_clients;
+  std::uint64_t rejected_rate_limited;
+};
+
+// Decides whether the loopback listener should keep an inbound connection.  The Admit functions
+// must be called from a single strand; GetCounters may be called from any thread.
+//
+// tcp::Listener can't be paused, so connections arriving while a cap is exceeded are closed as
+// soon as they're accepted, before any read is started on them.  All peers are on the loopback
+// address and tcp::Connection doesn't expose the peer's credentials, so the rate limit applies to
+// the listener as a whole rather than per peer.
+class AdmissionControl {
+ public:
+  explicit AdmissionControl(const VaultManagerOptions& options);
+
+  bool AdmitNewConnection(std::size_t new_connection_count);
+  bool AdmitUnvalidatedClient(std::size_t unvalidated_client_count);
+  AdmissionCounters GetCounters() const;
+
+ private:
+  AdmissionControl(const AdmissionControl&) = delete;
+  AdmissionControl(AdmissionControl&&) = delete;
+  AdmissionControl& operator=(AdmissionControl) = delete;
+
+  bool TakeAcceptToken();
+  void LogRejection(const char* reason);
+
+  const std::size_t kMaxNewConnections_, kMaxUnvalidatedClients_;
+  const std::uint32_t kMaxAcceptsPerSecond_, kAcceptBurst_;
+  double accept_tokens_;
+  std::chrono::steady_clock::time_point last_refill_;
+  bool shedding_;
+  std::atomic<std::uint64_t> accepted_, rejected_new_connections_, rejected_unvalidated_clients_,
+      rejected_rate_limited_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_ADMISSION_CONTROL_H_
@@ -29,7 +29,7 @@ namespace maidsafe {
 namespace vault_manager {
 
 ClientConnections::ClientConnections(asio::io_service& io_service)
-    : io_service_(io_service), unvalidated_clients_(), clients_() {}
+    : timing_wheel_(TimingWheel::Get(io_service)), unvalidated_clients_(), clients_() {}
 
 std::shared_ptr<ClientConnections> ClientConnections::MakeShared(asio::io_service& io_service) {
   return std::shared_ptr<ClientConnections>{new ClientConnections{io_service}};
@@ -41,13 +41,10 @@ ClientConnections::~ClientConnections() {
 
 void ClientConnections::Add(tcp::ConnectionPtr connection, const asymm::PlainText& challenge) {
   assert(clients_.find(connection) == std::end(clients_));
-  TimerPtr timer{std::make_shared<Timer>(io_service_, kRpcTimeout)};
-  timer->async_wait([=](const std::error_code& error_code) {
-    if (!error_code || error_code != asio::error::operation_aborted) {
-      LOG(kWarning) << "Timed out waiting for Client to validate.";
-      connection->Close();
-    }
-  });
+  TimingWheel::Handle timer{timing_wheel_.Arm(kRpcTimeout, [connection] {
+    LOG(kWarning) << "Timed out waiting for Client to validate.";
+    connection->Close();
+  })};
   bool result{unvalidated_clients_.emplace(connection, std::make_pair(challenge, timer)).second};
   assert(result);
   static_cast<void>(result);
@@ -71,12 +68,21 @@ void ClientConnections::Validate(tcp::ConnectionPtr connection, const passport::
   }
 
   bool result{clients_.emplace(connection, maid.Name()).second};
+  itr->second.second.Cancel();
   unvalidated_clients_.erase(itr);
   cleanup.Release();
   assert(result);
   static_cast<void>(result);
 }
 
+void ClientConnections::AddValidated(tcp::ConnectionPtr connection, const MaidName& maid_name) {
+  assert(unvalidated_clients_.find(connection) == std::end(unvalidated_clients_));
+  bool result{clients_.emplace(connection, maid_name).second};
+  assert(result);
+  static_cast<void>(result);
+  LOG(kSuccess) << "Client " << maid_name << " TCP connection resumed session.";
+}
+
 bool ClientConnections::Remove(tcp::ConnectionPtr connection) {
   auto itr(clients_.find(connection));
   if (itr != std::end(clients_)) {
@@ -86,6 +92,7 @@ bool ClientConnections::Remove(tcp::ConnectionPtr connection) {
 
   auto unvalidated_itr(unvalidated_clients_.find(connection));
   if (unvalidated_itr != std::end(unvalidated_clients_)) {
+    unvalidated_itr->second.second.Cancel();
     unvalidated_clients_.erase(unvalidated_itr);
     return true;
   }
@@ -136,6 +143,8 @@ std::vector<tcp::ConnectionPtr> ClientConnections::GetAll() const {
   return all_connections;
 }
 
+std::size_t ClientConnections::UnvalidatedCount() const { return unvalidated_clients_.size(); }
+
 }  //  namespace vault_manager
 
 }  //  namespace maidsafe
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_CLIENT_CONNECTIONS_H_
 #define MAIDSAFE_VAULT_MANAGER_CLIENT_CONNECTIONS_H_
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <utility>
@@ -31,6 +32,7 @@
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 
 namespace maidsafe {
 
@@ -44,17 +46,20 @@ class ClientConnections {
   void Add(tcp::ConnectionPtr connection, const asymm::PlainText& challenge);
   void Validate(tcp::ConnectionPtr connection, const passport::PublicMaid& maid,
                 const asymm::Signature& signature);
+  // For a client which has resumed a previously-validated session.
+  void AddValidated(tcp::ConnectionPtr connection, const MaidName& maid_name);
   bool Remove(tcp::ConnectionPtr connection);
   void CloseAll();
   MaidName FindValidated(tcp::ConnectionPtr connection) const;
   tcp::ConnectionPtr FindValidated(MaidName maid_name) const;
   std::vector<tcp::ConnectionPtr> GetAll() const;
+  std::size_t UnvalidatedCount() const;
 
  private:
   explicit ClientConnections(asio::io_service& io_service);
 
-  asio::io_service& io_service_;
-  std::map<tcp::ConnectionPtr, std::pair<asymm::PlainText, TimerPtr>,
+  TimingWheel& timing_wheel_;
+  std::map<tcp::ConnectionPtr, std::pair<asymm::PlainText, TimingWheel::Handle>,
            std::owner_less<tcp::ConnectionPtr>> unvalidated_clients_;
   std::map<tcp::ConnectionPtr, MaidName, std::owner_less<tcp::ConnectionPtr>> clients_;
 };
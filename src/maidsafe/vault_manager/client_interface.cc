@@ -18,65 +18,159 @@
 
 #include "maidsafe/vault_manager/client_interface.h"
 
+#include <algorithm>
+#include <cstddef>
+
 #include "maidsafe/common/make_unique.h"
+#include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/tcp/connection.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/discovery_file.h"
+#include "maidsafe/vault_manager/handler_guard.h"
 #include "maidsafe/vault_manager/rpc_helper.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 #include "maidsafe/vault_manager/utils.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/host_stats_request.h"
+#include "maidsafe/vault_manager/messages/host_stats_response.h"
+#include "maidsafe/vault_manager/messages/list_vaults_request.h"
+#include "maidsafe/vault_manager/messages/list_vaults_response.h"
 #include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/network_stable_request.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/resume_session_response.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
 #include "maidsafe/vault_manager/messages/set_network_as_stable.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
+#include "maidsafe/vault_manager/messages/start_vaults_request.h"
+#include "maidsafe/vault_manager/messages/subscribe_to_vault_events_request.h"
+#include "maidsafe/vault_manager/messages/tail_vault_output_request.h"
+#include "maidsafe/vault_manager/messages/tail_vault_output_response.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/unsubscribe_from_vault_events_request.h"
 #include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_event_notification.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
+#include "maidsafe/vault_manager/messages/vault_spawned.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
 ClientInterface::ClientInterface(const passport::Maid& maid)
+    : ClientInterface(maid, nullptr, Unvalidated()) {
+  std::promise<void> validated;
+  RequestValidation([&validated](maidsafe_error error) {
+    if (error.code() == make_error_code(CommonErrors::success))
+      validated.set_value();
+    else
+      validated.set_exception(std::make_exception_ptr(error));
+  });
+  validated.get_future().get();
+}
+
+ClientInterface::ClientInterface(const passport::Maid& maid, asio::io_service& io_service)
+    : ClientInterface(maid, &io_service, Unvalidated()) {
+  std::promise<void> validated;
+  RequestValidation([&validated](maidsafe_error error) {
+    if (error.code() == make_error_code(CommonErrors::success))
+      validated.set_value();
+    else
+      validated.set_exception(std::make_exception_ptr(error));
+  });
+  validated.get_future().get();
+}
+
+ClientInterface::ClientInterface(const passport::Maid& maid, asio::io_service* io_service,
+                                 Unvalidated)
     : kMaid_(maid),
       mutex_(),
       on_challenge_(),
       network_stable_(),
       network_stable_flag_(),
-      asio_service_(1),
-      strand_(asio_service_.service()),
+      ongoing_vault_requests_(),
+      next_status_request_id_(0),
+      ongoing_status_requests_(),
+      ongoing_stats_requests_(),
+      ongoing_output_requests_(),
+      on_vault_event_(),
+      vault_event_guard_(),
+      last_vault_event_sequence_number_(0),
+      on_resume_session_response_(),
+      session_ticket_(),
+      unanswered_requests_(),
+      unanswered_identified_requests_(),
+      validated_(false),
+      stopping_(false),
+      reconnect_attempt_(0),
+      asio_service_(io_service ? nullptr : maidsafe::make_unique<AsioService>(1)),
+      io_service_(io_service ? *io_service : asio_service_->service()),
+      strand_(io_service_),
+      handler_guard_(std::make_shared<HandlerGuard>()),
       tcp_connection_(ConnectToVaultManager()),
-      connection_closer_([&] { tcp_connection_->Close(); }) {
-  Send(tcp_connection_, ValidateConnectionRequest());
-  auto challenge = SetResponseCallback<std::unique_ptr<asymm::PlainText>, Challenge>(
-                       on_challenge_, asio_service_.service(), mutex_).get();
-  Send(tcp_connection_, ChallengeResponse(passport::PublicMaid(kMaid_),
-                                          asymm::Sign(*challenge, kMaid_.private_key())));
-}
+      connection_closer_([&] { CloseAndDrain(tcp_connection_, strand_, *handler_guard_); }) {}
 
 ClientInterface::~ClientInterface() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
 // Ensure promise is set if required.
 #ifdef TESTING
   HandleNetworkStableResponse();
 #endif
 }
 
+std::unique_ptr<ClientInterface> ClientInterface::Connect(const passport::Maid& maid,
+                                                          ValidatedHandler on_validated) {
+  std::unique_ptr<ClientInterface> client_interface{
+      new ClientInterface{maid, nullptr, Unvalidated()}};
+  client_interface->RequestValidation(std::move(on_validated));
+  return client_interface;
+}
+
+std::unique_ptr<ClientInterface> ClientInterface::Connect(const passport::Maid& maid,
+                                                          asio::io_service& io_service,
+                                                          ValidatedHandler on_validated) {
+  std::unique_ptr<ClientInterface> client_interface{
+      new ClientInterface{maid, &io_service, Unvalidated()}};
+  client_interface->RequestValidation(std::move(on_validated));
+  return client_interface;
+}
+
 std::shared_ptr<tcp::Connection> ClientInterface::ConnectToVaultManager() {
+  auto connect([this](tcp::Port port) {
+    tcp::ConnectionPtr tcp_connection{tcp::Connection::MakeShared(strand_, port)};
+    tcp_connection->Start(
+        Guard(handler_guard_,
+              [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); }),
+        Guard(handler_guard_, [this] { OnConnectionClosed(); }));
+    LOG(kSuccess) << "Connected to VaultManager which is listening on port " << port;
+    return tcp_connection;
+  });
+
+  // Try the port published by a running VaultManager first, to avoid probing.
+  auto discovery_info(ReadDiscoveryFile(GetDiscoveryFilePath()));
+  if (discovery_info) {
+    try {
+      return connect(discovery_info->port);
+    } catch (const std::exception&) {
+      LOG(kInfo) << "Failed to connect to VaultManager on discovered port " << discovery_info->port
+                 << ".  Falling back to probing.";
+    }
+  }
+
   unsigned attempts{0};
   tcp::Port initial_port{GetInitialListeningPort()};
   tcp::Port port{initial_port};
   while (attempts <= tcp::kMaxRangeAboveDefaultPort &&
          port <= std::numeric_limits<tcp::Port>::max()) {
     try {
-      tcp::ConnectionPtr tcp_connection{tcp::Connection::MakeShared(strand_, port)};
-      tcp_connection->Start(
-          [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
-          [this] {});  // FIXME OnConnectionClosed
-      LOG(kSuccess) << "Connected to VaultManager which is listening on port " << port;
-      return tcp_connection;
+      return connect(port);
     } catch (const std::exception&) {
       ++attempts;
       ++port;
@@ -87,51 +181,422 @@ std::shared_ptr<tcp::Connection> ClientInterface::ConnectToVaultManager() {
   BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::failed_to_connect));
 }
 
+void ClientInterface::RequestValidation(ValidatedHandler on_validated) {
+  SetResponseCallback<std::unique_ptr<asymm::PlainText>, Challenge>(
+      on_challenge_, io_service_, mutex_,
+      [this, on_validated](maidsafe_error error, std::unique_ptr<asymm::PlainText> challenge) {
+        if (challenge) {
+          try {
+            Send(GetConnection(), ChallengeResponse(passport::PublicMaid(kMaid_),
+                                                    asymm::Sign(*challenge, kMaid_.private_key())));
+            OnSessionEstablished();
+          } catch (const maidsafe_error& e) {
+            error = e;
+          } catch (const std::exception&) {
+            error = MakeError(CommonErrors::unknown);
+          }
+        }
+        if (on_validated)
+          on_validated(std::move(error));
+      },
+      handler_guard_);
+  Send(GetConnection(), ValidateConnectionRequest(kProtocolVersion));
+}
+
+void ClientInterface::RequestResumption(crypto::CipherText ticket) {
+  SetResponseCallback<std::unique_ptr<crypto::CipherText>, ResumeSessionResponse>(
+      on_resume_session_response_, io_service_, mutex_,
+      [this](maidsafe_error error, std::unique_ptr<crypto::CipherText> new_ticket) {
+        if (new_ticket) {
+          {
+            std::lock_guard<std::mutex> lock{mutex_};
+            session_ticket_ = std::move(new_ticket);
+          }
+          LOG(kSuccess) << "Resumed session with VaultManager.";
+          return OnSessionEstablished();
+        }
+        LOG(kInfo) << "Failed to resume session: " << error.what() << "  Requesting validation.";
+        {
+          std::lock_guard<std::mutex> lock{mutex_};
+          session_ticket_.reset();
+        }
+        Revalidate();
+      },
+      handler_guard_);
+  Send(GetConnection(), ResumeSessionRequest(kProtocolVersion, std::move(ticket)));
+}
+
+void ClientInterface::Revalidate() {
+  RequestValidation([this](maidsafe_error error) {
+    if (error.code() != make_error_code(CommonErrors::success)) {
+      LOG(kError) << "Failed to revalidate with VaultManager: " << error.what();
+      GetConnection()->Close();  // Triggers another reconnect.
+    }
+  });
+}
+
+void ClientInterface::OnSessionEstablished() {
+  tcp::ConnectionPtr connection;
+  std::vector<std::shared_ptr<tcp::Message>> requests;
+  bool subscribed{false};
+  std::uint64_t last_vault_event_sequence_number{0};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    validated_ = true;
+    reconnect_attempt_ = 0;
+    connection = tcp_connection_;
+    subscribed = static_cast<bool>(on_vault_event_);
+    last_vault_event_sequence_number = last_vault_event_sequence_number_;
+    // A batch request appears once per label, but only needs to be sent once.
+    for (const auto& unanswered_request : unanswered_requests_) {
+      if (std::find(std::begin(requests), std::end(requests), unanswered_request.second) ==
+          std::end(requests)) {
+        requests.push_back(unanswered_request.second);
+      }
+    }
+    for (const auto& unanswered_request : unanswered_identified_requests_)
+      requests.push_back(unanswered_request.second);
+  }
+  if (!requests.empty())
+    LOG(kInfo) << "Sending " << requests.size() << " request(s) awaiting a response.";
+  for (const auto& request : requests)
+    connection->Send(*request);
+  if (subscribed)
+    Send(connection, SubscribeToVaultEventsRequest(last_vault_event_sequence_number));
+}
+
+void ClientInterface::OnConnectionClosed() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    validated_ = false;
+    if (stopping_)
+      return;
+  }
+  LOG(kWarning) << "Lost connection to VaultManager.";
+  ScheduleReconnect();
+}
+
+void ClientInterface::ScheduleReconnect() {
+  std::chrono::milliseconds delay{0};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    delay = ReconnectDelay(reconnect_attempt_++);
+  }
+  LOG(kInfo) << "Reconnecting to VaultManager in " << delay.count() << "ms.";
+  TimingWheel::Get(io_service_).Arm(delay, Guard(handler_guard_, [this] {
+    strand_.post(Guard(handler_guard_, [this] { Reconnect(); }));
+  }));
+}
+
+void ClientInterface::Reconnect() {
+  tcp::ConnectionPtr connection;
+  try {
+    connection = ConnectToVaultManager();
+  } catch (const std::exception&) {
+    return ScheduleReconnect();
+  }
+
+  std::unique_ptr<crypto::CipherText> ticket;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (stopping_)
+      return connection->Close();
+    tcp_connection_ = connection;
+    if (session_ticket_)
+      ticket = maidsafe::make_unique<crypto::CipherText>(*session_ticket_);
+  }
+  if (ticket)
+    RequestResumption(std::move(*ticket));
+  else
+    Revalidate();
+}
+
+tcp::ConnectionPtr ClientInterface::GetConnection() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return tcp_connection_;
+}
+
+template <typename Request>
+void ClientInterface::SendRequest(const std::vector<NonEmptyString>& labels, Request request) {
+  auto message(std::make_shared<tcp::Message>(Serialise(Request::tag, std::move(request))));
+  tcp::ConnectionPtr connection;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (const auto& label : labels) {
+      if (ongoing_vault_requests_.count(label) != 0)
+        unanswered_requests_[label] = message;
+    }
+    if (validated_)
+      connection = tcp_connection_;
+  }
+  if (connection)
+    connection->Send(*message);
+}
+
+template <typename ResultType, typename MakeRequest>
+void ClientInterface::SendIdentifiedRequest(
+    std::map<std::uint32_t, std::shared_ptr<detail::HandlerAndTimer<ResultType>>>& ongoing_requests,
+    typename detail::HandlerAndTimer<ResultType>::Handler handler, MakeRequest make_request) {
+  auto request(
+      std::make_shared<detail::HandlerAndTimer<ResultType>>(io_service_, std::move(handler)));
+  std::shared_ptr<tcp::Message> message;
+  tcp::ConnectionPtr connection;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    const std::uint32_t request_id{next_status_request_id_++};
+    auto identified_request(make_request(request_id));
+    message = std::make_shared<tcp::Message>(
+        Serialise(decltype(identified_request)::tag, std::move(identified_request)));
+    request->ArmTimer(Guard(handler_guard_, [request, request_id, &ongoing_requests, this] {
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        ongoing_requests.erase(request_id);
+        unanswered_identified_requests_.erase(request_id);
+      }
+      request->SetError(MakeError(VaultManagerErrors::timed_out));
+    }));
+    ongoing_requests.insert(std::make_pair(request_id, request));
+    unanswered_identified_requests_.insert(std::make_pair(request_id, message));
+    if (validated_)
+      connection = tcp_connection_;
+  }
+  if (connection)
+    connection->Send(*message);
+}
+
+template <typename ResultType>
+std::shared_ptr<detail::HandlerAndTimer<ResultType>> ClientInterface::TakeIdentifiedRequest(
+    std::map<std::uint32_t, std::shared_ptr<detail::HandlerAndTimer<ResultType>>>& ongoing_requests,
+    std::uint32_t request_id) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(ongoing_requests.find(request_id));
+  if (itr == std::end(ongoing_requests))
+    return nullptr;
+  auto request(itr->second);
+  ongoing_requests.erase(itr);
+  unanswered_identified_requests_.erase(request_id);
+  return request;
+}
+
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::TakeOwnership(
     const NonEmptyString& label, const boost::filesystem::path& vault_dir,
     DiskUsage max_disk_usage) {
-  Send(tcp_connection_, TakeOwnershipRequest(label, vault_dir, max_disk_usage));
-  return AddVaultRequest(label);
+  auto promise(std::make_shared<std::promise<std::unique_ptr<passport::PmidAndSigner>>>());
+  AsyncTakeOwnership(label, vault_dir, max_disk_usage, detail::MakePromiseHandler(promise));
+  return promise->get_future();
+}
+
+void ClientInterface::AsyncTakeOwnership(const NonEmptyString& label,
+                                         const boost::filesystem::path& vault_dir,
+                                         DiskUsage max_disk_usage, VaultResultHandler handler) {
+  AddVaultRequest(label, std::move(handler));
+  SendRequest({label}, TakeOwnershipRequest(label, vault_dir, max_disk_usage));
 }
 
 #ifdef USE_VLOGGING
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
     const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
     const std::string& vlog_session_id) {
+  auto promise(std::make_shared<std::promise<std::unique_ptr<passport::PmidAndSigner>>>());
+  AsyncStartVault(vault_dir, max_disk_usage, vlog_session_id, detail::MakePromiseHandler(promise));
+  return promise->get_future();
+}
+
+void ClientInterface::AsyncStartVault(const boost::filesystem::path& vault_dir,
+                                      DiskUsage max_disk_usage,
+                                      const std::string& vlog_session_id,
+                                      VaultResultHandler handler) {
   NonEmptyString label{GenerateLabel()};
   StartVaultRequest start_vault_request(label, vault_dir, max_disk_usage);
   start_vault_request.vlog_session_id = vlog_session_id;
-  Send(tcp_connection_, std::move(start_vault_request));
-  return AddVaultRequest(label);
+  AddVaultRequest(label, std::move(handler), kVaultSpawnTimeout);
+  SendRequest({label}, std::move(start_vault_request));
 }
 #else
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
     const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage) {
+  auto promise(std::make_shared<std::promise<std::unique_ptr<passport::PmidAndSigner>>>());
+  AsyncStartVault(vault_dir, max_disk_usage, detail::MakePromiseHandler(promise));
+  return promise->get_future();
+}
+
+void ClientInterface::AsyncStartVault(const boost::filesystem::path& vault_dir,
+                                      DiskUsage max_disk_usage, VaultResultHandler handler) {
   NonEmptyString label{GenerateLabel()};
-  Send(tcp_connection_, StartVaultRequest(label, vault_dir, max_disk_usage));
-  return AddVaultRequest(label);
+  AddVaultRequest(label, std::move(handler), kVaultSpawnTimeout);
+  SendRequest({label}, StartVaultRequest(label, vault_dir, max_disk_usage));
 }
 #endif
 
-std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::AddVaultRequest(
-    const NonEmptyString& label) {
-  std::shared_ptr<VaultRequest> request(
-      std::make_shared<VaultRequest>(asio_service_.service(), std::chrono::seconds(30)));
-  request->timer.async_wait([request, label, this](const std::error_code& ec) {
-    if (ec && ec == asio::error::operation_aborted)
-      return;
-    LOG(kWarning) << "Timer expired - i.e. timed out for label: " << label;
-    std::lock_guard<std::mutex> lock{mutex_};
-    if (ec)
-      request->SetException(ec);
+std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> ClientInterface::StartVaults(
+    const std::vector<VaultSpec>& vault_specs, int max_concurrent_starts) {
+  typedef std::promise<std::unique_ptr<passport::PmidAndSigner>> Promise;
+  auto promises(std::make_shared<std::vector<Promise>>(vault_specs.size()));
+  std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> results;
+  for (auto& promise : *promises)
+    results.emplace_back(promise.get_future());
+  AsyncStartVaults(vault_specs, max_concurrent_starts,
+                   [promises](std::size_t index, maidsafe_error error,
+                              std::unique_ptr<passport::PmidAndSigner> pmid_and_signer) {
+    if (error.code() == make_error_code(CommonErrors::success))
+      (*promises)[index].set_value(std::move(pmid_and_signer));
     else
-      request->SetException(MakeError(VaultManagerErrors::timed_out));
-    ongoing_vault_requests_.erase(label);
+      (*promises)[index].set_exception(std::make_exception_ptr(error));
+  });
+  return results;
+}
+
+void ClientInterface::AsyncStartVaults(const std::vector<VaultSpec>& vault_specs,
+                                       int max_concurrent_starts,
+                                       BatchVaultResultHandler handler) {
+  // The VaultManager generates the vaults' keys and may queue them behind other vaults, so how long
+  // each waits to be spawned depends on the VaultManager's load.  Each deadline is brought forward
+  // to kVaultStartTimeout once the vault is spawned.
+  auto shared_handler(std::make_shared<BatchVaultResultHandler>(std::move(handler)));
+  std::vector<StartVaultRequest> start_vault_requests;
+  std::vector<NonEmptyString> labels;
+  for (std::size_t i(0); i < vault_specs.size(); ++i) {
+    start_vault_requests.emplace_back(GenerateLabel(), vault_specs[i].vault_dir,
+                                      vault_specs[i].max_disk_usage);
+#ifdef USE_VLOGGING
+    start_vault_requests.back().vlog_session_id = vault_specs[i].vlog_session_id;
+#endif
+#ifdef TESTING
+    start_vault_requests.back().pmid_list_index = vault_specs[i].pmid_list_index;
+#endif
+    labels.push_back(start_vault_requests.back().vault_label);
+    AddVaultRequest(start_vault_requests.back().vault_label,
+                    [shared_handler, i](maidsafe_error error,
+                                        std::unique_ptr<passport::PmidAndSigner> pmid_and_signer) {
+                      if (*shared_handler)
+                        (*shared_handler)(i, std::move(error), std::move(pmid_and_signer));
+                    },
+                    kVaultSpawnTimeout);
+  }
+  SendRequest(labels, StartVaultsRequest(std::move(start_vault_requests),
+                                         static_cast<std::int32_t>(max_concurrent_starts)));
+}
+
+void ClientInterface::AsyncListVaults(VaultStatusesHandler handler) {
+  SendListVaultsRequest(boost::none, std::move(handler));
+}
+
+void ClientInterface::AsyncGetVaultStatus(const NonEmptyString& label,
+                                          VaultStatusHandler handler) {
+  SendListVaultsRequest(label, [handler](maidsafe_error error, std::vector<VaultStatus> statuses) {
+    if (!handler)
+      return;
+    if (error.code() != make_error_code(CommonErrors::success))
+      return handler(std::move(error), VaultStatus());
+    if (statuses.empty())
+      return handler(MakeError(CommonErrors::no_such_element), VaultStatus());
+    handler(std::move(error), std::move(statuses.front()));
   });
+}
+
+std::future<std::vector<VaultStatus>> ClientInterface::ListVaults() {
+  auto promise(std::make_shared<std::promise<std::vector<VaultStatus>>>());
+  AsyncListVaults(detail::MakePromiseHandler(promise));
+  return promise->get_future();
+}
+
+std::future<VaultStatus> ClientInterface::GetVaultStatus(const NonEmptyString& label) {
+  auto promise(std::make_shared<std::promise<VaultStatus>>());
+  AsyncGetVaultStatus(label, detail::MakePromiseHandler(promise));
+  return promise->get_future();
+}
+
+void ClientInterface::SendListVaultsRequest(boost::optional<NonEmptyString> vault_label,
+                                            VaultStatusesHandler handler) {
+  SendIdentifiedRequest(ongoing_status_requests_, std::move(handler),
+                        [&vault_label](std::uint32_t request_id) {
+                          return ListVaultsRequest(request_id, std::move(vault_label));
+                        });
+}
+
+void ClientInterface::AsyncGetHostStats(HostStatsHandler handler) {
+  SendIdentifiedRequest(ongoing_stats_requests_, std::move(handler),
+                        [](std::uint32_t request_id) { return HostStatsRequest(request_id); });
+}
+
+std::future<HostStats> ClientInterface::GetHostStats() {
+  auto promise(std::make_shared<std::promise<HostStats>>());
+  AsyncGetHostStats(detail::MakePromiseHandler(promise));
+  return promise->get_future();
+}
+
+void ClientInterface::AsyncTailVaultOutput(const NonEmptyString& label, std::uint64_t cursor,
+                                           VaultOutputHandler handler) {
+  SendIdentifiedRequest(ongoing_output_requests_, std::move(handler),
+                        [&label, cursor](std::uint32_t request_id) {
+                          return TailVaultOutputRequest(request_id, label, cursor);
+                        });
+}
+
+std::future<VaultOutput> ClientInterface::TailVaultOutput(const NonEmptyString& label,
+                                                          std::uint64_t cursor) {
+  auto promise(std::make_shared<std::promise<VaultOutput>>());
+  AsyncTailVaultOutput(label, cursor, detail::MakePromiseHandler(promise));
+  return promise->get_future();
+}
+
+void ClientInterface::SubscribeToVaultEvents(VaultEventHandler handler,
+                                             std::uint64_t after_sequence_number) {
+  std::shared_ptr<HandlerGuard> previous_guard;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_vault_event_ = std::move(handler);
+    previous_guard = std::move(vault_event_guard_);
+    vault_event_guard_ = std::make_shared<HandlerGuard>();
+    last_vault_event_sequence_number_ = after_sequence_number;
+  }
+  CloseVaultEventGuard(previous_guard);
+  Send(GetConnection(), SubscribeToVaultEventsRequest(after_sequence_number));
+}
+
+void ClientInterface::UnsubscribeFromVaultEvents() {
+  std::shared_ptr<HandlerGuard> guard;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_vault_event_ = nullptr;
+    guard = std::move(vault_event_guard_);
+  }
+  CloseVaultEventGuard(guard);
+  Send(GetConnection(), UnsubscribeFromVaultEventsRequest());
+}
+
+void ClientInterface::CloseVaultEventGuard(const std::shared_ptr<HandlerGuard>& guard) {
+  // The handler is only invoked on the strand, so if we're running there it can only be executing
+  // further up this thread's stack, and waiting for it to return would deadlock.
+  if (guard && !strand_.running_in_this_thread())
+    guard->Close();
+}
+
+std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::AddVaultRequest(
+    const NonEmptyString& label, std::chrono::steady_clock::duration timeout) {
+  auto promise(std::make_shared<std::promise<std::unique_ptr<passport::PmidAndSigner>>>());
+  AddVaultRequest(label, detail::MakePromiseHandler(promise), timeout);
+  return promise->get_future();
+}
 
+void ClientInterface::AddVaultRequest(const NonEmptyString& label, VaultResultHandler handler,
+                                      std::chrono::steady_clock::duration timeout) {
+  std::shared_ptr<VaultRequest> request(
+      std::make_shared<VaultRequest>(io_service_, std::move(handler), timeout));
   std::lock_guard<std::mutex> lock{mutex_};
+  request->ArmTimer(Guard(handler_guard_, [request, label, this] {
+    LOG(kWarning) << "Timer expired - i.e. timed out for label: " << label;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      auto itr(ongoing_vault_requests_.find(label));
+      if (itr != std::end(ongoing_vault_requests_) && itr->second == request) {
+        ongoing_vault_requests_.erase(itr);
+        unanswered_requests_.erase(label);
+      }
+    }
+    request->SetError(MakeError(VaultManagerErrors::timed_out));
+  }));
   ongoing_vault_requests_.insert(std::make_pair(label, request));
-  return request->promise.get_future();
 }
 
 void ClientInterface::HandleReceivedMessage(tcp::Message&& message) {
@@ -146,6 +611,27 @@ void ClientInterface::HandleReceivedMessage(tcp::Message&& message) {
       case MessageTag::kVaultRunningResponse:
         HandleVaultRunningResponse(Parse<VaultRunningResponse>(binary_input_stream));
         break;
+      case MessageTag::kVaultSpawned:
+        HandleVaultSpawned(Parse<VaultSpawned>(binary_input_stream));
+        break;
+      case MessageTag::kListVaultsResponse:
+        HandleListVaultsResponse(Parse<ListVaultsResponse>(binary_input_stream));
+        break;
+      case MessageTag::kHostStatsResponse:
+        HandleHostStatsResponse(Parse<HostStatsResponse>(binary_input_stream));
+        break;
+      case MessageTag::kTailVaultOutputResponse:
+        HandleTailVaultOutputResponse(Parse<TailVaultOutputResponse>(binary_input_stream));
+        break;
+      case MessageTag::kVaultEventNotification:
+        HandleVaultEventNotification(Parse<VaultEventNotification>(binary_input_stream));
+        break;
+      case MessageTag::kSessionTicket:
+        HandleSessionTicket(Parse<SessionTicket>(binary_input_stream));
+        break;
+      case MessageTag::kResumeSessionResponse:
+        HandleResumeSessionResponse(Parse<ResumeSessionResponse>(binary_input_stream));
+        break;
 #ifdef TESTING
       case MessageTag::kNetworkStableResponse:
         HandleNetworkStableResponse();
@@ -176,19 +662,120 @@ void ClientInterface::HandleVaultRunningResponse(VaultRunningResponse&& vault_ru
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
   }
 
+  std::shared_ptr<VaultRequest> request;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr = ongoing_vault_requests_.find(label);
+    if (ongoing_vault_requests_.end() == itr) {
+      LOG(kWarning) << "No pending requests in map";
+      return;
+    }
+    request = itr->second;
+    ongoing_vault_requests_.erase(itr);
+    unanswered_requests_.erase(label);
+  }
+
+  // Handlers are invoked outside the lock so that they may make further requests.
+  request->timer.Cancel();
+  if (pmid_and_signer)
+    request->SetValue(std::move(pmid_and_signer));
+  else
+    request->SetError(*error);
+}
+
+void ClientInterface::HandleVaultSpawned(VaultSpawned&& vault_spawned) {
   std::lock_guard<std::mutex> lock{mutex_};
-  auto itr = ongoing_vault_requests_.find(label);
-  if (ongoing_vault_requests_.end() != itr) {
-    if (pmid_and_signer)
-      itr->second->SetValue(std::move(pmid_and_signer));
-    else
-      itr->second->SetException(*error);
+  auto itr(ongoing_vault_requests_.find(vault_spawned.vault_label));
+  if (itr != std::end(ongoing_vault_requests_))
+    itr->second->RearmTimer(kVaultStartTimeout);
+}
 
-    itr->second->timer.cancel();
-    ongoing_vault_requests_.erase(itr);
-  } else {
-    LOG(kWarning) << "No pending requests in map";
+void ClientInterface::HandleListVaultsResponse(ListVaultsResponse&& list_vaults_response) {
+  auto request(TakeIdentifiedRequest(ongoing_status_requests_, list_vaults_response.request_id));
+  if (!request) {
+    LOG(kWarning) << "No pending ListVaults request with ID " << list_vaults_response.request_id;
+    return;
+  }
+
+  request->timer.Cancel();
+  if (list_vaults_response.error)
+    request->SetError(*list_vaults_response.error);
+  else
+    request->SetValue(std::move(list_vaults_response.vaults));
+}
+
+void ClientInterface::HandleHostStatsResponse(HostStatsResponse&& host_stats_response) {
+  auto request(TakeIdentifiedRequest(ongoing_stats_requests_, host_stats_response.request_id));
+  if (!request) {
+    LOG(kWarning) << "No pending HostStats request with ID " << host_stats_response.request_id;
+    return;
+  }
+
+  request->timer.Cancel();
+  if (host_stats_response.error)
+    request->SetError(*host_stats_response.error);
+  else
+    request->SetValue(std::move(host_stats_response.host_stats));
+}
+
+void ClientInterface::HandleTailVaultOutputResponse(
+    TailVaultOutputResponse&& tail_vault_output_response) {
+  auto request(
+      TakeIdentifiedRequest(ongoing_output_requests_, tail_vault_output_response.request_id));
+  if (!request) {
+    LOG(kWarning) << "No pending TailVaultOutput request with ID "
+                  << tail_vault_output_response.request_id;
+    return;
   }
+
+  request->timer.Cancel();
+  if (tail_vault_output_response.error)
+    request->SetError(*tail_vault_output_response.error);
+  else
+    request->SetValue(std::move(tail_vault_output_response.output));
+}
+
+void ClientInterface::HandleVaultEventNotification(
+    VaultEventNotification&& vault_event_notification) {
+  VaultEventHandler on_vault_event;
+  std::shared_ptr<HandlerGuard> guard;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    // Events already seen can be replayed after a resubscription.
+    if (!on_vault_event_ ||
+        vault_event_notification.event.sequence_number <= last_vault_event_sequence_number_) {
+      return;
+    }
+    last_vault_event_sequence_number_ = vault_event_notification.event.sequence_number;
+    on_vault_event = on_vault_event_;
+    guard = vault_event_guard_;
+  }
+  if (!guard->Enter())
+    return;
+  on_scope_exit leave{[&guard] { guard->Leave(); }};
+  try {
+    on_vault_event(vault_event_notification.event);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Error executing vault event handler: " << boost::diagnostic_information(e);
+  }
+}
+
+void ClientInterface::HandleSessionTicket(SessionTicket&& session_ticket) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  session_ticket_ = maidsafe::make_unique<crypto::CipherText>(std::move(session_ticket.ticket));
+}
+
+void ClientInterface::HandleResumeSessionResponse(ResumeSessionResponse&& resume_session_response) {
+  // Take the callback so that handlers don't accumulate across repeated reconnects.
+  std::function<void(ResumeSessionResponse&&)> callback;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    callback.swap(on_resume_session_response_);
+  }
+  if (callback)
+    callback(std::move(resume_session_response));
+  else
+    LOG(kWarning) << "Call back not available";
 }
 
 #ifdef TESTING
@@ -211,8 +798,10 @@ void ClientInterface::HandleLogMessage(LogMessage&& log_message) { LOG(kInfo) <<
 void ClientInterface::SetTestEnvironment(tcp::Port test_vault_manager_port,
                                          boost::filesystem::path test_env_root_dir,
                                          boost::filesystem::path path_to_vault,
-                                         int pmid_list_size) {
-  test::SetEnvironment(test_vault_manager_port, test_env_root_dir, path_to_vault, pmid_list_size);
+                                         int pmid_list_size,
+                                         boost::filesystem::path key_chain_path) {
+  test::SetEnvironment(test_vault_manager_port, test_env_root_dir, path_to_vault, pmid_list_size,
+                       key_chain_path);
 }
 
 #ifdef USE_VLOGGING
@@ -223,8 +812,9 @@ std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVaul
   StartVaultRequest start_vault_request(label, vault_dir, max_disk_usage);
   start_vault_request.vlog_session_id = vlog_session_id;
   start_vault_request.send_hostname_to_visualiser_server = send_hostname_to_visualiser_server;
-  Send(tcp_connection_, std::move(start_vault_request));
-  return AddVaultRequest(label);
+  auto future(AddVaultRequest(label, kVaultSpawnTimeout));
+  SendRequest({label}, std::move(start_vault_request));
+  return future;
 }
 
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
@@ -236,8 +826,9 @@ std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVaul
   start_vault_request.vlog_session_id = vlog_session_id;
   start_vault_request.send_hostname_to_visualiser_server = send_hostname_to_visualiser_server;
   start_vault_request.pmid_list_index = pmid_list_index;
-  Send(tcp_connection_, std::move(start_vault_request));
-  return AddVaultRequest(label);
+  auto future(AddVaultRequest(label, kVaultSpawnTimeout));
+  SendRequest({label}, std::move(start_vault_request));
+  return future;
 }
 #else
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
@@ -245,15 +836,16 @@ std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVaul
   NonEmptyString label{GenerateLabel()};
   StartVaultRequest start_vault_request(label, vault_dir, max_disk_usage);
   start_vault_request.pmid_list_index = pmid_list_index;
-  Send(tcp_connection_, std::move(start_vault_request));
-  return AddVaultRequest(label);
+  auto future(AddVaultRequest(label, kVaultSpawnTimeout));
+  SendRequest({label}, std::move(start_vault_request));
+  return future;
 }
 #endif
 
-void ClientInterface::MarkNetworkAsStable() { Send(tcp_connection_, SetNetworkAsStable()); }
+void ClientInterface::MarkNetworkAsStable() { Send(GetConnection(), SetNetworkAsStable()); }
 
 std::future<void> ClientInterface::WaitForStableNetwork() {
-  Send(tcp_connection_, NetworkStableRequest());
+  Send(GetConnection(), NetworkStableRequest());
   return network_stable_.get_future();
 }
 #endif
@@ -24,10 +24,49 @@ namespace vault_manager {
 
 const std::string kConfigFilename("vault_manager_config.dat");
 const std::string kBootstrapFilename("bootstrap.dat");
+const std::string kDiscoveryFilename("vault_manager_discovery.dat");
+const std::string kReservationFilename(".reservation");
+const std::uint32_t kProtocolVersion(4);
+const std::uint32_t kConfigFileVersion(2);
 
 const std::chrono::seconds kRpcTimeout(2);
 const std::chrono::seconds kVaultStopTimeout(10);
 const int kMaxVaultRestarts(5);
+const std::chrono::milliseconds kTimingWheelResolution(10);
+const std::size_t kMaxNewConnections(64);
+const std::size_t kMaxUnvalidatedClients(32);
+const std::uint32_t kMaxAcceptsPerSecond(50);
+const std::uint32_t kAcceptBurst(100);
+const int kMaxConcurrentVaultStarts(8);
+const std::chrono::minutes kVaultSpawnTimeout(10);
+const std::chrono::seconds kVaultStartTimeout(30);
+const std::chrono::hours kSessionTicketLifetime(24);
+const std::chrono::milliseconds kInitialReconnectDelay(100);
+const std::chrono::seconds kMaxReconnectDelay(10);
+const std::size_t kVaultEventHistorySize(1024);
+const std::chrono::milliseconds kHeartbeatInterval(5000);
+const int kHeartbeatMissThreshold(3);
+const std::chrono::seconds kVaultStatsInterval(10);
+const std::size_t kVaultStatsHistorySize(60);
+const std::chrono::seconds kDiskBudgetInterval(60);
+const double kDiskBudgetFraction(0.9);
+const double kDiskBudgetTolerance(0.05);
+const std::chrono::seconds kDiskUsageScanInterval(60);
+const std::uint64_t kReservationGranularity(64 * 1024 * 1024);
+const std::uint64_t kVaultLogBudget(100 * 1024 * 1024);
+const std::uint64_t kMaxVaultLogFileSize(10 * 1024 * 1024);
+const std::chrono::hours kMaxVaultLogFileAge(24);
+const std::chrono::minutes kLogRotationInterval(5);
+const std::size_t kVaultOutputBufferSize(256 * 1024);
+const std::size_t kMaxVaultOutputChunkSize(64 * 1024);
+const std::size_t kPersistedVaultOutputSize(64 * 1024);
+const std::uint64_t kChunkstoreMoveBytesPerSecond(32 * 1024 * 1024);
+const std::chrono::minutes kUpgradeWaveTimeout(5);
+const std::chrono::seconds kVaultReconnectTimeout(120);
+const std::chrono::seconds kVaultAdoptTimeout(30);
+const std::chrono::seconds kVaultDrainTimeout(30);
+const std::chrono::seconds kVaultTerminateTimeout(5);
+const std::chrono::milliseconds kVaultExitPollInterval(100);
 
 }  // namespace vault_manager
 
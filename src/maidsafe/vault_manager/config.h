@@ -20,6 +20,7 @@
 #define MAIDSAFE_VAULT_MANAGER_CONFIG_H_
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -39,16 +40,67 @@ typedef std::shared_ptr<Timer> TimerPtr;
 
 extern const std::string kConfigFilename;
 extern const std::string kBootstrapFilename;
+extern const std::string kDiscoveryFilename;
+extern const std::string kReservationFilename;
+// Must be incremented whenever the layout of any message changes.  It's carried at the start of the
+// first message on each connection, and the VaultManager rejects peers using any other version.
+extern const std::uint32_t kProtocolVersion;
+// Version zero is the original, unversioned config file layout.  Version 1 added vault process IDs
+// and version 2 the session ticket key.
+extern const std::uint32_t kConfigFileVersion;
 extern const std::chrono::seconds kRpcTimeout;
 extern const std::chrono::seconds kVaultStopTimeout;
 extern const int kMaxVaultRestarts;
+extern const std::chrono::milliseconds kTimingWheelResolution;
+extern const std::size_t kMaxNewConnections;
+extern const std::size_t kMaxUnvalidatedClients;
+extern const std::uint32_t kMaxAcceptsPerSecond;
+extern const std::uint32_t kAcceptBurst;
+extern const int kMaxConcurrentVaultStarts;
+// A client allows each vault it asks to start up to kVaultSpawnTimeout to be spawned, which covers
+// generating its keys and waiting behind any vaults queued before it, then kVaultStartTimeout from
+// being spawned to be reported as running.
+extern const std::chrono::minutes kVaultSpawnTimeout;
+extern const std::chrono::seconds kVaultStartTimeout;
+extern const std::chrono::hours kSessionTicketLifetime;
+extern const std::chrono::milliseconds kInitialReconnectDelay;
+extern const std::chrono::seconds kMaxReconnectDelay;
+extern const std::size_t kVaultEventHistorySize;
+extern const std::chrono::milliseconds kHeartbeatInterval;
+extern const int kHeartbeatMissThreshold;
+extern const std::chrono::seconds kVaultStatsInterval;
+extern const std::size_t kVaultStatsHistorySize;
+extern const std::chrono::seconds kDiskBudgetInterval;
+extern const double kDiskBudgetFraction;
+extern const double kDiskBudgetTolerance;
+extern const std::chrono::seconds kDiskUsageScanInterval;
+extern const std::uint64_t kReservationGranularity;
+extern const std::uint64_t kVaultLogBudget;
+extern const std::uint64_t kMaxVaultLogFileSize;
+extern const std::chrono::hours kMaxVaultLogFileAge;
+extern const std::chrono::minutes kLogRotationInterval;
+extern const std::size_t kVaultOutputBufferSize;
+extern const std::size_t kMaxVaultOutputChunkSize;
+extern const std::size_t kPersistedVaultOutputSize;
+extern const std::uint64_t kChunkstoreMoveBytesPerSecond;
+extern const std::chrono::minutes kUpgradeWaveTimeout;
+extern const std::chrono::seconds kVaultReconnectTimeout;
+extern const std::chrono::seconds kVaultAdoptTimeout;
+extern const std::chrono::seconds kVaultDrainTimeout;
+extern const std::chrono::seconds kVaultTerminateTimeout;
+extern const std::chrono::milliseconds kVaultExitPollInterval;
 
 DEFINE_OSTREAMABLE_ENUM_VALUES(
     MessageTag, std::uint8_t,
     (ValidateConnectionRequest)(Challenge)(ChallengeResponse)(StartVaultRequest)(
         TakeOwnershipRequest)(VaultRunningResponse)(VaultStarted)(VaultStartedResponse)(
         VaultShutdownRequest)(MaxDiskUsageUpdate)(JoinedNetwork)(LogMessage)(SetNetworkAsStable)(
-        NetworkStableRequest)(NetworkStableResponse))
+        NetworkStableRequest)(NetworkStableResponse)(StartVaultsRequest)(SessionTicket)(
+        ResumeSessionRequest)(ResumeSessionResponse)(ListVaultsRequest)(ListVaultsResponse)(
+        SubscribeToVaultEventsRequest)(UnsubscribeFromVaultEventsRequest)(VaultEventNotification)(
+        Heartbeat)(VaultStatsReport)(HostStatsRequest)(HostStatsResponse)(MoveChunkstoreRequest)(
+        MoveChunkstoreProgress)(MoveChunkstoreResponse)(VaultDrainProgress)(VaultDrained)(
+        TailVaultOutputRequest)(TailVaultOutputResponse)(VaultSpawned))
 
 }  // namespace vault_manager
 
@@ -19,9 +19,12 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_CONFIG_FILE_H_
 #define MAIDSAFE_VAULT_MANAGER_CONFIG_FILE_H_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "cereal/details/helpers.hpp"
+
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/crypto.h"
 #include "maidsafe/common/serialisation/types/boost_filesystem.h"
@@ -33,7 +36,8 @@ namespace maidsafe {
 
 namespace vault_manager {
 
-// Vault to VaultManager
+// Vault to VaultManager.  Fields added since the original layout are appended after all the vault
+// records, preceded by the format version, so that files written by earlier releases still parse.
 struct ConfigFile {
   ConfigFile() = default;
 
@@ -41,10 +45,13 @@ struct ConfigFile {
 
   ConfigFile(ConfigFile&& other) MAIDSAFE_NOEXCEPT
       : symm_key_and_iv(std::move(other.symm_key_and_iv)),
+        session_ticket_key(std::move(other.session_ticket_key)),
         vaults(std::move(other.vaults)) {}
 
-  ConfigFile(crypto::AES256KeyAndIV symm_key_and_iv_in, std::vector<VaultInfo> vaults_in)
+  ConfigFile(crypto::AES256KeyAndIV symm_key_and_iv_in,
+             crypto::AES256KeyAndIV session_ticket_key_in, std::vector<VaultInfo> vaults_in)
       : symm_key_and_iv(std::move(symm_key_and_iv_in)),
+        session_ticket_key(std::move(session_ticket_key_in)),
         vaults(std::move(vaults_in)) {}
 
   ~ConfigFile() = default;
@@ -53,6 +60,7 @@ struct ConfigFile {
 
   ConfigFile& operator=(ConfigFile&& other) MAIDSAFE_NOEXCEPT {
     symm_key_and_iv = std::move(other.symm_key_and_iv);
+    session_ticket_key = std::move(other.session_ticket_key);
     vaults = std::move(other.vaults);
     return *this;
   };
@@ -72,7 +80,24 @@ struct ConfigFile {
                          passport::DecryptAnpmid(encrypted_anpmid, symm_key_and_iv)));
       if (has_owner_name)
         archive(vault.owner_name);
+      vaults.push_back(std::move(vault));
+    }
+
+    // Files written before the format was versioned end here.
+    std::uint32_t version(0);
+    try {
+      archive(version);
+    } catch (const cereal::Exception&) {
+      return;
     }
+    if (version >= 1U) {
+      std::vector<std::uint64_t> process_ids;
+      archive(process_ids);
+      for (std::size_t i(0); i < process_ids.size() && i < vaults.size(); ++i)
+        vaults[i].process_id = process_ids[i];
+    }
+    if (version >= 2U)
+      archive(session_ticket_key);
   }
 
   template <typename Archive>
@@ -86,9 +111,17 @@ struct ConfigFile {
       if (vault.owner_name.IsInitialised())
         archive(vault.owner_name);
     }
+
+    std::vector<std::uint64_t> process_ids;
+    for (const auto& vault : vaults)
+      process_ids.push_back(vault.process_id);
+    archive(kConfigFileVersion, process_ids, session_ticket_key);
   }
 
   crypto::AES256KeyAndIV symm_key_and_iv;
+  // Used only for session tickets.  Unlike 'symm_key_and_iv', this is never sent to vaults, so a
+  // vault can't issue itself a ticket.  Uninitialised if parsed from a file predating version 2.
+  crypto::AES256KeyAndIV session_ticket_key;
   std::vector<VaultInfo> vaults;
 };
 
@@ -49,31 +49,42 @@ ConfigFile ParseConfigFile(const fs::path& config_file_path, std::mutex& mutex)
   return Parse<ConfigFile>(content);
 }
 
-crypto::AES256KeyAndIV InitialiseKeyAndIv(const fs::path& config_file_path, std::mutex& mutex) {
+ConfigFile ReadExistingConfigFile(const fs::path& config_file_path) {
   boost::system::error_code error_code;
   if (!fs::exists(config_file_path, error_code) ||
       error_code.value() == boost::system::errc::no_such_file_or_directory) {
-    return crypto::AES256KeyAndIV{RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
+    return ConfigFile{};
   }
-  ConfigFile config{ParseConfigFile(config_file_path, mutex)};
-  return config.symm_key_and_iv;
+  return Parse<ConfigFile>(ReadFile(config_file_path).value());
+}
+
+crypto::AES256KeyAndIV KeyOrRandom(const crypto::AES256KeyAndIV& key_and_iv) {
+  return key_and_iv.IsInitialised()
+             ? key_and_iv
+             : crypto::AES256KeyAndIV{RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
 }
 
 }  // unnamed namespace
 
 ConfigFileHandler::ConfigFileHandler(fs::path config_file_path)
+    : ConfigFileHandler(config_file_path, ReadExistingConfigFile(config_file_path)) {}
+
+ConfigFileHandler::ConfigFileHandler(fs::path config_file_path, ConfigFile&& existing)
     : config_file_path_(std::move(config_file_path)),
       mutex_(),
-      kSymmKeyAndIV_(InitialiseKeyAndIv(config_file_path_, mutex_)) {
-  boost::system::error_code error_code;
-  if (!fs::exists(config_file_path_, error_code) ||
-      error_code.value() == boost::system::errc::no_such_file_or_directory) {
+      kSymmKeyAndIV_(KeyOrRandom(existing.symm_key_and_iv)),
+      kSessionTicketKey_(KeyOrRandom(existing.session_ticket_key)) {
+  if (!existing.symm_key_and_iv.IsInitialised()) {
     CreateConfigFile();
+  } else if (!existing.session_ticket_key.IsInitialised()) {
+    // Written by an earlier release; store the new key so that tickets survive a restart.
+    LOG(kInfo) << "Adding session ticket key to config file " << config_file_path_;
+    WriteConfigFile(std::move(existing.vaults));
   }
 }
 
 void ConfigFileHandler::CreateConfigFile() {
-  ConfigFile config(kSymmKeyAndIV_, std::vector<VaultInfo>{});
+  ConfigFile config(kSymmKeyAndIV_, kSessionTicketKey_, std::vector<VaultInfo>{});
 
   boost::system::error_code error_code;
   if (!fs::exists(config_file_path_.parent_path(), error_code)) {
@@ -95,11 +106,12 @@ void ConfigFileHandler::CreateConfigFile() {
 std::vector<VaultInfo> ConfigFileHandler::ReadConfigFile() const {
   ConfigFile config{ParseConfigFile(config_file_path_, mutex_)};
   assert(config.symm_key_and_iv == kSymmKeyAndIV_);
+  assert(config.session_ticket_key == kSessionTicketKey_);
   return config.vaults;
 }
 
 void ConfigFileHandler::WriteConfigFile(std::vector<VaultInfo> vaults) const {
-  ConfigFile config(kSymmKeyAndIV_, std::move(vaults));
+  ConfigFile config(kSymmKeyAndIV_, kSessionTicketKey_, std::move(vaults));
   std::lock_guard<std::mutex> lock{mutex_};
   if (!WriteFile(config_file_path_, Serialise(config))) {
     LOG(kError) << "Failed to write config file " << config_file_path_;
@@ -31,6 +31,7 @@ namespace maidsafe {
 
 namespace vault_manager {
 
+struct ConfigFile;
 struct VaultInfo;
 
 class ConfigFileHandler {
@@ -39,8 +40,12 @@ class ConfigFileHandler {
   std::vector<VaultInfo> ReadConfigFile() const;
   void WriteConfigFile(std::vector<VaultInfo> vaults) const;
   const crypto::AES256KeyAndIV& SymmKeyAndIV() const { return kSymmKeyAndIV_; }
+  // Never to be sent to vaults; see ConfigFile::session_ticket_key.
+  const crypto::AES256KeyAndIV& SessionTicketKey() const { return kSessionTicketKey_; }
 
  private:
+  // 'existing' is the parsed config file, or empty if there isn't one yet.
+  ConfigFileHandler(boost::filesystem::path config_file_path, ConfigFile&& existing);
   ConfigFileHandler(const ConfigFileHandler&) = delete;
   ConfigFileHandler(ConfigFileHandler&&) = delete;
   ConfigFileHandler operator=(ConfigFileHandler) = delete;
@@ -49,7 +54,7 @@ class ConfigFileHandler {
 
   boost::filesystem::path config_file_path_;
   mutable std::mutex mutex_;
-  const crypto::AES256KeyAndIV kSymmKeyAndIV_;
+  const crypto::AES256KeyAndIV kSymmKeyAndIV_, kSessionTicketKey_;
 };
 
 }  // namespace vault_manager
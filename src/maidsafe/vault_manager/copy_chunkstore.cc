@@ -0,0 +1,117 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/copy_chunkstore.h"
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+const std::size_t kCopyBlockSize(64 * 1024);
+
+// Sleeps as required to keep the copy rate since 'start' within 'max_bytes_per_second'.
+void Throttle(std::chrono::steady_clock::time_point start, std::uint64_t bytes_copied,
+              std::uint64_t max_bytes_per_second) {
+  if (max_bytes_per_second == 0)
+    return;
+  auto due(start + std::chrono::microseconds(bytes_copied * 1000000 / max_bytes_per_second));
+  if (due > std::chrono::steady_clock::now())
+    std::this_thread::sleep_until(due);
+}
+
+// Appends each regular file under 'dir' to 'files' as its path relative to the top-level dir.
+std::uint64_t ListFiles(const fs::path& dir, const fs::path& relative_dir,
+                        std::vector<std::pair<fs::path, std::uint64_t>>& files) {
+  std::uint64_t bytes_total{0};
+  for (fs::directory_iterator itr(dir), end; itr != end; ++itr) {
+    fs::path relative_path{relative_dir / itr->path().filename()};
+    if (fs::is_directory(itr->status())) {
+      bytes_total += ListFiles(itr->path(), relative_path, files);
+    } else if (fs::is_regular_file(itr->status())) {
+      files.emplace_back(relative_path, fs::file_size(itr->path()));
+      bytes_total += files.back().second;
+    }
+  }
+  return bytes_total;
+}
+
+}  // unnamed namespace
+
+void CopyChunkstore(const fs::path& source, const fs::path& target,
+                    std::uint64_t max_bytes_per_second, CopyProgressFunctor on_progress) {
+  std::vector<std::pair<fs::path, std::uint64_t>> files;
+  const std::uint64_t kBytesTotal(ListFiles(source, fs::path{}, files));
+
+  const auto kStart(std::chrono::steady_clock::now());
+  std::uint64_t bytes_copied{0}, bytes_throttled{0};
+  std::vector<char> buffer(kCopyBlockSize);
+  for (const auto& file : files) {
+    fs::path target_file{target / file.first};
+    boost::system::error_code error_code;
+    if (fs::file_size(target_file, error_code) == file.second && !error_code) {
+      bytes_copied += file.second;
+      continue;
+    }
+
+    fs::create_directories(target_file.parent_path());
+    fs::path partial_file{target_file.string() + ".partial"};
+    {
+      std::ifstream input((source / file.first).string(), std::ios::binary);
+      std::ofstream output(partial_file.string(), std::ios::binary | std::ios::trunc);
+      if (!input || !output) {
+        LOG(kError) << "Failed to open " << source / file.first << " for copying to " << target;
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+      }
+      while (input) {
+        input.read(&buffer[0], buffer.size());
+        output.write(&buffer[0], input.gcount());
+        bytes_throttled += static_cast<std::uint64_t>(input.gcount());
+        Throttle(kStart, bytes_throttled, max_bytes_per_second);
+      }
+      if (!input.eof() || !output.flush()) {
+        LOG(kError) << "Failed to copy " << source / file.first << " to " << target;
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+      }
+    }
+    fs::rename(partial_file, target_file);
+    bytes_copied += file.second;
+    if (on_progress)
+      on_progress(bytes_copied, kBytesTotal);
+  }
+  if (on_progress && files.empty())
+    on_progress(0, 0);
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,98 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/discovery_file.h"
+
+#include <string>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+void WriteDiscoveryFile(const fs::path& discovery_file_path, const DiscoveryInfo& discovery_info) {
+  fs::path temp_path{discovery_file_path};
+  temp_path += "." + RandomAlphaNumericString(8) + ".tmp";
+  if (!WriteFile(temp_path, Serialise(discovery_info))) {
+    LOG(kError) << "Failed to write discovery file " << temp_path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  boost::system::error_code error_code;
+  fs::rename(temp_path, discovery_file_path, error_code);
+  if (error_code) {
+    LOG(kError) << "Failed to rename " << temp_path << " to " << discovery_file_path << ": "
+                << error_code.message();
+    fs::remove(temp_path, error_code);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  LOG(kVerbose) << "Wrote discovery file " << discovery_file_path << " for port "
+                << discovery_info.port;
+}
+
+boost::optional<DiscoveryInfo> ReadDiscoveryFile(const fs::path& discovery_file_path) {
+  try {
+    boost::system::error_code error_code;
+    if (!fs::exists(discovery_file_path, error_code))
+      return boost::none;
+    DiscoveryInfo discovery_info{Parse<DiscoveryInfo>(ReadFile(discovery_file_path).value())};
+    if (discovery_info.protocol_version != kProtocolVersion) {
+      LOG(kInfo) << "Ignoring discovery file for protocol version "
+                 << discovery_info.protocol_version;
+      return boost::none;
+    }
+#ifndef MAIDSAFE_WIN32
+    if (!process::IsRunning(discovery_info.process_id)) {
+      LOG(kInfo) << "Ignoring stale discovery file written by process "
+                 << discovery_info.process_id;
+      return boost::none;
+    }
+#endif
+    return discovery_info;
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to read discovery file " << discovery_file_path << ": "
+                  << boost::diagnostic_information(e);
+    return boost::none;
+  }
+}
+
+void RemoveDiscoveryFile(const fs::path& discovery_file_path, process::ProcessId process_id) {
+  try {
+    boost::system::error_code error_code;
+    if (!fs::exists(discovery_file_path, error_code))
+      return;
+    if (Parse<DiscoveryInfo>(ReadFile(discovery_file_path).value()).process_id == process_id)
+      fs::remove(discovery_file_path, error_code);
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to remove discovery file " << discovery_file_path << ": "
+                  << boost::diagnostic_information(e);
+  }
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,73 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_DISCOVERY_FILE_H_
+#define MAIDSAFE_VAULT_MANAGER_DISCOVERY_FILE_H_
+
+#include <cstdint>
+
+#include "boost/filesystem/path.hpp"
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Published by a running VaultManager so that clients can connect directly to its listening port
+// rather than probing successive ports.
+struct DiscoveryInfo {
+  DiscoveryInfo() : port(0), process_id(0), protocol_version(0) {}
+
+  DiscoveryInfo(tcp::Port port_in, process::ProcessId process_id_in,
+                std::uint32_t protocol_version_in)
+      : port(port_in), process_id(process_id_in), protocol_version(protocol_version_in) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(port, process_id, protocol_version);
+  }
+
+  tcp::Port port;
+  process::ProcessId process_id;
+  std::uint32_t protocol_version;
+};
+
+// Writes to a temporary file in the same directory and renames it over 'discovery_file_path', so
+// readers never see a partially-written file.  Throws on failure.
+void WriteDiscoveryFile(const boost::filesystem::path& discovery_file_path,
+                        const DiscoveryInfo& discovery_info);
+
+// Returns an empty optional if the file doesn't exist, can't be parsed, was written for a
+// different protocol version, or (where this can be checked) names a process which isn't running.
+// Doesn't throw.
+boost::optional<DiscoveryInfo> ReadDiscoveryFile(
+    const boost::filesystem::path& discovery_file_path);
+
+// Removes the file only if it was written by 'process_id', so a VaultManager shutting down doesn't
+// remove a newer instance's file.  Doesn't throw.
+void RemoveDiscoveryFile(const boost::filesystem::path& discovery_file_path,
+                         process::ProcessId process_id);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_DISCOVERY_FILE_H_
@@ -0,0 +1,152 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/disk_budget.h"
+
+#ifndef MAIDSAFE_WIN32
+#include <sys/stat.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+std::uint64_t Fill(std::uint64_t level, std::uint64_t floor, std::uint64_t ceiling) {
+  return std::max(floor, std::min(level, ceiling));
+}
+
+bool IsWithinTolerance(std::uint64_t previous, std::uint64_t current) {
+  std::uint64_t difference{previous > current ? previous - current : current - previous};
+  return static_cast<double>(difference) <= kDiskBudgetTolerance * static_cast<double>(previous);
+}
+
+}  // unnamed namespace
+
+FilesystemSpace GetFilesystemSpace(const fs::path& path) {
+  FilesystemSpace space;
+#ifdef MAIDSAFE_WIN32
+  space.id = std::hash<std::string>()(fs::absolute(path).root_name().string());
+#else
+  struct stat status;
+  if (stat(path.string().c_str(), &status) != 0) {
+    LOG(kWarning) << "Failed to stat " << path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  space.id = static_cast<std::uint64_t>(status.st_dev);
+#endif
+  space.available = fs::space(path).available;
+  return space;
+}
+
+DiskBudget::DiskBudget(double free_space_fraction, GetSpaceFunctor get_space)
+    : kFreeSpaceFraction_(free_space_fraction), kGetSpace_(std::move(get_space)), allocations_() {}
+
+std::vector<std::pair<NonEmptyString, DiskUsage>> DiskBudget::Rebalance(
+    const std::vector<Vault>& vaults) {
+  std::map<std::uint64_t, std::pair<std::uint64_t, std::vector<const Vault*>>> filesystems;
+  std::map<std::uint64_t, std::uint64_t> reserved;
+  std::map<NonEmptyString, DiskUsage> retained;
+  for (const auto& vault : vaults) {
+    auto itr(allocations_.find(vault.label));
+    if (itr != std::end(allocations_))
+      retained.insert(*itr);
+    if (vault.vault_dir.empty())
+      continue;
+    try {
+      FilesystemSpace space{kGetSpace_(vault.vault_dir)};
+      auto& filesystem(filesystems[space.id]);
+      filesystem.first = space.available;
+      filesystem.second.push_back(&vault);
+      reserved[space.id] += vault.reserved;
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Can't rebalance vault " << hex::Encode(vault.label) << ": "
+                    << boost::diagnostic_information(e);
+    }
+  }
+  allocations_.swap(retained);
+
+  std::vector<std::pair<NonEmptyString, DiskUsage>> changes;
+  for (const auto& filesystem : filesystems)
+    Allocate(filesystem.second.second, filesystem.second.first + reserved[filesystem.first],
+             changes);
+  return changes;
+}
+
+DiskUsage DiskBudget::Allocation(const NonEmptyString& label, DiskUsage requested) const {
+  auto itr(allocations_.find(label));
+  return itr == std::end(allocations_) ? requested : itr->second;
+}
+
+void DiskBudget::Allocate(const std::vector<const Vault*>& vaults, std::uint64_t available,
+                          std::vector<std::pair<NonEmptyString, DiskUsage>>& changes) {
+  const std::uint64_t kNoLimit(std::numeric_limits<std::uint64_t>::max());
+  std::uint64_t budget{static_cast<std::uint64_t>(kFreeSpaceFraction_ * available)};
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> bounds;
+  for (const auto& vault : vaults) {
+    std::uint64_t ceiling{vault->requested.data == 0 ? kNoLimit : vault->requested.data};
+    bounds.emplace_back(std::min(vault->bytes_used, ceiling), ceiling);
+    budget += vault->bytes_used;
+  }
+
+  // Find the highest level at which filling every vault up to it (within its bounds) fits the
+  // budget.  The sum of the fills is non-decreasing in the level, so a binary search suffices.
+  auto total([&](std::uint64_t level) {
+    std::uint64_t sum{0};
+    for (const auto& bound : bounds) {
+      sum += Fill(level, bound.first, bound.second);
+      if (sum > budget)
+        break;
+    }
+    return sum;
+  });
+  std::uint64_t low{0}, high{budget};
+  while (low < high) {
+    std::uint64_t middle{low + (high - low + 1) / 2};
+    if (total(middle) <= budget)
+      low = middle;
+    else
+      high = middle - 1;
+  }
+
+  for (std::size_t i(0); i < vaults.size(); ++i) {
+    DiskUsage allocation{Fill(low, bounds[i].first, bounds[i].second)};
+    auto itr(allocations_.find(vaults[i]->label));
+    if (itr != std::end(allocations_) && IsWithinTolerance(itr->second.data, allocation.data))
+      continue;
+    allocations_[vaults[i]->label] = allocation;
+    changes.emplace_back(vaults[i]->label, allocation);
+  }
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
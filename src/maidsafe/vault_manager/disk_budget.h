@@ -0,0 +1,90 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_DISK_BUDGET_H_
+#define MAIDSAFE_VAULT_MANAGER_DISK_BUDGET_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+struct FilesystemSpace {
+  // Identifies the filesystem, so that co-located vault dirs share a budget.
+  std::uint64_t id;
+  std::uint64_t available;
+};
+
+// Throws if 'path' can't be queried.
+FilesystemSpace GetFilesystemSpace(const boost::filesystem::path& path);
+
+// Shares the space on each filesystem hosting vault dirs between the vaults on it.  The budget of a
+// filesystem is the space already used by its vaults plus 'free_space_fraction' of its free space,
+// where the vaults' reservation files count as free space.
+// This is divided equally, except that no vault is allocated less than it already uses, nor more
+// than a non-zero requested limit.  Not threadsafe; the VaultManager only uses this on its own
+// thread.
+class DiskBudget {
+ public:
+  typedef std::function<FilesystemSpace(const boost::filesystem::path&)> GetSpaceFunctor;
+
+  struct Vault {
+    NonEmptyString label;
+    boost::filesystem::path vault_dir;
+    // 0 if the vault may use any share of the budget.
+    DiskUsage requested;
+    std::uint64_t bytes_used;
+    // Size of the vault's reservation file, which is counted as free space.
+    std::uint64_t reserved;
+  };
+
+  explicit DiskBudget(double free_space_fraction = kDiskBudgetFraction,
+                      GetSpaceFunctor get_space = GetFilesystemSpace);
+
+  // Recalculates the allocations of 'vaults', forgetting any others.  Returns the new allocation of
+  // each vault whose previous one differed by more than kDiskBudgetTolerance.  Vaults on a
+  // filesystem which can't be queried keep their previous allocations.
+  std::vector<std::pair<NonEmptyString, DiskUsage>> Rebalance(const std::vector<Vault>& vaults);
+  // Returns the last allocation returned for 'label' by Rebalance, or 'requested' if none.
+  DiskUsage Allocation(const NonEmptyString& label, DiskUsage requested) const;
+
+ private:
+  void Allocate(const std::vector<const Vault*>& vaults, std::uint64_t available,
+                std::vector<std::pair<NonEmptyString, DiskUsage>>& changes);
+
+  const double kFreeSpaceFraction_;
+  const GetSpaceFunctor kGetSpace_;
+  std::map<NonEmptyString, DiskUsage> allocations_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_DISK_BUDGET_H_
@@ -0,0 +1,183 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/disk_usage_scanner.h"
+
+#ifndef MAIDSAFE_WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/on_scope_exit.h"
+
+#include "maidsafe/vault_manager/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+DiskUsageScanner::DiskUsageScanner(unsigned max_threads, std::string ignored_filename)
+    : kMaxThreads_(max_threads == 0 ? std::max(std::thread::hardware_concurrency(), 1U)
+                                    : max_threads),
+      kIgnoredFilename_(std::move(ignored_filename)),
+      caches_() {}
+
+std::vector<std::uint64_t> DiskUsageScanner::Scan(const std::vector<fs::path>& vault_dirs) {
+  const std::time_t kScanStart{std::time(nullptr)};
+  const Cache kEmptyCache;
+  std::vector<std::uint64_t> totals(vault_dirs.size(), 0);
+  std::vector<Cache> new_caches(vault_dirs.size());
+  // Each call only writes to the slots of its own vault dir, and caches_ isn't modified until
+  // they've all finished.
+  ParallelFor(vault_dirs.size(), [&](std::size_t index) {
+    auto itr(caches_.find(vault_dirs[index]));
+    totals[index] = ScanDirectory(vault_dirs[index], kScanStart,
+                                  itr == std::end(caches_) ? kEmptyCache : itr->second,
+                                  new_caches[index]);
+  }, kMaxThreads_);
+
+  caches_.clear();
+  for (std::size_t i(0); i < vault_dirs.size(); ++i)
+    caches_[vault_dirs[i]] = std::move(new_caches[i]);
+  return totals;
+}
+
+std::uint64_t DiskUsageScanner::ScanDirectory(const fs::path& dir, std::time_t scan_start,
+                                              const Cache& old_cache, Cache& new_cache) const {
+  boost::system::error_code error_code;
+  const std::time_t kMtime{fs::last_write_time(dir, error_code)};
+  if (error_code) {
+    LOG(kWarning) << "Failed to stat " << dir << ": " << error_code.message();
+    return 0;
+  }
+
+  Directory directory;
+  auto itr(old_cache.find(dir));
+  if (itr != std::end(old_cache) && itr->second.mtime == kMtime) {
+    directory = itr->second;
+  } else {
+    directory.mtime = kMtime;
+    ListDirectory(dir, directory);
+  }
+
+  std::uint64_t total{TotalFileSizes(dir, directory.files)};
+  for (const auto& subdir : directory.subdirs)
+    total += ScanDirectory(dir / subdir, scan_start, old_cache, new_cache);
+
+  // mtimes only have a resolution of a second, so a directory modified during the second in which
+  // this scan started could change again without its mtime changing.  Such a directory is re-listed
+  // next time.
+  if (kMtime < scan_start)
+    new_cache.emplace(dir, std::move(directory));
+  return total;
+}
+
+#ifdef MAIDSAFE_WIN32
+
+void DiskUsageScanner::ListDirectory(const fs::path& dir, Directory& directory) const {
+  boost::system::error_code error_code;
+  for (fs::directory_iterator itr(dir, error_code), end; !error_code && itr != end;
+       itr.increment(error_code)) {
+    const fs::file_status kStatus{itr->symlink_status(error_code)};
+    if (error_code)
+      continue;
+    if (fs::is_directory(kStatus)) {
+      directory.subdirs.push_back(itr->path().filename().string());
+    } else if (fs::is_regular_file(kStatus) && itr->path().filename() != kIgnoredFilename_) {
+      directory.files.push_back(itr->path().filename().string());
+    }
+  }
+  if (error_code)
+    LOG(kWarning) << "Failed to list " << dir << ": " << error_code.message();
+}
+
+std::uint64_t DiskUsageScanner::TotalFileSizes(const fs::path& dir,
+                                               const std::vector<std::string>& files) const {
+  std::uint64_t total{0};
+  for (const auto& file : files) {
+    boost::system::error_code error_code;
+    const std::uintmax_t kSize{fs::file_size(dir / file, error_code)};
+    if (!error_code)
+      total += kSize;
+  }
+  return total;
+}
+
+#else
+
+// Entries are stat'ed relative to the open directory, which saves resolving the full path of each.
+void DiskUsageScanner::ListDirectory(const fs::path& dir, Directory& directory) const {
+  DIR* dir_stream{opendir(dir.c_str())};
+  if (!dir_stream) {
+    LOG(kWarning) << "Failed to open " << dir;
+    return;
+  }
+  on_scope_exit close_dir{[dir_stream] { closedir(dir_stream); }};
+  const int kDirFd{dirfd(dir_stream)};
+  while (dirent* entry = readdir(dir_stream)) {
+    const std::string kName{entry->d_name};
+    if (kName == "." || kName == "..")
+      continue;
+    struct stat entry_stat;
+    if (fstatat(kDirFd, entry->d_name, &entry_stat, AT_SYMLINK_NOFOLLOW) != 0)
+      continue;
+    if (S_ISDIR(entry_stat.st_mode))
+      directory.subdirs.push_back(kName);
+    else if (S_ISREG(entry_stat.st_mode) && kName != kIgnoredFilename_)
+      directory.files.push_back(kName);
+  }
+}
+
+// A file removed since 'dir' was listed fails to stat and is skipped.
+std::uint64_t DiskUsageScanner::TotalFileSizes(const fs::path& dir,
+                                               const std::vector<std::string>& files) const {
+  if (files.empty())
+    return 0;
+  const int kDirFd{open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+  if (kDirFd == -1) {
+    LOG(kWarning) << "Failed to open " << dir;
+    return 0;
+  }
+  on_scope_exit close_dir{[kDirFd] { close(kDirFd); }};
+  std::uint64_t total{0};
+  for (const auto& file : files) {
+    struct stat file_stat;
+    if (fstatat(kDirFd, file.c_str(), &file_stat, AT_SYMLINK_NOFOLLOW) == 0 &&
+        S_ISREG(file_stat.st_mode)) {
+      total += static_cast<std::uint64_t>(file_stat.st_size);
+    }
+  }
+  return total;
+}
+
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,74 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_DISK_USAGE_SCANNER_H_
+#define MAIDSAFE_VAULT_MANAGER_DISK_USAGE_SCANNER_H_
+
+#include <ctime>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Totals the size of the files below each vault dir.  Each directory's listing is cached against
+// its mtime, so a rescan only re-lists directories which have had entries added, removed or renamed
+// since the previous scan.  Appending to or truncating a file doesn't change its directory's mtime,
+// so every listed file is re-stat'ed on each scan.  Not threadsafe, but Scan itself spreads the
+// vault dirs across up to 'max_threads' threads.
+class DiskUsageScanner {
+ public:
+  // 'max_threads' of 0 uses one thread per hardware thread.  Files named 'ignored_filename' aren't
+  // counted.
+  explicit DiskUsageScanner(unsigned max_threads = 0, std::string ignored_filename = "");
+
+  // Returns the total for each of 'vault_dirs', in the same order.  Unreadable directories are
+  // counted as empty.  Cached state for directories no longer below 'vault_dirs' is dropped.
+  std::vector<std::uint64_t> Scan(const std::vector<boost::filesystem::path>& vault_dirs);
+
+ private:
+  struct Directory {
+    Directory() : mtime(0), files(), subdirs() {}
+    std::time_t mtime;
+    std::vector<std::string> files;
+    std::vector<std::string> subdirs;
+  };
+  typedef std::map<boost::filesystem::path, Directory> Cache;
+
+  std::uint64_t ScanDirectory(const boost::filesystem::path& dir, std::time_t scan_start,
+                              const Cache& old_cache, Cache& new_cache) const;
+  void ListDirectory(const boost::filesystem::path& dir, Directory& directory) const;
+  std::uint64_t TotalFileSizes(const boost::filesystem::path& dir,
+                               const std::vector<std::string>& files) const;
+
+  const unsigned kMaxThreads_;
+  const std::string kIgnoredFilename_;
+  // Keyed by vault dir.
+  std::map<boost::filesystem::path, Cache> caches_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_DISK_USAGE_SCANNER_H_
@@ -0,0 +1,67 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/handler_guard.h"
+
+#include <future>
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/tcp/connection.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+bool HandlerGuard::Enter() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (closed_)
+    return false;
+  ++active_count_;
+  return true;
+}
+
+void HandlerGuard::Leave() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (--active_count_ == 0)
+    cond_var_.notify_all();
+}
+
+void HandlerGuard::Close() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  closed_ = true;
+  cond_var_.wait(lock, [this] { return active_count_ == 0; });
+}
+
+void CloseAndDrain(tcp::ConnectionPtr connection, asio::io_service::strand& strand,
+                   HandlerGuard& guard) {
+  if (connection)
+    connection->Close();
+  if (!strand.running_in_this_thread()) {
+    auto drained(std::make_shared<std::promise<void>>());
+    strand.post([drained] { drained->set_value(); });
+    if (drained->get_future().wait_for(kRpcTimeout) != std::future_status::ready)
+      LOG(kWarning) << "Timed out waiting for strand to drain.";
+  }
+  guard.Close();
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,94 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_HANDLER_GUARD_H_
+#define MAIDSAFE_VAULT_MANAGER_HANDLER_GUARD_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/common/on_scope_exit.h"
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Used by objects which post handlers capturing 'this' to an io_service which may outlive them.
+// Such handlers are wrapped via Guard().  Close() blocks until any wrapped handler currently
+// executing has returned; wrapped handlers invoked after that are no-ops.  Close() must not be
+// called from within a wrapped handler.
+class HandlerGuard {
+ public:
+  HandlerGuard() : mutex_(), cond_var_(), active_count_(0), closed_(false) {}
+
+  // Returns false if the guard has been closed.
+  bool Enter();
+  void Leave();
+  void Close();
+
+ private:
+  HandlerGuard(const HandlerGuard&) = delete;
+  HandlerGuard(HandlerGuard&&) = delete;
+  HandlerGuard& operator=(HandlerGuard) = delete;
+
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  int active_count_;
+  bool closed_;
+};
+
+template <typename Functor>
+class GuardedHandler {
+ public:
+  GuardedHandler(std::shared_ptr<HandlerGuard> guard, Functor functor)
+      : guard_(std::move(guard)), functor_(std::move(functor)) {}
+
+  template <typename... Args>
+  void operator()(Args&&... args) {
+    if (!guard_->Enter())
+      return;
+    on_scope_exit leave{[this] { guard_->Leave(); }};
+    functor_(std::forward<Args>(args)...);
+  }
+
+ private:
+  std::shared_ptr<HandlerGuard> guard_;
+  Functor functor_;
+};
+
+template <typename Functor>
+GuardedHandler<Functor> Guard(std::shared_ptr<HandlerGuard> guard, Functor functor) {
+  return GuardedHandler<Functor>(std::move(guard), std::move(functor));
+}
+
+// Closes 'connection', waits for handlers already queued on 'strand' to run (unless called from
+// within 'strand') and then closes 'guard'.  Waiting on the strand is abandoned after kRpcTimeout
+// in case the io_service has already been stopped.
+void CloseAndDrain(tcp::ConnectionPtr connection, asio::io_service::strand& strand,
+                   HandlerGuard& guard);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_HANDLER_GUARD_H_
@@ -0,0 +1,50 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/heartbeat_monitor.h"
+
+#include <algorithm>
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+HeartbeatMonitor::HeartbeatMonitor(int miss_threshold)
+    : miss_threshold_(std::max(miss_threshold, 1)),
+      missed_count_(0),
+      heartbeat_received_(false),
+      last_progress_(0) {}
+
+void HeartbeatMonitor::OnHeartbeat(std::uint64_t progress) {
+  if (progress != 0 && progress == last_progress_)
+    return;
+  last_progress_ = progress;
+  heartbeat_received_ = true;
+}
+
+bool HeartbeatMonitor::OnIntervalElapsed() {
+  missed_count_ = heartbeat_received_ ? 0 : missed_count_ + 1;
+  heartbeat_received_ = false;
+  return missed_count_ >= miss_threshold_;
+}
+
+int HeartbeatMonitor::MissedCount() const { return missed_count_; }
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,52 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_HEARTBEAT_MONITOR_H_
+#define MAIDSAFE_VAULT_MANAGER_HEARTBEAT_MONITOR_H_
+
+#include <cstdint>
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Decides from a running vault's heartbeats whether it has hung.  A vault which has never reported
+// progress is judged on its heartbeats alone.  Once it has reported progress, a heartbeat carrying
+// an unchanged progress counter means the vault's own event loop has stalled, so it counts as
+// missed.  Not threadsafe.
+class HeartbeatMonitor {
+ public:
+  explicit HeartbeatMonitor(int miss_threshold);
+
+  void OnHeartbeat(std::uint64_t progress);
+  // To be called once per heartbeat interval.  Returns true once 'miss_threshold' consecutive
+  // intervals have elapsed without a heartbeat showing progress.
+  bool OnIntervalElapsed();
+  int MissedCount() const;
+
+ private:
+  int miss_threshold_, missed_count_;
+  bool heartbeat_received_;
+  std::uint64_t last_progress_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_HEARTBEAT_MONITOR_H_
@@ -0,0 +1,68 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_LIST_VAULTS_REQUEST_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_LIST_VAULTS_REQUEST_H_
+
+#include <cstdint>
+
+#include "boost/optional.hpp"
+#include "cereal/types/boost_optional.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Client to VaultManager.  If 'vault_label' is set, only that vault's status is requested.
+struct ListVaultsRequest {
+  static const MessageTag tag = MessageTag::kListVaultsRequest;
+
+  ListVaultsRequest() = default;
+  ListVaultsRequest(const ListVaultsRequest&) = delete;
+  ListVaultsRequest(ListVaultsRequest&& other) MAIDSAFE_NOEXCEPT
+      : request_id(std::move(other.request_id)),
+        vault_label(std::move(other.vault_label)) {}
+  ListVaultsRequest(std::uint32_t request_id_in, boost::optional<NonEmptyString> vault_label_in)
+      : request_id(request_id_in), vault_label(std::move(vault_label_in)) {}
+  ~ListVaultsRequest() = default;
+  ListVaultsRequest& operator=(const ListVaultsRequest&) = delete;
+  ListVaultsRequest& operator=(ListVaultsRequest&& other) MAIDSAFE_NOEXCEPT {
+    request_id = std::move(other.request_id);
+    vault_label = std::move(other.vault_label);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(request_id, vault_label);
+  }
+
+  std::uint32_t request_id;
+  boost::optional<NonEmptyString> vault_label;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_LIST_VAULTS_REQUEST_H_
@@ -0,0 +1,76 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_LIST_VAULTS_RESPONSE_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_LIST_VAULTS_RESPONSE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "boost/optional.hpp"
+#include "cereal/types/boost_optional.hpp"
+#include "cereal/types/vector.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_status.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Client
+struct ListVaultsResponse {
+  static const MessageTag tag = MessageTag::kListVaultsResponse;
+
+  ListVaultsResponse() = default;
+  ListVaultsResponse(const ListVaultsResponse&) = delete;
+  ListVaultsResponse(ListVaultsResponse&& other) MAIDSAFE_NOEXCEPT
+      : request_id(std::move(other.request_id)),
+        vaults(std::move(other.vaults)),
+        error(std::move(other.error)) {}
+  ListVaultsResponse(std::uint32_t request_id_in, std::vector<VaultStatus> vaults_in)
+      : request_id(request_id_in), vaults(std::move(vaults_in)), error() {}
+  ListVaultsResponse(std::uint32_t request_id_in, maidsafe_error error_in)
+      : request_id(request_id_in), vaults(), error(std::move(error_in)) {}
+  ~ListVaultsResponse() = default;
+  ListVaultsResponse& operator=(const ListVaultsResponse&) = delete;
+  ListVaultsResponse& operator=(ListVaultsResponse&& other) MAIDSAFE_NOEXCEPT {
+    request_id = std::move(other.request_id);
+    vaults = std::move(other.vaults);
+    error = std::move(other.error);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(request_id, vaults, error);
+  }
+
+  std::uint32_t request_id;
+  std::vector<VaultStatus> vaults;
+  boost::optional<maidsafe_error> error;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_LIST_VAULTS_RESPONSE_H_
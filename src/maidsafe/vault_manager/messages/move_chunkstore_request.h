@@ -0,0 +1,67 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_MOVE_CHUNKSTORE_REQUEST_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_MOVE_CHUNKSTORE_REQUEST_H_
+
+#include <cstdint>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/serialisation/types/boost_filesystem.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Vault
+struct MoveChunkstoreRequest {
+  static const MessageTag tag = MessageTag::kMoveChunkstoreRequest;
+
+  MoveChunkstoreRequest() = default;
+  MoveChunkstoreRequest(const MoveChunkstoreRequest&) = delete;
+  MoveChunkstoreRequest(MoveChunkstoreRequest&& other) MAIDSAFE_NOEXCEPT
+      : vault_dir(std::move(other.vault_dir)),
+        max_bytes_per_second(std::move(other.max_bytes_per_second)) {}
+  MoveChunkstoreRequest(boost::filesystem::path vault_dir_in, std::uint64_t max_bytes_per_second_in)
+      : vault_dir(std::move(vault_dir_in)), max_bytes_per_second(max_bytes_per_second_in) {}
+  ~MoveChunkstoreRequest() = default;
+  MoveChunkstoreRequest& operator=(const MoveChunkstoreRequest&) = delete;
+  MoveChunkstoreRequest& operator=(MoveChunkstoreRequest&& other) MAIDSAFE_NOEXCEPT {
+    vault_dir = std::move(other.vault_dir);
+    max_bytes_per_second = std::move(other.max_bytes_per_second);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vault_dir, max_bytes_per_second);
+  }
+
+  boost::filesystem::path vault_dir;
+  std::uint64_t max_bytes_per_second;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_MOVE_CHUNKSTORE_REQUEST_H_
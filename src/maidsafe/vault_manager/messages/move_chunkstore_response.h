@@ -0,0 +1,71 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_MOVE_CHUNKSTORE_RESPONSE_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_MOVE_CHUNKSTORE_RESPONSE_H_
+
+#include "boost/filesystem/path.hpp"
+#include "boost/optional.hpp"
+#include "cereal/types/boost_optional.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/serialisation/types/boost_filesystem.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Vault to VaultManager.  Sent once the vault has switched over to 'vault_dir', or has abandoned
+// the move and carried on using its previous dir.
+struct MoveChunkstoreResponse {
+  static const MessageTag tag = MessageTag::kMoveChunkstoreResponse;
+
+  MoveChunkstoreResponse() = default;
+  MoveChunkstoreResponse(const MoveChunkstoreResponse&) = delete;
+  MoveChunkstoreResponse(MoveChunkstoreResponse&& other) MAIDSAFE_NOEXCEPT
+      : vault_dir(std::move(other.vault_dir)),
+        error(std::move(other.error)) {}
+  explicit MoveChunkstoreResponse(boost::filesystem::path vault_dir_in)
+      : vault_dir(std::move(vault_dir_in)), error() {}
+  MoveChunkstoreResponse(boost::filesystem::path vault_dir_in, maidsafe_error error_in)
+      : vault_dir(std::move(vault_dir_in)), error(std::move(error_in)) {}
+  ~MoveChunkstoreResponse() = default;
+  MoveChunkstoreResponse& operator=(const MoveChunkstoreResponse&) = delete;
+  MoveChunkstoreResponse& operator=(MoveChunkstoreResponse&& other) MAIDSAFE_NOEXCEPT {
+    vault_dir = std::move(other.vault_dir);
+    error = std::move(other.error);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vault_dir, error);
+  }
+
+  boost::filesystem::path vault_dir;
+  boost::optional<maidsafe_error> error;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_MOVE_CHUNKSTORE_RESPONSE_H_
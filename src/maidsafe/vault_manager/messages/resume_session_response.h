@@ -0,0 +1,93 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_RESUME_SESSION_RESPONSE_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_RESUME_SESSION_RESPONSE_H_
+
+#include "boost/optional.hpp"
+#include "cereal/types/boost_optional.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Client.  On success, carries a fresh ticket to be used for the next resumption.
+struct ResumeSessionResponse {
+  static const MessageTag tag = MessageTag::kResumeSessionResponse;
+
+  ResumeSessionResponse() = default;
+
+  ResumeSessionResponse(const ResumeSessionResponse&) = delete;
+
+  ResumeSessionResponse(ResumeSessionResponse&& other) MAIDSAFE_NOEXCEPT
+      : ticket(std::move(other.ticket)),
+        error(std::move(other.error)) {
+    ValidateOptions();
+  }
+
+  explicit ResumeSessionResponse(crypto::CipherText ticket_in)
+      : ticket(std::move(ticket_in)), error() {}
+
+  explicit ResumeSessionResponse(maidsafe_error error_in) : ticket(), error(std::move(error_in)) {}
+
+  ~ResumeSessionResponse() = default;
+
+  ResumeSessionResponse& operator=(const ResumeSessionResponse&) = delete;
+
+  ResumeSessionResponse& operator=(ResumeSessionResponse&& other) MAIDSAFE_NOEXCEPT {
+    ticket = std::move(other.ticket);
+    error = std::move(other.error);
+    ValidateOptions();
+    return *this;
+  };
+
+  void ValidateOptions() const {
+    if ((ticket && error) || (!ticket && !error)) {
+      LOG(kError) << "Should contain exactly one of ticket or error.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+    }
+  }
+
+  template <typename Archive>
+  void load(Archive& archive) {
+    archive(ticket, error);
+    ValidateOptions();
+  }
+
+  template <typename Archive>
+  void save(Archive& archive) const {
+    ValidateOptions();
+    archive(ticket, error);
+  }
+
+  boost::optional<crypto::CipherText> ticket;
+  boost::optional<maidsafe_error> error;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_RESUME_SESSION_RESPONSE_H_
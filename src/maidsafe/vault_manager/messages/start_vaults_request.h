@@ -0,0 +1,77 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_START_VAULTS_REQUEST_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_START_VAULTS_REQUEST_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "cereal/types/vector.hpp"
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/messages/start_vault_request.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Client to VaultManager.  Each vault is answered individually via a VaultRunningResponse.
+struct StartVaultsRequest {
+  static const MessageTag tag = MessageTag::kStartVaultsRequest;
+
+  StartVaultsRequest() = default;
+
+  StartVaultsRequest(const StartVaultsRequest&) = delete;
+
+  StartVaultsRequest(StartVaultsRequest&& other) MAIDSAFE_NOEXCEPT
+      : vault_requests(std::move(other.vault_requests)),
+        max_concurrent_starts(std::move(other.max_concurrent_starts)) {}
+
+  StartVaultsRequest(std::vector<StartVaultRequest> vault_requests_in,
+                     std::int32_t max_concurrent_starts_in)
+      : vault_requests(std::move(vault_requests_in)),
+        max_concurrent_starts(max_concurrent_starts_in) {}
+
+  ~StartVaultsRequest() = default;
+
+  StartVaultsRequest& operator=(const StartVaultsRequest&) = delete;
+
+  StartVaultsRequest& operator=(StartVaultsRequest&& other) MAIDSAFE_NOEXCEPT {
+    vault_requests = std::move(other.vault_requests);
+    max_concurrent_starts = std::move(other.max_concurrent_starts);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vault_requests, max_concurrent_starts);
+  }
+
+  std::vector<StartVaultRequest> vault_requests;
+  // Maximum number of this batch's vaults to have starting at once.  0 means no client-side limit.
+  std::int32_t max_concurrent_starts;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_START_VAULTS_REQUEST_H_
@@ -19,13 +19,41 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VALIDATE_CONNECTION_REQUEST_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_VALIDATE_CONNECTION_REQUEST_H_
 
-#include "maidsafe/vault_manager/messages/empty_message.h"
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
-using ValidateConnectionRequest = EmptyMessage<MessageTag::kValidateConnectionRequest>;
+// Client to VaultManager.  As the first message on a connection, it carries the sender's protocol
+// version ahead of anything else, so that the version can be read whatever the sender's layout.
+struct ValidateConnectionRequest {
+  static const MessageTag tag = MessageTag::kValidateConnectionRequest;
+
+  ValidateConnectionRequest() = default;
+  ValidateConnectionRequest(const ValidateConnectionRequest&) = delete;
+  ValidateConnectionRequest(ValidateConnectionRequest&& other) MAIDSAFE_NOEXCEPT
+      : protocol_version(std::move(other.protocol_version)) {}
+  explicit ValidateConnectionRequest(std::uint32_t protocol_version_in)
+      : protocol_version(protocol_version_in) {}
+  ~ValidateConnectionRequest() = default;
+  ValidateConnectionRequest& operator=(const ValidateConnectionRequest&) = delete;
+  ValidateConnectionRequest& operator=(ValidateConnectionRequest&& other) MAIDSAFE_NOEXCEPT {
+    protocol_version = std::move(other.protocol_version);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(protocol_version);
+  }
+
+  std::uint32_t protocol_version;
+};
 
 }  // namespace vault_manager
 
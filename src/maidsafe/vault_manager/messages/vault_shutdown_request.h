@@ -1,4 +1,4 @@
-/*  Copyright 2015 MaidSafe.net limited
+/*  Copyright 2014 MaidSafe.net limited
 
     This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
     version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
@@ -19,13 +19,49 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_SHUTDOWN_REQUEST_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_SHUTDOWN_REQUEST_H_
 
-#include "maidsafe/vault_manager/messages/empty_message.h"
+#include <chrono>
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
-using VaultShutdownRequest = EmptyMessage<MessageTag::kVaultShutdownRequest>;
+// VaultManager to Vault.  The vault has 'drain_timeout' to finish its in-flight work and exit
+// before the VaultManager starts terminating it.
+struct VaultShutdownRequest {
+  static const MessageTag tag = MessageTag::kVaultShutdownRequest;
+
+  VaultShutdownRequest() : drain_timeout(0) {}
+  VaultShutdownRequest(const VaultShutdownRequest&) = delete;
+  VaultShutdownRequest(VaultShutdownRequest&& other) MAIDSAFE_NOEXCEPT
+      : drain_timeout(std::move(other.drain_timeout)) {}
+  explicit VaultShutdownRequest(std::chrono::milliseconds drain_timeout_in)
+      : drain_timeout(drain_timeout_in) {}
+  ~VaultShutdownRequest() = default;
+  VaultShutdownRequest& operator=(const VaultShutdownRequest&) = delete;
+  VaultShutdownRequest& operator=(VaultShutdownRequest&& other) MAIDSAFE_NOEXCEPT {
+    drain_timeout = std::move(other.drain_timeout);
+    return *this;
+  };
+
+  template <typename Archive>
+  void load(Archive& archive) {
+    std::int64_t drain_timeout_ms(0);
+    archive(drain_timeout_ms);
+    drain_timeout = std::chrono::milliseconds(drain_timeout_ms);
+  }
+
+  template <typename Archive>
+  void save(Archive& archive) const {
+    archive(static_cast<std::int64_t>(drain_timeout.count()));
+  }
+
+  std::chrono::milliseconds drain_timeout;
+};
 
 }  // namespace vault_manager
 
@@ -0,0 +1,60 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_SPAWNED_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_SPAWNED_H_
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Client.  Sent to a vault's owner once the vault's process has been launched, so
+// that the owner can time the vault's start from then, rather than from its request.
+struct VaultSpawned {
+  static const MessageTag tag = MessageTag::kVaultSpawned;
+
+  VaultSpawned() = default;
+  VaultSpawned(const VaultSpawned&) = delete;
+  VaultSpawned(VaultSpawned&& other) MAIDSAFE_NOEXCEPT
+      : vault_label(std::move(other.vault_label)) {}
+  explicit VaultSpawned(NonEmptyString vault_label_in) : vault_label(std::move(vault_label_in)) {}
+  ~VaultSpawned() = default;
+  VaultSpawned& operator=(const VaultSpawned&) = delete;
+  VaultSpawned& operator=(VaultSpawned&& other) MAIDSAFE_NOEXCEPT {
+    vault_label = std::move(other.vault_label);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vault_label);
+  }
+
+  NonEmptyString vault_label;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_SPAWNED_H_
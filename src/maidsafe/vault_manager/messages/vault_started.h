@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STARTED_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STARTED_H_
 
+#include <cstdint>
+
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/process.h"
 
@@ -28,26 +30,32 @@ namespace maidsafe {
 
 namespace vault_manager {
 
-// Vault to VaultManager
+// Vault to VaultManager.  As the first message on a vault's connection, it carries the vault's
+// protocol version ahead of anything else.
 struct VaultStarted {
   static const MessageTag tag = MessageTag::kVaultStarted;
 
   VaultStarted() = default;
   VaultStarted(const VaultStarted&) = delete;
-  VaultStarted(VaultStarted&& other) MAIDSAFE_NOEXCEPT : process_id(std::move(other.process_id)) {}
-  explicit VaultStarted(process::ProcessId process_id_in) : process_id(process_id_in) {}
+  VaultStarted(VaultStarted&& other) MAIDSAFE_NOEXCEPT
+      : protocol_version(std::move(other.protocol_version)),
+        process_id(std::move(other.process_id)) {}
+  VaultStarted(std::uint32_t protocol_version_in, process::ProcessId process_id_in)
+      : protocol_version(protocol_version_in), process_id(process_id_in) {}
   ~VaultStarted() = default;
   VaultStarted& operator=(const VaultStarted&) = delete;
   VaultStarted& operator=(VaultStarted&& other) MAIDSAFE_NOEXCEPT {
+    protocol_version = std::move(other.protocol_version);
     process_id = std::move(other.process_id);
     return *this;
   };
 
   template <typename Archive>
   void serialize(Archive& archive) {
-    archive(process_id);
+    archive(protocol_version, process_id);
   }
 
+  std::uint32_t protocol_version;
   process::ProcessId process_id;
 };
 
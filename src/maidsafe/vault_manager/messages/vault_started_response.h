@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STARTED_RESPONSE_H_
 #define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STARTED_RESPONSE_H_
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -60,10 +62,12 @@ struct VaultStartedResponse {
 #ifdef TESTING
         public_pmids(std::move(other.public_pmids)),
 #endif
-        max_disk_usage(std::move(other.max_disk_usage)) {
+        max_disk_usage(std::move(other.max_disk_usage)),
+        heartbeat_interval(std::move(other.heartbeat_interval)) {
   }
 
-  VaultStartedResponse(const VaultInfo& vault_info, crypto::AES256KeyAndIV symm_key_and_iv_in)
+  VaultStartedResponse(const VaultInfo& vault_info, crypto::AES256KeyAndIV symm_key_and_iv_in,
+                       std::chrono::milliseconds heartbeat_interval_in)
       : symm_key_and_iv(std::move(symm_key_and_iv_in)),
         pmid(maidsafe::make_unique<passport::Pmid>(vault_info.pmid_and_signer->first)),
         vault_dir(vault_info.vault_dir),
@@ -76,7 +80,8 @@ struct VaultStartedResponse {
 #ifdef TESTING
         public_pmids(GetPublicPmids()),
 #endif
-        max_disk_usage(vault_info.max_disk_usage) {
+        max_disk_usage(vault_info.max_disk_usage),
+        heartbeat_interval(heartbeat_interval_in) {
   }
 
   ~VaultStartedResponse() = default;
@@ -97,6 +102,7 @@ struct VaultStartedResponse {
     public_pmids = std::move(other.public_pmids);
 #endif
     max_disk_usage = std::move(other.max_disk_usage);
+    heartbeat_interval = std::move(other.heartbeat_interval);
     return *this;
   };
 
@@ -115,7 +121,9 @@ struct VaultStartedResponse {
 #ifdef TESTING
     archive(public_pmids);
 #endif
-    archive(max_disk_usage);
+    std::int64_t heartbeat_interval_ms(0);
+    archive(max_disk_usage, heartbeat_interval_ms);
+    heartbeat_interval = std::chrono::milliseconds(heartbeat_interval_ms);
   }
 
   template <typename Archive>
@@ -130,7 +138,7 @@ struct VaultStartedResponse {
 #ifdef TESTING
     archive(public_pmids);
 #endif
-    archive(max_disk_usage);
+    archive(max_disk_usage, static_cast<std::int64_t>(heartbeat_interval.count()));
   }
 
   crypto::AES256KeyAndIV symm_key_and_iv;
@@ -146,6 +154,7 @@ struct VaultStartedResponse {
   std::vector<passport::PublicPmid> public_pmids;
 #endif
   DiskUsage max_disk_usage;
+  std::chrono::milliseconds heartbeat_interval;
 };
 
 }  // namespace vault_manager
@@ -0,0 +1,58 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STATS_REPORT_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STATS_REPORT_H_
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_stats.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Vault to VaultManager
+struct VaultStatsReport {
+  static const MessageTag tag = MessageTag::kVaultStatsReport;
+
+  VaultStatsReport() = default;
+  VaultStatsReport(const VaultStatsReport&) = delete;
+  VaultStatsReport(VaultStatsReport&& other) MAIDSAFE_NOEXCEPT : stats(std::move(other.stats)) {}
+  explicit VaultStatsReport(VaultStats stats_in) : stats(std::move(stats_in)) {}
+  ~VaultStatsReport() = default;
+  VaultStatsReport& operator=(const VaultStatsReport&) = delete;
+  VaultStatsReport& operator=(VaultStatsReport&& other) MAIDSAFE_NOEXCEPT {
+    stats = std::move(other.stats);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(stats);
+  }
+
+  VaultStats stats;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STATS_REPORT_H_
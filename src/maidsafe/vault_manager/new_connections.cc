@@ -30,7 +30,7 @@ namespace maidsafe {
 namespace vault_manager {
 
 NewConnections::NewConnections(asio::io_service& io_service)
-    : io_service_(io_service), connections_() {}
+    : timing_wheel_(TimingWheel::Get(io_service)), connections_() {}
 
 std::shared_ptr<NewConnections> NewConnections::MakeShared(asio::io_service& io_service) {
   return std::shared_ptr<NewConnections>{new NewConnections{io_service}};
@@ -39,20 +39,30 @@ std::shared_ptr<NewConnections> NewConnections::MakeShared(asio::io_service& io_
 NewConnections::~NewConnections() { assert(connections_.empty()); }
 
 void NewConnections::Add(tcp::ConnectionPtr connection) {
-  TimerPtr timer{std::make_shared<Timer>(io_service_, kRpcTimeout)};
-  timer->async_wait([connection](const std::error_code& error_code) {
-    if (!error_code || error_code != asio::error::operation_aborted) {
-      LOG(kWarning) << "Timed out waiting for new connection to identify itself.";
-      connection->Close();
-    }
-  });
-  bool result{connections_.emplace(connection, timer).second};
+  TimingWheel::Handle timer{timing_wheel_.Arm(kRpcTimeout, [connection] {
+    LOG(kWarning) << "Timed out waiting for new connection to identify itself.";
+    connection->Close();
+  })};
+  bool result{connections_.emplace(connection, Entry{timer, false}).second};
   assert(result);
   static_cast<void>(result);
 }
 
 bool NewConnections::Remove(tcp::ConnectionPtr connection) {
-  return connections_.erase(connection) == 1U;
+  auto itr(connections_.find(connection));
+  if (itr == std::end(connections_))
+    return false;
+  itr->second.timer.Cancel();
+  connections_.erase(itr);
+  return true;
+}
+
+bool NewConnections::RecordResumeAttempt(tcp::ConnectionPtr connection) {
+  auto itr(connections_.find(connection));
+  if (itr == std::end(connections_) || itr->second.resume_attempted)
+    return false;
+  itr->second.resume_attempted = true;
+  return true;
 }
 
 void NewConnections::CloseAll() {
@@ -60,6 +70,8 @@ void NewConnections::CloseAll() {
     connection.first->Close();
 }
 
+std::size_t NewConnections::Size() const { return connections_.size(); }
+
 }  //  namespace vault_manager
 
 }  //  namespace maidsafe
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_NEW_CONNECTIONS_H_
 #define MAIDSAFE_VAULT_MANAGER_NEW_CONNECTIONS_H_
 
+#include <cstddef>
 #include <map>
 #include <memory>
 
@@ -27,6 +28,7 @@
 #include "maidsafe/common/types.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 
 namespace maidsafe {
 
@@ -38,13 +40,22 @@ class NewConnections : public std::enable_shared_from_this<NewConnections> {
   ~NewConnections();
   void Add(tcp::ConnectionPtr connection);
   bool Remove(tcp::ConnectionPtr connection);
+  // Returns false if 'connection' isn't held, or has already attempted to resume a session.  A
+  // connection is allowed a single attempt, and keeps its original deadline if that fails.
+  bool RecordResumeAttempt(tcp::ConnectionPtr connection);
   void CloseAll();
+  std::size_t Size() const;
 
  private:
+  struct Entry {
+    TimingWheel::Handle timer;
+    bool resume_attempted;
+  };
+
   explicit NewConnections(asio::io_service& io_service);
 
-  asio::io_service& io_service_;
-  std::map<tcp::ConnectionPtr, TimerPtr, std::owner_less<tcp::ConnectionPtr>> connections_;
+  TimingWheel& timing_wheel_;
+  std::map<tcp::ConnectionPtr, Entry, std::owner_less<tcp::ConnectionPtr>> connections_;
 };
 
 }  // namespace vault_manager
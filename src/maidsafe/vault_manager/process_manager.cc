@@ -19,8 +19,21 @@
 #include "maidsafe/vault_manager/process_manager.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
 #include <type_traits>
 
+#ifndef MAIDSAFE_WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #ifdef MAIDSAFE_BSD
 extern "C" char** environ;
 #endif
@@ -40,7 +53,6 @@ extern "C" char** environ;
 
 #include "maidsafe/common/convert.h"
 #include "maidsafe/common/log.h"
-#include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/utils.h"
@@ -86,18 +98,106 @@ void CheckNewVaultDoesntConflict(const VaultInfo& new_vault, const VaultInfo& ex
   }
 }
 
+void CheckExecutable(const fs::path& executable_path) {
+  boost::system::error_code ec;
+  if (!fs::exists(executable_path, ec) || ec) {
+    LOG(kError) << executable_path << " doesn't exist.  " << (ec ? ec.message() : "");
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  if (!fs::is_regular_file(executable_path, ec) || ec) {
+    LOG(kError) << executable_path << " is not a regular file.  " << (ec ? ec.message() : "");
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  if (fs::is_symlink(executable_path, ec) || ec) {
+    LOG(kError) << executable_path << " is a symlink.  " << (ec ? ec.message() : "");
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+}
+
+// Guards against the recorded process ID having been reused by an unrelated process since the
+// vault was last running.
+bool IsVaultProcess(ProcessId process_id, const fs::path& vault_dir) {
+#ifdef MAIDSAFE_WIN32
+  static_cast<void>(process_id);
+  static_cast<void>(vault_dir);
+  return false;
+#else
+  if (!process::IsRunning(static_cast<process::ProcessId>(process_id)))
+    return false;
+#ifdef __linux__
+  // Vaults are passed their log folder, which lies within their vault dir.
+  std::ifstream cmdline_file{"/proc/" + std::to_string(process_id) + "/cmdline",
+                             std::ios::binary};
+  const std::string kCmdline{std::istreambuf_iterator<char>(cmdline_file),
+                             std::istreambuf_iterator<char>()};
+  return kCmdline.find((vault_dir / "logs").string()) != std::string::npos;
+#else
+  return true;
+#endif
+#endif
+}
+
+#ifndef MAIDSAFE_WIN32
+// Creates a pipe whose ends aren't inherited by any child, so that a vault can't hold open the
+// pipe of another vault.
+bool CreateOutputPipe(int (&pipe_fds)[2]) {
+#ifdef __linux__
+  return pipe2(pipe_fds, O_CLOEXEC) == 0;
+#else
+  if (pipe(pipe_fds) != 0)
+    return false;
+  for (int fd : pipe_fds)
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  return true;
+#endif
+}
+
+// Redirects the child's stdout and stderr to 'fd', unless that's -1.  They share one pipe so that
+// their output stays in order.  The child ignores SIGPIPE (which persists across exec), so that it
+// isn't killed by writing its output once we've exited or crashed, leaving the pipe unread.
+class BindOutput : public bp::initializers::initializer_base {
+ public:
+  explicit BindOutput(int fd) : fd_(fd) {}
+
+  template <typename PosixExecutor>
+  void on_exec_setup(PosixExecutor&) const {
+    if (fd_ == -1)
+      return;
+    signal(SIGPIPE, SIG_IGN);
+    dup2(fd_, STDOUT_FILENO);
+    dup2(fd_, STDERR_FILENO);
+  }
+
+ private:
+  int fd_;
+};
+#endif
+
 }  // unnamed namespace
 
-ProcessManager::Child::Child(VaultInfo info, asio::io_service& io_service, int restarts)
+#ifdef MAIDSAFE_WIN32
+ProcessManager::Child::Child(VaultInfo info, asio::io_service& io_service, int restarts,
+                             fs::path executable_path_in)
+#else
+ProcessManager::Child::Child(VaultInfo info, int restarts, fs::path executable_path_in)
+#endif
     : info(std::move(info)),
+      executable_path(std::move(executable_path_in)),
       on_exit(),
-      timer(maidsafe::make_unique<Timer>(io_service)),
+      timer(),
+      heartbeat_monitor(kHeartbeatMissThreshold),
+      heartbeat_timer(),
+      exit_poll_timer(),
       restart_count(restarts),
       process_args(),
       status(ProcessStatus::kBeforeStarted),
+      stop_stage(StopStage::kDraining),
+      start_time(),
+      batch(),
+      adopted(false),
 #ifdef MAIDSAFE_WIN32
-      process(PROCESS_INFORMATION()),
-      handle(io_service) {
+      handle(io_service),
+      process(PROCESS_INFORMATION()) {
 }
 #else
       process(0) {
@@ -106,14 +206,22 @@ ProcessManager::Child::Child(VaultInfo info, asio::io_service& io_service, int r
 
 ProcessManager::Child::Child(Child&& other)
     : info(std::move(other.info)),
+      executable_path(std::move(other.executable_path)),
       on_exit(std::move(other.on_exit)),
       timer(std::move(other.timer)),
+      heartbeat_monitor(std::move(other.heartbeat_monitor)),
+      heartbeat_timer(std::move(other.heartbeat_timer)),
+      exit_poll_timer(std::move(other.exit_poll_timer)),
       restart_count(std::move(other.restart_count)),
       process_args(std::move(other.process_args)),
       status(std::move(other.status)),
+      stop_stage(std::move(other.stop_stage)),
+      start_time(std::move(other.start_time)),
+      batch(std::move(other.batch)),
+      adopted(std::move(other.adopted)),
 #ifdef MAIDSAFE_WIN32
-      process(std::move(other.process)),
-      handle(std::move(other.handle)) {
+      handle(std::move(other.handle)),
+      process(std::move(other.process)) {
 }
 #else
       process(std::move(other.process)) {
@@ -128,71 +236,119 @@ ProcessManager::Child& ProcessManager::Child::operator=(Child other) {
 void swap(ProcessManager::Child& lhs, ProcessManager::Child& rhs) {
   using std::swap;
   swap(lhs.info, rhs.info);
+  swap(lhs.executable_path, rhs.executable_path);
   swap(lhs.on_exit, rhs.on_exit);
   swap(lhs.timer, rhs.timer);
+  swap(lhs.heartbeat_monitor, rhs.heartbeat_monitor);
+  swap(lhs.heartbeat_timer, rhs.heartbeat_timer);
+  swap(lhs.exit_poll_timer, rhs.exit_poll_timer);
   swap(lhs.restart_count, rhs.restart_count);
   swap(lhs.process_args, rhs.process_args);
   swap(lhs.status, rhs.status);
+  swap(lhs.stop_stage, rhs.stop_stage);
+  swap(lhs.start_time, rhs.start_time);
+  swap(lhs.batch, rhs.batch);
+  swap(lhs.adopted, rhs.adopted);
   swap(lhs.process, rhs.process);
 #ifdef MAIDSAFE_WIN32
   swap(lhs.handle, rhs.handle);
 #endif
 }
 
-
-
 ProcessManager::ProcessManager(asio::io_service& io_service, fs::path vault_executable_path,
-                               tcp::Port listening_port)
+                               tcp::Port listening_port, int max_concurrent_starts,
+                               OnVaultEventFunctor on_vault_event,
+                               std::chrono::milliseconds heartbeat_interval,
+                               int heartbeat_miss_threshold,
+                               std::chrono::milliseconds drain_timeout, bool capture_output)
     : io_service_(io_service),
+      timing_wheel_(TimingWheel::Get(io_service)),
 #ifndef MAIDSAFE_WIN32
       signal_set_(io_service_, SIGCHLD),
+      watching_exits_(true),
 #endif
       stop_all_flag_(),
       kListeningPort_(listening_port),
-      kVaultExecutablePath_(vault_executable_path),
-      vaults_() {
+      kMaxConcurrentStarts_(std::max(max_concurrent_starts, 1)),
+      vault_executable_path_(vault_executable_path),
+      kOnVaultEvent_(std::move(on_vault_event)),
+      kHeartbeatInterval_(heartbeat_interval),
+      kHeartbeatMissThreshold_(heartbeat_miss_threshold),
+      kDrainTimeout_(drain_timeout),
+      kCaptureOutput_(capture_output),
+      vaults_(),
+      outputs_(),
+#ifndef MAIDSAFE_WIN32
+      output_readers_(),
+#endif
+      upgrade_() {
   static_assert(std::is_same<ProcessId, process::ProcessId>::value,
                 "process::ProcessId is statically checked as being of suitable size for holding a "
                 "pid_t or DWORD, so vault_manager::ProcessId should use the same type.");
-  boost::system::error_code ec;
-  if (!fs::exists(kVaultExecutablePath_, ec) || ec) {
-    LOG(kError) << kVaultExecutablePath_ << " doesn't exist.  " << (ec ? ec.message() : "");
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
-  }
-  if (!fs::is_regular_file(kVaultExecutablePath_, ec) || ec) {
-    LOG(kError) << kVaultExecutablePath_ << " is not a regular file.  " << (ec ? ec.message() : "");
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
-  }
-  if (fs::is_symlink(kVaultExecutablePath_, ec) || ec) {
-    LOG(kError) << kVaultExecutablePath_ << " is a symlink.  " << (ec ? ec.message() : "");
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
-  }
+  CheckExecutable(vault_executable_path_);
   InitSignalHandler();
 }
 
 std::shared_ptr<ProcessManager> ProcessManager::MakeShared(
     asio::io_service& io_service, boost::filesystem::path vault_executable_path,
-    tcp::Port listening_port) {
-  return std::shared_ptr<ProcessManager>{
-      new ProcessManager{io_service, vault_executable_path, listening_port}};
+    tcp::Port listening_port, int max_concurrent_starts, OnVaultEventFunctor on_vault_event,
+    std::chrono::milliseconds heartbeat_interval, int heartbeat_miss_threshold,
+    std::chrono::milliseconds drain_timeout, bool capture_output) {
+  return std::shared_ptr<ProcessManager>{new ProcessManager{
+      io_service, vault_executable_path, listening_port, max_concurrent_starts,
+      std::move(on_vault_event), heartbeat_interval, heartbeat_miss_threshold, drain_timeout,
+      capture_output}};
 }
 
 ProcessManager::~ProcessManager() { assert(vaults_.empty()); }
 
 void ProcessManager::StopAll() {
   std::call_once(stop_all_flag_, [this] {
+    AbandonUpgrade();
+    RemoveQueuedProcesses();
     for (const auto& vault : vaults_)
       StopProcess(vault.info.tcp_connection);
 #ifndef MAIDSAFE_WIN32
-    std::error_code ignored_ec;
-    signal_set_.cancel(ignored_ec);
+    StopWatchingExits();
 #endif
   });
 }
 
+void ProcessManager::ReleaseAll() {
+#ifdef MAIDSAFE_WIN32
+  StopAll();
+#else
+  std::call_once(stop_all_flag_, [this] {
+    AbandonUpgrade();
+    RemoveQueuedProcesses();
+    std::vector<tcp::ConnectionPtr> released_connections;
+    for (auto itr(std::begin(vaults_)); itr != std::end(vaults_); ++itr) {
+      itr->timer.Cancel();
+      itr->heartbeat_timer.Cancel();
+      itr->exit_poll_timer.Cancel();
+      if (itr->status == ProcessStatus::kRunning) {
+        LOG(kInfo) << "Releasing vault " << hex::Encode(itr->info.label) << " with process ID "
+                   << GetProcessId(*itr);
+        released_connections.push_back(itr->info.tcp_connection);
+      } else if (IsRunning(*itr)) {
+        TerminateProcess(itr);
+      }
+    }
+    // Close the connections only once the vaults are forgotten, or their closure would be treated
+    // as the vaults having died.
+    vaults_.clear();
+    for (const auto& connection : released_connections)
+      connection->Close();
+    StopWatchingExits();
+  });
+#endif
+}
+
 void ProcessManager::StopAllWithInterval() {
   int index(0);
   std::call_once(stop_all_flag_, [this, &index] {
+    AbandonUpgrade();
+    RemoveQueuedProcesses();
     std::vector<tcp::ConnectionPtr> connections;
     for (const auto& vault : vaults_)
       connections.push_back(vault.info.tcp_connection);
@@ -203,19 +359,42 @@ void ProcessManager::StopAllWithInterval() {
       Sleep(std::chrono::seconds(5));
     }
 #ifndef MAIDSAFE_WIN32
-    std::error_code ignored_ec;
-    signal_set_.cancel(ignored_ec);
+    StopWatchingExits();
 #endif
   });
 }
 
 std::vector<VaultInfo> ProcessManager::GetAll() const {
   std::vector<VaultInfo> all_vaults;
-  for (const auto& vault : vaults_)
+  for (const auto& vault : vaults_) {
     all_vaults.push_back(vault.info);
+    all_vaults.back().process_id =
+        vault.status == ProcessStatus::kBeforeStarted ? 0 : GetProcessId(vault);
+  }
   return all_vaults;
 }
 
+std::vector<VaultStatus> ProcessManager::GetStatuses() const {
+  const auto kNow(std::chrono::steady_clock::now());
+  std::vector<VaultStatus> statuses;
+  statuses.reserve(vaults_.size());
+  for (const auto& vault : vaults_) {
+    VaultStatus vault_status;
+    vault_status.label = vault.info.label;
+    vault_status.status = vault.status;
+    vault_status.restart_count = vault.restart_count;
+    vault_status.max_disk_usage = vault.info.max_disk_usage;
+    vault_status.owner_name = vault.info.owner_name;
+    if (vault.status != ProcessStatus::kBeforeStarted) {
+      vault_status.process_id = GetProcessId(vault);
+      vault_status.uptime =
+          std::chrono::duration_cast<std::chrono::seconds>(kNow - vault.start_time);
+    }
+    statuses.push_back(std::move(vault_status));
+  }
+  return statuses;
+}
+
 void ProcessManager::AddProcess(VaultInfo info, int restart_count) {
   if (info.vault_dir.empty() || !info.label.IsInitialised() || !info.pmid_and_signer) {
     LOG(kError) << "Can't add vault: vault_dir path and/or vault label and/or Pmid is empty.";
@@ -229,12 +408,72 @@ void ProcessManager::AddProcess(VaultInfo info, int restart_count) {
     CheckNewVaultDoesntConflict(info, vault.info);
 
   // emplace offers strong exception guarantee - only need to cover subsequent calls.
-  auto itr(vaults_.emplace(std::end(vaults_), Child{info, io_service_, restart_count}));
+  auto itr(vaults_.emplace(std::end(vaults_), MakeChild(info, restart_count)));
   on_scope_exit strong_guarantee{[this, itr] { vaults_.erase(itr); }};
   StartProcess(itr);
   strong_guarantee.Release();
 }
 
+bool ProcessManager::AdoptProcess(VaultInfo info, ProcessId process_id) {
+  if (info.vault_dir.empty() || !info.label.IsInitialised() || !info.pmid_and_signer) {
+    LOG(kError) << "Can't adopt vault: vault_dir path and/or vault label and/or Pmid is empty.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  if (!IsVaultProcess(process_id, info.vault_dir)) {
+    LOG(kInfo) << "Vault " << hex::Encode(info.label) << " is no longer running as process ID "
+               << process_id;
+    return false;
+  }
+  for (const auto& vault : vaults_)
+    CheckNewVaultDoesntConflict(info, vault.info);
+
+#ifdef MAIDSAFE_WIN32
+  return false;
+#else
+  auto itr(vaults_.emplace(std::end(vaults_), MakeChild(info, 0)));
+  // The vault isn't our child, so its exit is never reported via SIGCHLD; it's polled for once the
+  // vault's connection closes.
+  itr->process = bp::child{static_cast<pid_t>(process_id)};
+  itr->adopted = true;
+  itr->status = ProcessStatus::kStarting;
+  itr->start_time = std::chrono::steady_clock::now();
+  NonEmptyString label{itr->info.label};
+  itr->timer = timing_wheel_.Arm(kVaultAdoptTimeout, [this, label] {
+    LOG(kWarning) << "Timed out waiting for running vault to reconnect.";
+    OnProcessExit(label, -1, true);
+  });
+  LOG(kInfo) << "Adopting vault " << hex::Encode(label) << " with process ID " << process_id;
+  return true;
+#endif
+}
+
+void ProcessManager::AddProcesses(std::vector<VaultInfo> infos, int max_concurrent_starts,
+                                  OnStartFailedFunctor on_start_failed) {
+  auto batch(std::make_shared<StartBatch>(max_concurrent_starts, std::move(on_start_failed)));
+  std::vector<std::pair<NonEmptyString, maidsafe_error>> failures;
+  for (auto& info : infos) {
+    try {
+      if (info.vault_dir.empty() || !info.label.IsInitialised() || !info.pmid_and_signer) {
+        LOG(kError) << "Can't add vault: vault_dir path and/or vault label and/or Pmid is empty.";
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+      }
+      for (const auto& vault : vaults_)
+        CheckNewVaultDoesntConflict(info, vault.info);
+      vaults_.emplace_back(MakeChild(info, 0));
+      vaults_.back().batch = batch;
+    } catch (const maidsafe_error& error) {
+      failures.emplace_back(info.label, error);
+    }
+  }
+  LOG(kInfo) << "Queued " << infos.size() - failures.size() << " vaults for starting.";
+
+  for (auto& failure : failures) {
+    if (batch->on_start_failed)
+      batch->on_start_failed(failure.first, failure.second);
+  }
+  StartQueuedProcesses();
+}
+
 VaultInfo ProcessManager::HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id) {
   auto itr(
       std::find_if(std::begin(vaults_), std::end(vaults_), [this, process_id](const Child& vault) {
@@ -244,10 +483,33 @@ VaultInfo ProcessManager::HandleVaultStarted(tcp::ConnectionPtr connection, Proc
     LOG(kError) << "Failed to find vault with process ID " << process_id << " in child processes.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
-  itr->timer->cancel();
+  itr->timer.Cancel();
   itr->info.tcp_connection = connection;
   itr->status = ProcessStatus::kRunning;
-  return itr->info;
+  itr->batch.reset();
+  VaultInfo vault_info{itr->info};
+  NotifyVaultEvent(VaultEventType::kStarted, itr->info.label, process_id);
+  itr->heartbeat_monitor = HeartbeatMonitor{kHeartbeatMissThreshold_};
+  ArmHeartbeatTimer(itr);
+  StartQueuedProcesses();
+  return vault_info;
+}
+
+VaultInfo ProcessManager::HandleJoinedNetwork(tcp::ConnectionPtr connection) {
+  auto itr(DoFind(connection));
+  VaultInfo vault_info{itr->info};
+  NotifyVaultEvent(VaultEventType::kJoined, vault_info.label, GetProcessId(*itr));
+  if (upgrade_ && itr->status == ProcessStatus::kRunning &&
+      itr->executable_path == upgrade_->executable_path &&
+      upgrade_->wave.erase(vault_info.label) != 0U && upgrade_->wave.empty()) {
+    upgrade_->timer.Cancel();
+    StartUpgradeWave();
+  }
+  return vault_info;
+}
+
+void ProcessManager::HandleHeartbeat(tcp::ConnectionPtr connection, std::uint64_t progress) {
+  DoFind(connection)->heartbeat_monitor.OnHeartbeat(progress);
 }
 
 void ProcessManager::AssignOwner(const NonEmptyString& label, const Identity& owner_name,
@@ -257,26 +519,72 @@ void ProcessManager::AssignOwner(const NonEmptyString& label, const Identity& ow
   itr->info.max_disk_usage = max_disk_usage;
 }
 
+void ProcessManager::SetVaultDir(const NonEmptyString& label, const fs::path& vault_dir) {
+  DoFind(label)->info.vault_dir = vault_dir;
+}
+
+void ProcessManager::UpgradeVaults(fs::path new_executable_path, int wave_size,
+                                   std::chrono::steady_clock::duration wave_timeout,
+                                   OnUpgradeDoneFunctor on_done) {
+  if (upgrade_) {
+    LOG(kError) << "An upgrade to " << upgrade_->executable_path << " is already in progress.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::already_initialised));
+  }
+  CheckExecutable(new_executable_path);
+  upgrade_.reset(new Upgrade{std::move(new_executable_path), wave_size, wave_timeout,
+                             std::move(on_done)});
+  for (const auto& vault : vaults_)
+    upgrade_->pending.push_back(vault.info.label);
+  LOG(kInfo) << "Upgrading " << vaults_.size() << " vaults to " << upgrade_->executable_path
+             << " in waves of " << upgrade_->wave_size;
+  StartUpgradeWave();
+}
+
 void ProcessManager::StartProcess(std::vector<Child>::iterator itr) {
   if (itr->status != ProcessStatus::kBeforeStarted) {
     LOG(kError) << "Process has already been started.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::already_initialised));
   }
 
-  std::vector<std::string> args{1, kVaultExecutablePath_.string()};
+  std::vector<std::string> args{1, itr->executable_path.string()};
   args.emplace_back(std::to_string(kListeningPort_));
   args.emplace_back("--log_folder " + (itr->info.vault_dir / "logs").string());
   args.insert(std::end(args), std::begin(itr->process_args), std::end(itr->process_args));
 
   NonEmptyString label{itr->info.label};
-  itr->process = bp::execute(bp::initializers::run_exe(kVaultExecutablePath_),
+#ifndef MAIDSAFE_WIN32
+  int pipe_fds[2] = {-1, -1};
+  if (kCaptureOutput_ && !CreateOutputPipe(pipe_fds)) {
+    LOG(kWarning) << "Failed to create pipe for output of vault " << hex::Encode(label) << ": "
+                  << std::error_code(errno, std::generic_category()).message();
+    pipe_fds[0] = pipe_fds[1] = -1;
+  }
+  // Our copy of the write end must be closed for the read end to see the vault's exit.
+  on_scope_exit close_pipe{[&pipe_fds] {
+    for (int fd : pipe_fds) {
+      if (fd != -1)
+        close(fd);
+    }
+  }};
+#endif
+  itr->process = bp::execute(bp::initializers::run_exe(itr->executable_path),
                              bp::initializers::set_cmd_line(process::ConstructCommandLine(args)),
 #ifndef MAIDSAFE_WIN32
                              bp::initializers::notify_io_service(io_service_),
+                             BindOutput(pipe_fds[1]),
 #endif
                              bp::initializers::throw_on_error(), bp::initializers::inherit_env());
+#ifndef MAIDSAFE_WIN32
+  if (pipe_fds[0] != -1) {
+    output_readers_[label] =
+        VaultOutputReader::MakeShared(io_service_, pipe_fds[0], OutputBuffer(label));
+    pipe_fds[0] = -1;
+  }
+#endif
 
   itr->status = ProcessStatus::kStarting;
+  itr->start_time = std::chrono::steady_clock::now();
+  NotifyVaultEvent(VaultEventType::kSpawned, label, GetProcessId(*itr));
 
 #ifdef MAIDSAFE_WIN32
   HANDLE copied_handle;
@@ -291,18 +599,206 @@ void ProcessManager::StartProcess(std::vector<Child>::iterator itr) {
   });
 #endif
 
-  itr->timer->expires_from_now(kRpcTimeout);
-  itr->timer->async_wait([this, label](const std::error_code& error_code) {
-    if (error_code) {
-      if (error_code != asio::error::operation_aborted)
-        LOG(kError) << "Error waiting for new process to connect via TCP: " << error_code.message();
-      return;
-    }
+  itr->timer = timing_wheel_.Arm(kRpcTimeout, [this, label] {
     LOG(kWarning) << "Timed out waiting for new process to connect via TCP.";
     OnProcessExit(label, -1, true);
   });
 }
 
+void ProcessManager::StartQueuedProcesses() {
+  std::vector<std::pair<std::shared_ptr<StartBatch>, std::pair<NonEmptyString, maidsafe_error>>>
+      failures;
+  auto itr(std::begin(vaults_));
+  while (itr != std::end(vaults_) && StartingCount(nullptr) < kMaxConcurrentStarts_) {
+    if (itr->status != ProcessStatus::kBeforeStarted ||
+        (itr->batch && itr->batch->max_concurrent_starts > 0 &&
+         StartingCount(itr->batch) >= itr->batch->max_concurrent_starts)) {
+      ++itr;
+      continue;
+    }
+    maidsafe_error error{MakeError(CommonErrors::unknown)};
+    try {
+      StartProcess(itr);
+      ++itr;
+      continue;
+    } catch (const maidsafe_error& e) {
+      LOG(kError) << "Failed to start queued vault: " << boost::diagnostic_information(e);
+      error = e;
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to start queued vault: " << boost::diagnostic_information(e);
+    }
+    failures.emplace_back(itr->batch, std::make_pair(itr->info.label, error));
+    itr = vaults_.erase(itr);
+  }
+
+  for (auto& failure : failures) {
+    if (failure.first && failure.first->on_start_failed)
+      failure.first->on_start_failed(failure.second.first, failure.second.second);
+  }
+}
+
+int ProcessManager::StartingCount(const std::shared_ptr<StartBatch>& batch) const {
+  return static_cast<int>(
+      std::count_if(std::begin(vaults_), std::end(vaults_), [&batch](const Child& vault) {
+        return vault.status == ProcessStatus::kStarting && (!batch || vault.batch == batch);
+      }));
+}
+
+void ProcessManager::ArmHeartbeatTimer(std::vector<Child>::iterator itr) {
+  if (kHeartbeatInterval_ <= std::chrono::milliseconds(0))
+    return;
+  NonEmptyString label{itr->info.label};
+  itr->heartbeat_timer =
+      timing_wheel_.Arm(kHeartbeatInterval_, [this, label] { OnHeartbeatInterval(label); });
+}
+
+void ProcessManager::OnHeartbeatInterval(const NonEmptyString& label) {
+  auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
+                        [&label](const Child& vault) { return vault.info.label == label; }));
+  if (itr == std::end(vaults_) || itr->status != ProcessStatus::kRunning)
+    return;
+  if (!itr->heartbeat_monitor.OnIntervalElapsed())
+    return ArmHeartbeatTimer(itr);
+
+  LOG(kError) << "Vault " << label << " has missed " << itr->heartbeat_monitor.MissedCount()
+              << " heartbeats; treating it as hung.";
+  OnProcessExit(label, -1, true);
+}
+
+void ProcessManager::RemoveQueuedProcesses() {
+  vaults_.erase(std::remove_if(std::begin(vaults_), std::end(vaults_),
+                               [](const Child& vault) {
+                                 return vault.status == ProcessStatus::kBeforeStarted;
+                               }),
+                std::end(vaults_));
+}
+
+fs::path ProcessManager::ExecutablePath(const NonEmptyString& label) const {
+  if (upgrade_ && upgrade_->upgraded.count(label) != 0U)
+    return upgrade_->executable_path;
+  return vault_executable_path_;
+}
+
+ProcessManager::Child ProcessManager::MakeChild(VaultInfo info, int restart_count) const {
+  fs::path executable_path{ExecutablePath(info.label)};
+#ifdef MAIDSAFE_WIN32
+  return Child{std::move(info), io_service_, restart_count, std::move(executable_path)};
+#else
+  return Child{std::move(info), restart_count, std::move(executable_path)};
+#endif
+}
+
+void ProcessManager::StartUpgradeWave() {
+  upgrade_->wave.clear();
+  // Vaults which are mid-start can't be stopped yet, so are deferred to a later wave.
+  bool deferred{false};
+  for (std::size_t count(upgrade_->pending.size());
+       count != 0 && upgrade_->wave.size() < upgrade_->wave_size; --count) {
+    NonEmptyString label{upgrade_->pending.front()};
+    upgrade_->pending.pop_front();
+    auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
+                          [&label](const Child& vault) { return vault.info.label == label; }));
+    if (itr == std::end(vaults_) || itr->status == ProcessStatus::kStopping)
+      continue;
+    if (itr->status == ProcessStatus::kStarting) {
+      upgrade_->pending.push_back(label);
+      deferred = true;
+      continue;
+    }
+    upgrade_->upgraded.insert(label);
+    if (itr->status == ProcessStatus::kBeforeStarted) {
+      itr->executable_path = upgrade_->executable_path;
+      continue;
+    }
+    upgrade_->wave.insert(label);
+    VaultInfo vault_info{itr->info};
+    vault_info.tcp_connection.reset();
+    int restart_count{itr->restart_count};
+    StopProcess(itr->info.tcp_connection,
+                [this, vault_info, restart_count](maidsafe_error /*error*/, int /*exit_code*/) {
+                  RestartStoppedVault(vault_info, restart_count);
+                });
+  }
+
+  if (!upgrade_->wave.empty()) {
+    LOG(kInfo) << "Upgrading wave of " << upgrade_->wave.size() << " vaults.";
+    upgrade_->timer = timing_wheel_.Arm(upgrade_->wave_timeout, [this] {
+      LOG(kError) << "Timed out waiting for upgraded vaults to join the network.";
+      RollBackUpgrade(MakeError(VaultManagerErrors::timed_out));
+    });
+  } else if (deferred) {
+    upgrade_->timer = timing_wheel_.Arm(kRpcTimeout, [this] { StartUpgradeWave(); });
+  } else {
+    LOG(kSuccess) << "All vaults upgraded to " << upgrade_->executable_path;
+    std::unique_ptr<Upgrade> upgrade(std::move(upgrade_));
+    vault_executable_path_ = upgrade->executable_path;
+    if (upgrade->on_done)
+      upgrade->on_done(MakeError(CommonErrors::success));
+  }
+}
+
+void ProcessManager::RestartStoppedVault(VaultInfo vault_info, int restart_count) {
+  try {
+    return AddProcess(vault_info, restart_count);
+  } catch (const maidsafe_error& error) {
+    LOG(kError) << "Failed to restart vault " << hex::Encode(vault_info.label) << ": "
+                << boost::diagnostic_information(error);
+    if (!upgrade_ || upgrade_->wave.count(vault_info.label) == 0U)
+      return;
+    RollBackUpgrade(error);
+  }
+  try {
+    AddProcess(std::move(vault_info), restart_count);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Failed to restart vault on previous executable: "
+                << boost::diagnostic_information(e);
+  }
+}
+
+void ProcessManager::AbandonUpgrade() {
+  if (!upgrade_)
+    return;
+  upgrade_->timer.Cancel();
+  std::unique_ptr<Upgrade> upgrade(std::move(upgrade_));
+  // Vaults of the current wave mustn't be restarted once they've stopped.
+  for (auto& vault : vaults_) {
+    if (upgrade->wave.count(vault.info.label) != 0U)
+      vault.on_exit = nullptr;
+  }
+  if (upgrade->on_done)
+    upgrade->on_done(MakeError(CommonErrors::unable_to_handle_request));
+}
+
+void ProcessManager::RollBackUpgrade(const maidsafe_error& error) {
+  if (!upgrade_)
+    return;
+  LOG(kError) << "Rolling back upgrade to " << upgrade_->executable_path << ": " << error.what();
+  upgrade_->timer.Cancel();
+  // Once 'upgrade_' is reset, all vaults are (re)started using the previous executable.
+  std::unique_ptr<Upgrade> upgrade(std::move(upgrade_));
+  for (const auto& label : upgrade->upgraded) {
+    auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
+                          [&label](const Child& vault) { return vault.info.label == label; }));
+    if (itr == std::end(vaults_) || itr->executable_path != upgrade->executable_path)
+      continue;
+    if (itr->status == ProcessStatus::kBeforeStarted) {
+      itr->executable_path = vault_executable_path_;
+    } else if (itr->status == ProcessStatus::kStarting) {
+      OnProcessExit(label, -1, true);
+    } else if (itr->status == ProcessStatus::kRunning) {
+      VaultInfo vault_info{itr->info};
+      vault_info.tcp_connection.reset();
+      int restart_count{itr->restart_count};
+      StopProcess(itr->info.tcp_connection,
+                  [this, vault_info, restart_count](maidsafe_error /*error*/, int /*exit_code*/) {
+                    RestartStoppedVault(vault_info, restart_count);
+                  });
+    }
+  }
+  if (upgrade->on_done)
+    upgrade->on_done(error);
+}
+
 void ProcessManager::InitSignalHandler() {
 #ifndef MAIDSAFE_WIN32
   signal_set_.async_wait([this](const std::error_code& error_code, int signum) {
@@ -344,6 +840,58 @@ void ProcessManager::InitSignalHandler() {
 #endif
 }
 
+#ifndef MAIDSAFE_WIN32
+void ProcessManager::StopWatchingExits() {
+  std::error_code ignored_ec;
+  signal_set_.cancel(ignored_ec);
+  watching_exits_ = false;
+  // Vaults which are stopping would otherwise only be reaped by their stop timers.
+  std::vector<NonEmptyString> labels;
+  for (const auto& vault : vaults_)
+    labels.push_back(vault.info.label);
+  for (const auto& label : labels)
+    PollForExit(label);
+}
+
+void ProcessManager::PollForExit(const NonEmptyString& label) {
+  auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
+                        [&label](const Child& vault) { return vault.info.label == label; }));
+  if (itr == std::end(vaults_) || itr->status != ProcessStatus::kStopping)
+    return;
+  int exit_code{0};
+  if (HasExited(*itr, exit_code))
+    return OnProcessExit(label, exit_code);
+  itr->exit_poll_timer.Cancel();
+  itr->exit_poll_timer =
+      timing_wheel_.Arm(kVaultExitPollInterval, [this, label] { PollForExit(label); });
+}
+
+// Only to be used for an adopted vault, or once SIGCHLD is no longer watched, since otherwise this
+// could reap a child before the signal handler's wait.  The exit code of an adopted vault is
+// unknown, so is left unchanged.
+bool ProcessManager::HasExited(const Child& vault, int& exit_code) const {
+  if (vault.adopted)
+    return !IsRunning(vault);
+  const pid_t kProcessId{static_cast<pid_t>(GetProcessId(vault))};
+  int status{0};
+  const pid_t kResult{waitpid(kProcessId, &status, WNOHANG)};
+  if (kResult == 0)
+    return false;
+  if (kResult == kProcessId) {
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+    exit_code = BOOST_PROCESS_EXITSTATUS(status);
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+  }
+  // Otherwise the vault is no longer a child which can be waited for.
+  return true;
+}
+#endif
+
 void ProcessManager::StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on_exit_functor) {
   auto itr(std::begin(vaults_));
   try {
@@ -354,23 +902,69 @@ void ProcessManager::StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on
   }
   itr->on_exit = on_exit_functor;
   itr->status = ProcessStatus::kStopping;
-  Send(itr->info.tcp_connection, VaultShutdownRequest());
+  itr->stop_stage = StopStage::kDraining;
+  itr->heartbeat_timer.Cancel();
+  Send(itr->info.tcp_connection, VaultShutdownRequest(kDrainTimeout_));
   NonEmptyString label{itr->info.label};
-  itr->timer->expires_from_now(kVaultStopTimeout);
-  itr->timer->async_wait([this, label](const std::error_code& error_code) {
-    if (error_code) {
-      if (error_code != asio::error::operation_aborted)
-        LOG(kError) << "Error waiting for Vault to stop: " << error_code.message();
+  itr->timer.Cancel();
+  itr->timer = timing_wheel_.Arm(kDrainTimeout_, [this, label] { OnStopTimeout(label); });
+}
+
+void ProcessManager::HandleDrainProgress(tcp::ConnectionPtr connection, std::uint64_t remaining) {
+  auto itr(DoFind(connection));
+  if (itr->status == ProcessStatus::kStopping)
+    LOG(kVerbose) << "Vault " << hex::Encode(itr->info.label) << " draining: " << remaining
+                  << " remaining.";
+}
+
+void ProcessManager::HandleDrained(tcp::ConnectionPtr connection) {
+  auto itr(DoFind(connection));
+  if (itr->status != ProcessStatus::kStopping || itr->stop_stage != StopStage::kDraining)
+    return;
+  LOG(kInfo) << "Vault " << hex::Encode(itr->info.label) << " has drained.";
+  itr->stop_stage = StopStage::kDrained;
+  NonEmptyString label{itr->info.label};
+  itr->timer.Cancel();
+  itr->timer = timing_wheel_.Arm(kVaultStopTimeout, [this, label] { OnStopTimeout(label); });
+}
+
+void ProcessManager::OnStopTimeout(const NonEmptyString& label) {
+  auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
+                        [&label](const Child& vault) { return vault.info.label == label; }));
+  if (itr == std::end(vaults_) || itr->status != ProcessStatus::kStopping)
+    return;
+#ifndef MAIDSAFE_WIN32
+  int exit_code{0};
+  if ((!watching_exits_ || itr->adopted) && HasExited(*itr, exit_code))
+    return OnProcessExit(label, exit_code);
+  if (itr->stop_stage != StopStage::kTerminating && IsRunning(*itr)) {
+    LOG(kWarning) << "Timed out waiting for Vault to stop; sending SIGTERM.";
+    itr->stop_stage = StopStage::kTerminating;
+    if (kill(static_cast<pid_t>(GetProcessId(*itr)), SIGTERM) == 0) {
+      itr->timer = timing_wheel_.Arm(kVaultTerminateTimeout,
+                                     [this, label] { OnStopTimeout(label); });
       return;
     }
-    LOG(kWarning) << "Timed out waiting for Vault to stop; terminating now.";
-    OnProcessExit(label, -1, true);
-  });
+  }
+#endif
+  LOG(kWarning) << "Timed out waiting for Vault to stop; terminating now.";
+  OnProcessExit(label, -1, true);
 }
 
 bool ProcessManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
   try {
-    OnProcessExit(DoFind(connection)->info.label, -1, true);
+    auto itr(DoFind(connection));
+    // A stopping vault closes its connection as it exits; leave its exit to be reported normally,
+    // with the stop timer as a backstop.  An adopted vault's exit is never reported via SIGCHLD, so
+    // is polled for instead.
+    if (itr->status == ProcessStatus::kStopping) {
+#ifndef MAIDSAFE_WIN32
+      if (itr->adopted)
+        PollForExit(itr->info.label);
+#endif
+      return true;
+    }
+    OnProcessExit(itr->info.label, -1, true);
   } catch (const maidsafe_error& error) {
     if (error.code() == make_error_code(CommonErrors::no_such_element))
       return false;
@@ -381,6 +975,24 @@ bool ProcessManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
 
 VaultInfo ProcessManager::Find(const NonEmptyString& label) const { return DoFind(label)->info; }
 
+VaultOutput ProcessManager::TailOutput(const NonEmptyString& label, std::uint64_t cursor,
+                                       std::size_t max_size) const {
+  auto itr(outputs_.find(label));
+  if (itr != std::end(outputs_))
+    return itr->second->Read(cursor, max_size);
+  DoFind(label);
+  return VaultOutput();
+}
+
+std::shared_ptr<VaultOutputBuffer> ProcessManager::OutputBuffer(const NonEmptyString& label) {
+  auto itr(outputs_.find(label));
+  if (itr == std::end(outputs_)) {
+    itr = outputs_.emplace(label, std::make_shared<VaultOutputBuffer>(kVaultOutputBufferSize))
+              .first;
+  }
+  return itr->second;
+}
+
 std::vector<ProcessManager::Child>::const_iterator ProcessManager::DoFind(
     const NonEmptyString& label) const {
   auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
@@ -457,7 +1069,11 @@ void ProcessManager::OnProcessExit(const NonEmptyString& label, int exit_code, b
 
   VaultInfo vault_info;
   int restart_count{-1};
-  if (child_itr->status != ProcessStatus::kStopping) {  // Unexpected exit - try to restart.
+  // 'label' may refer to the erased child's own label, so take a copy for reporting the exit.
+  const NonEmptyString kLabel{child_itr->info.label};
+  const ProcessId kProcessId{GetProcessId(*child_itr)};
+  const bool kWasStopping{child_itr->status == ProcessStatus::kStopping};
+  if (!kWasStopping) {  // Unexpected exit - try to restart.
     restart_count = child_itr->restart_count;
     vault_info = child_itr->info;
     LOG(kError) << "Vault " << vault_info.pmid_and_signer->first.name() << " stopped unexpectedly";
@@ -480,10 +1096,33 @@ void ProcessManager::OnProcessExit(const NonEmptyString& label, int exit_code, b
     child_itr->info.tcp_connection->Close();
 
   OnExitFunctor on_exit{child_itr->on_exit};
+  child_itr->timer.Cancel();
+  child_itr->heartbeat_timer.Cancel();
+  child_itr->exit_poll_timer.Cancel();
+  const bool kFailedUpgrade{upgrade_ && !kWasStopping && upgrade_->wave.count(kLabel) != 0U &&
+                            child_itr->executable_path == upgrade_->executable_path};
+#ifndef MAIDSAFE_WIN32
+  auto reader_itr(output_readers_.find(kLabel));
+  if (reader_itr != std::end(output_readers_)) {
+    if (!kWasStopping || terminate || exit_code != 0) {
+      reader_itr->second->PersistTailOnClose(
+          child_itr->info.vault_dir / "logs" /
+              ("output_" + std::to_string(std::time(nullptr)) + ".log"),
+          kPersistedVaultOutputSize);
+    }
+    output_readers_.erase(reader_itr);
+  }
+#endif
   vaults_.erase(child_itr);
 
+  NotifyVaultEvent(VaultEventType::kExited, kLabel, kProcessId, terminate ? -1 : exit_code);
+  if (kFailedUpgrade)
+    RollBackUpgrade(MakeError(VaultManagerErrors::vault_exited_with_error));
+  if (kWasStopping)
+    NotifyVaultEvent(VaultEventType::kStopped, kLabel, kProcessId);
   InvokeOnExitFunctor(on_exit, exit_code, terminate);
-  RestartIfRequired(restart_count, std::move(vault_info));
+  RestartIfRequired(restart_count, std::move(vault_info), kProcessId);
+  StartQueuedProcesses();
 }
 
 void ProcessManager::TerminateProcess(std::vector<Child>::iterator itr) {
@@ -511,11 +1150,13 @@ void ProcessManager::InvokeOnExitFunctor(OnExitFunctor on_exit, int exit_code, b
   }
 }
 
-void ProcessManager::RestartIfRequired(int restart_count, VaultInfo vault_info) {
+void ProcessManager::RestartIfRequired(int restart_count, VaultInfo vault_info,
+                                       ProcessId exited_process_id) {
   if (restart_count < 0 || restart_count >= kMaxVaultRestarts)
     return;
 
   LOG(kWarning) << "Restarting vault " << vault_info.label;
+  NotifyVaultEvent(VaultEventType::kRestarting, vault_info.label, exited_process_id);
   io_service_.post([vault_info, restart_count, this] {
     try {
       AddProcess(std::move(vault_info), restart_count + 1);
@@ -525,6 +1166,22 @@ void ProcessManager::RestartIfRequired(int restart_count, VaultInfo vault_info)
   });
 }
 
+void ProcessManager::NotifyVaultEvent(VaultEventType type, const NonEmptyString& label,
+                                      ProcessId process_id, int exit_code) const {
+  if (!kOnVaultEvent_)
+    return;
+  VaultEvent event;
+  event.type = type;
+  event.label = label;
+  event.process_id = process_id;
+  event.exit_code = exit_code;
+  try {
+    kOnVaultEvent_(std::move(event));
+  } catch (const std::exception& e) {
+    LOG(kError) << "Error executing on_vault_event functor: " << boost::diagnostic_information(e);
+  }
+}
+
 }  // namespace vault_manager
 
 }  // namespace maidsafe
@@ -19,11 +19,19 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_PROCESS_MANAGER_H_
 #define MAIDSAFE_VAULT_MANAGER_PROCESS_MANAGER_H_
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <future>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "asio/io_service.hpp"
@@ -42,7 +50,13 @@
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/heartbeat_monitor.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
+#include "maidsafe/vault_manager/vault_event.h"
 #include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/vault_output.h"
+#include "maidsafe/vault_manager/vault_output_buffer.h"
+#include "maidsafe/vault_manager/vault_status.h"
 
 namespace maidsafe {
 
@@ -50,12 +64,14 @@ namespace vault_manager {
 
 typedef uint64_t ProcessId;
 
-enum class ProcessStatus { kBeforeStarted, kStarting, kRunning, kStopping };
-
 // All functions provide the strong exception guarantee.
 class ProcessManager {
  public:
   typedef std::function<void(maidsafe_error, int)> OnExitFunctor;
+  typedef std::function<void(const NonEmptyString&, maidsafe_error)> OnStartFailedFunctor;
+  // Invoked for each lifecycle change of a vault process.  The event's sequence number is unset.
+  typedef std::function<void(VaultEvent)> OnVaultEventFunctor;
+  typedef std::function<void(maidsafe_error)> OnUpgradeDoneFunctor;
 
   ProcessManager(const ProcessManager&) = delete;
   ProcessManager(ProcessManager&&) = delete;
@@ -63,35 +79,135 @@ class ProcessManager {
 
   static std::shared_ptr<ProcessManager> MakeShared(asio::io_service& io_service,
                                                     boost::filesystem::path vault_executable_path,
-                                                    tcp::Port listening_port);
+                                                    tcp::Port listening_port,
+                                                    int max_concurrent_starts =
+                                                        kMaxConcurrentVaultStarts,
+                                                    OnVaultEventFunctor on_vault_event = nullptr,
+                                                    std::chrono::milliseconds heartbeat_interval =
+                                                        kHeartbeatInterval,
+                                                    int heartbeat_miss_threshold =
+                                                        kHeartbeatMissThreshold,
+                                                    std::chrono::milliseconds drain_timeout =
+                                                        kVaultDrainTimeout,
+                                                    bool capture_output = true);
   ~ProcessManager();
   void StopAll();
   void StopAllWithInterval();
+  // Stops supervising the running vaults without stopping them, so that they can reconnect to and
+  // be adopted by a later VaultManager.  Vaults which haven't yet connected are terminated.
+  // Unsupported on Windows, where this is equivalent to StopAll.  The output of a released vault is
+  // no longer captured.
+  void ReleaseAll();
   std::vector<VaultInfo> GetAll() const;
+  // Built from in-memory state only, so is cheap enough to be called frequently.
+  std::vector<VaultStatus> GetStatuses() const;
   void AddProcess(VaultInfo info, int restart_count = 0);
+  // Supervises the vault running as 'process_id', which was started by a previous VaultManager.
+  // The vault must reconnect and send VaultStarted within kVaultAdoptTimeout, or it's terminated
+  // and restarted.  Returns false without adopting if 'process_id' isn't running as this vault (or
+  // can't be adopted on this platform), in which case the vault should be added instead.
+  bool AdoptProcess(VaultInfo info, ProcessId process_id);
+  // Queues the vaults and starts as many as allowed.  No more than 'max_concurrent_starts' of this
+  // batch (if non-zero) and no more than the manager-wide limit will be waiting to connect at any
+  // time.  'on_start_failed' is invoked for each vault rejected or failing to start; this can be
+  // from within this call or later.
+  void AddProcesses(std::vector<VaultInfo> infos, int max_concurrent_starts,
+                    OnStartFailedFunctor on_start_failed);
   VaultInfo HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id);
+  VaultInfo HandleJoinedNetwork(tcp::ConnectionPtr connection);
+  void HandleHeartbeat(tcp::ConnectionPtr connection, std::uint64_t progress);
   void AssignOwner(const NonEmptyString& label, const Identity& owner_name,
                    DiskUsage max_disk_usage);
+  void SetVaultDir(const NonEmptyString& label, const boost::filesystem::path& vault_dir);
+  // Restarts the running vaults onto 'new_executable_path' in waves of up to 'wave_size'.  Each
+  // wave begins once every vault of the previous one has sent JoinedNetwork.  If a vault of the
+  // current wave fails to start or exits unexpectedly, or the wave hasn't joined within
+  // 'wave_timeout', all vaults upgraded so far are restarted on the previous executable.
+  // 'on_done' is invoked with success once every vault has been upgraded, after which vaults are
+  // always started using the new executable, or with the error which triggered a rollback.
+  void UpgradeVaults(boost::filesystem::path new_executable_path, int wave_size,
+                     std::chrono::steady_clock::duration wave_timeout,
+                     OnUpgradeDoneFunctor on_done);
+  // Asks the vault to drain and exit within the drain timeout.  Once that expires the vault is sent
+  // SIGTERM (except on Windows), and if it still hasn't exited kVaultTerminateTimeout later, it's
+  // killed.
   void StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on_exit_functor = nullptr);
+  void HandleDrainProgress(tcp::ConnectionPtr connection, std::uint64_t remaining);
+  // The vault has finished draining, so should exit within kVaultStopTimeout.
+  void HandleDrained(tcp::ConnectionPtr connection);
   // Returns false if the process doesn't exist.
   bool HandleConnectionClosed(tcp::ConnectionPtr connection);
   VaultInfo Find(const NonEmptyString& label) const;
   VaultInfo Find(tcp::ConnectionPtr connection) const;
+  // Returns up to 'max_size' bytes of the vault's console output from 'cursor'.  The output is kept
+  // across restarts of the vault, and is empty on Windows or if output isn't being captured.
+  VaultOutput TailOutput(const NonEmptyString& label, std::uint64_t cursor,
+                         std::size_t max_size) const;
 
  private:
   ProcessManager(asio::io_service& io_service, boost::filesystem::path vault_executable_path,
-                 tcp::Port listening_port);
+                 tcp::Port listening_port, int max_concurrent_starts,
+                 OnVaultEventFunctor on_vault_event, std::chrono::milliseconds heartbeat_interval,
+                 int heartbeat_miss_threshold, std::chrono::milliseconds drain_timeout,
+                 bool capture_output);
+
+  struct StartBatch {
+    StartBatch(int max_concurrent_starts_in, OnStartFailedFunctor on_start_failed_in)
+        : max_concurrent_starts(max_concurrent_starts_in),
+          on_start_failed(std::move(on_start_failed_in)) {}
+    const int max_concurrent_starts;
+    const OnStartFailedFunctor on_start_failed;
+  };
+
+  struct Upgrade {
+    Upgrade(boost::filesystem::path executable_path_in, int wave_size_in,
+            std::chrono::steady_clock::duration wave_timeout_in, OnUpgradeDoneFunctor on_done_in)
+        : executable_path(std::move(executable_path_in)),
+          wave_size(static_cast<std::size_t>(std::max(wave_size_in, 1))),
+          wave_timeout(wave_timeout_in),
+          on_done(std::move(on_done_in)),
+          pending(),
+          upgraded(),
+          wave(),
+          timer() {}
+    const boost::filesystem::path executable_path;
+    const std::size_t wave_size;
+    const std::chrono::steady_clock::duration wave_timeout;
+    OnUpgradeDoneFunctor on_done;
+    // Labels of vaults not yet upgraded, those which have been (including the current wave), and
+    // those of the current wave which haven't yet joined the network.
+    std::deque<NonEmptyString> pending;
+    std::set<NonEmptyString> upgraded, wave;
+    TimingWheel::Handle timer;
+  };
+
+  // How far a stopping vault has got.
+  enum class StopStage { kDraining, kDrained, kTerminating };
 
   struct Child {
-    Child(VaultInfo info, asio::io_service& io_service, int restarts);
+#ifdef MAIDSAFE_WIN32
+    Child(VaultInfo info, asio::io_service& io_service, int restarts,
+          boost::filesystem::path executable_path_in);
+#else
+    Child(VaultInfo info, int restarts, boost::filesystem::path executable_path_in);
+#endif
     Child(Child&& other);
     Child& operator=(Child other);
     VaultInfo info;
+    boost::filesystem::path executable_path;
     OnExitFunctor on_exit;
-    std::unique_ptr<Timer> timer;
+    TimingWheel::Handle timer;
+    HeartbeatMonitor heartbeat_monitor;
+    TimingWheel::Handle heartbeat_timer;
+    TimingWheel::Handle exit_poll_timer;
     int restart_count;
     std::vector<std::string> process_args;
     ProcessStatus status;
+    StopStage stop_stage;
+    std::chrono::steady_clock::time_point start_time;
+    std::shared_ptr<StartBatch> batch;
+    // Started by a previous VaultManager, so isn't our child.
+    bool adopted;
 #ifdef MAIDSAFE_WIN32
     asio::windows::object_handle handle;
 #endif
@@ -103,7 +219,25 @@ class ProcessManager {
   friend void swap(Child& lhs, Child& rhs);
 
   void StartProcess(std::vector<Child>::iterator itr);
+  void StartQueuedProcesses();
+  int StartingCount(const std::shared_ptr<StartBatch>& batch) const;
+  void ArmHeartbeatTimer(std::vector<Child>::iterator itr);
+  void OnHeartbeatInterval(const NonEmptyString& label);
+  void OnStopTimeout(const NonEmptyString& label);
+  void RemoveQueuedProcesses();
+  boost::filesystem::path ExecutablePath(const NonEmptyString& label) const;
+  Child MakeChild(VaultInfo info, int restart_count) const;
+  void StartUpgradeWave();
+  void RestartStoppedVault(VaultInfo vault_info, int restart_count);
+  void RollBackUpgrade(const maidsafe_error& error);
+  void AbandonUpgrade();
   void InitSignalHandler();
+#ifndef MAIDSAFE_WIN32
+  void StopWatchingExits();
+  void PollForExit(const NonEmptyString& label);
+  bool HasExited(const Child& vault, int& exit_code) const;
+#endif
+  std::shared_ptr<VaultOutputBuffer> OutputBuffer(const NonEmptyString& label);
 
   std::vector<Child>::const_iterator DoFind(const NonEmptyString& label) const;
   std::vector<Child>::iterator DoFind(const NonEmptyString& label);
@@ -114,16 +248,34 @@ class ProcessManager {
   void OnProcessExit(const NonEmptyString& label, int exit_code, bool terminate = false);
   void TerminateProcess(std::vector<Child>::iterator itr);
   void InvokeOnExitFunctor(OnExitFunctor on_exit, int exit_code, bool terminate);
-  void RestartIfRequired(int restart_count, VaultInfo vault_info);
+  void RestartIfRequired(int restart_count, VaultInfo vault_info, ProcessId exited_process_id);
+  void NotifyVaultEvent(VaultEventType type, const NonEmptyString& label, ProcessId process_id,
+                        int exit_code = 0) const;
 
   asio::io_service& io_service_;
+  TimingWheel& timing_wheel_;
 #ifndef MAIDSAFE_WIN32
   asio::signal_set signal_set_;
+  // False once SIGCHLD is no longer watched, after which exits are detected by polling.
+  bool watching_exits_;
 #endif
   std::once_flag stop_all_flag_;
   const tcp::Port kListeningPort_;
-  const boost::filesystem::path kVaultExecutablePath_;
+  const int kMaxConcurrentStarts_;
+  boost::filesystem::path vault_executable_path_;
+  const OnVaultEventFunctor kOnVaultEvent_;
+  const std::chrono::milliseconds kHeartbeatInterval_;
+  const int kHeartbeatMissThreshold_;
+  const std::chrono::milliseconds kDrainTimeout_;
+  const bool kCaptureOutput_;
   std::vector<Child> vaults_;
+  // Keyed by vault label.  The buffers outlive the vaults' processes, so the output leading up to
+  // an unexpected exit is still available after the vault is restarted.
+  std::map<NonEmptyString, std::shared_ptr<VaultOutputBuffer>> outputs_;
+#ifndef MAIDSAFE_WIN32
+  std::map<NonEmptyString, std::shared_ptr<VaultOutputReader>> output_readers_;
+#endif
+  std::unique_ptr<Upgrade> upgrade_;
 };
 
 }  // namespace vault_manager
@@ -24,16 +24,17 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 
-#include "asio/error.hpp"
 #include "asio/io_service.hpp"
-#include "asio/steady_timer.hpp"
 #include "boost/exception/diagnostic_information.hpp"
 
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/handler_guard.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 #include "maidsafe/vault_manager/utils.h"
 
 namespace maidsafe {
@@ -42,69 +43,119 @@ namespace vault_manager {
 
 namespace detail {
 
-template <typename ResultType, typename MessageType>
-struct PromiseAndTimer {
-  PromiseAndTimer(asio::io_service& io_service,
-                  const std::chrono::steady_clock::duration& timeout = kRpcTimeout)
-      : promise(), timer(io_service, timeout), once_flag() {}
+// Holds the completion handler of an outstanding request along with the deadline for its response.
+// The handler is invoked at most once, either with the result or with an error.
+template <typename ResultType>
+struct HandlerAndTimer {
+  typedef std::function<void(maidsafe_error, ResultType)> Handler;
 
-  void SetValue(ResultType&& result) {
-    std::call_once(once_flag, [&] { this->promise.set_value(std::move(result)); });
+  HandlerAndTimer(asio::io_service& io_service, Handler handler_in,
+                  const std::chrono::steady_clock::duration& timeout_in = kRpcTimeout)
+      : handler(std::move(handler_in)), timing_wheel(TimingWheel::Get(io_service)),
+        timeout(timeout_in), timer(), on_expiry(), once_flag() {}
+
+  void ArmTimer(TimingWheel::Functor on_expiry_in) {
+    on_expiry = std::move(on_expiry_in);
+    timer = timing_wheel.Arm(timeout, on_expiry);
   }
 
-  void SetException(std::exception_ptr exception) {
-    std::call_once(once_flag, [&] { this->promise.set_exception(exception); });
+  // Moves the deadline to 'new_timeout' from now.  Must follow ArmTimer.
+  void RearmTimer(const std::chrono::steady_clock::duration& new_timeout) {
+    timer.Cancel();
+    timer = timing_wheel.Arm(new_timeout, on_expiry);
   }
 
-  void SetException(maidsafe_error error) {
-    std::call_once(once_flag, [&] { this->promise.set_exception(std::make_exception_ptr(error)); });
+  void SetValue(ResultType&& result) {
+    std::call_once(once_flag,
+                   [&] { this->Invoke(MakeError(CommonErrors::success), std::move(result)); });
   }
 
-  void SetException(std::error_code error_code) {
-    std::call_once(once_flag, [&] {
-      this->promise.set_exception(std::make_exception_ptr(std::system_error(error_code)));
-    });
+  void SetError(maidsafe_error error) {
+    std::call_once(once_flag, [&] { this->Invoke(std::move(error), ResultType()); });
   }
 
-  std::promise<ResultType> promise;
-  Timer timer;
+  Handler handler;
+  TimingWheel& timing_wheel;
+  const std::chrono::steady_clock::duration timeout;
+  TimingWheel::Handle timer;
+  TimingWheel::Functor on_expiry;
   std::once_flag once_flag;
+
+ private:
+  void Invoke(maidsafe_error error, ResultType result) {
+    if (!handler)
+      return;
+    try {
+      handler(std::move(error), std::move(result));
+    } catch (const std::exception& e) {
+      LOG(kError) << "Error executing completion handler: " << boost::diagnostic_information(e);
+    } catch (...) {
+      LOG(kError) << "Unknown error type while executing completion handler.";
+    }
+  }
 };
 
+// Returns a completion handler which fulfils 'promise'.
+template <typename ResultType>
+std::function<void(maidsafe_error, ResultType)> MakePromiseHandler(
+    std::shared_ptr<std::promise<ResultType>> promise) {
+  return [promise](maidsafe_error error, ResultType result) {
+    if (error.code() == make_error_code(CommonErrors::success))
+      promise->set_value(std::move(result));
+    else
+      promise->set_exception(std::make_exception_ptr(error));
+  };
+}
+
 }  // namespace detail
 
+// Chains a handler for the next 'MessageType' onto 'callback'.  'handler' is invoked with the value
+// extracted from that message, or with VaultManagerErrors::timed_out if none arrives within
+// kRpcTimeout.  It is never invoked while 'mutex' is held.  If 'io_service' can outlive 'callback'
+// and 'mutex', their owner's 'guard' must be provided.
 template <typename ResultType, typename MessageType>
-std::future<ResultType> SetResponseCallback(std::function<void(MessageType&&)>& callback,
-                                            asio::io_service& io_service, std::mutex& mutex) {
-  auto promise_and_timer =
-      std::make_shared<detail::PromiseAndTimer<ResultType, MessageType>>(io_service);
-  {
-    std::lock_guard<std::mutex> lock{mutex};
-    auto callback_copy(callback);
-    callback = [=](MessageType&& message) {
-      try {
-        promise_and_timer->SetValue(detail::GetValue(message));
-      } catch (const std::exception& e) {
-        LOG(kError) << boost::diagnostic_information(e);
-        promise_and_timer->SetException(std::current_exception());
-      }
-      if (callback_copy)
-        callback_copy(std::move(message));
-      promise_and_timer->timer.cancel();
-    };
-  }
-  promise_and_timer->timer.async_wait([=, &callback, &mutex](const std::error_code& ec) {
-    if (ec && ec == asio::error::operation_aborted)
-      return;
-    std::lock_guard<std::mutex> lock{mutex};
-    if (callback)
-      callback = nullptr;
-    if (ec)
-      promise_and_timer->SetException(ec);
-    else
-      promise_and_timer->SetException(MakeError(VaultManagerErrors::timed_out));
-  });
-  return promise_and_timer->promise.get_future();
+void SetResponseCallback(std::function<void(MessageType&&)>& callback,
+                         asio::io_service& io_service, std::mutex& mutex,
+                         std::function<void(maidsafe_error, ResultType)> handler,
+                         std::shared_ptr<HandlerGuard> guard = std::shared_ptr<HandlerGuard>()) {
+  auto handler_and_timer =
+      std::make_shared<detail::HandlerAndTimer<ResultType>>(io_service, std::move(handler));
+  std::lock_guard<std::mutex> lock{mutex};
+  TimingWheel::Functor on_expiry{[=, &callback, &mutex] {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (callback)
+        callback = nullptr;
+    }
+    handler_and_timer->SetError(MakeError(VaultManagerErrors::timed_out));
+  }};
+  handler_and_timer->ArmTimer(guard ? TimingWheel::Functor{Guard(guard, std::move(on_expiry))}
+                                    : std::move(on_expiry));
+  auto callback_copy(callback);
+  callback = [=](MessageType&& message) {
+    handler_and_timer->timer.Cancel();
+    try {
+      handler_and_timer->SetValue(detail::GetValue(message));
+    } catch (const maidsafe_error& error) {
+      LOG(kError) << boost::diagnostic_information(error);
+      handler_and_timer->SetError(error);
+    } catch (const std::exception& e) {
+      LOG(kError) << boost::diagnostic_information(e);
+      handler_and_timer->SetError(MakeError(CommonErrors::parsing_error));
+    }
+    if (callback_copy)
+      callback_copy(std::move(message));
+  };
+}
+
+template <typename ResultType, typename MessageType>
+std::future<ResultType> SetResponseCallback(
+    std::function<void(MessageType&&)>& callback, asio::io_service& io_service, std::mutex& mutex,
+    std::shared_ptr<HandlerGuard> guard = std::shared_ptr<HandlerGuard>()) {
+  auto promise(std::make_shared<std::promise<ResultType>>());
+  SetResponseCallback<ResultType, MessageType>(callback, io_service, mutex,
+                                               detail::MakePromiseHandler(promise), guard);
+  return promise->get_future();
 }
 
 }  // namespace vault_manager
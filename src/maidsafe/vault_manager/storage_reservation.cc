@@ -0,0 +1,105 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/storage_reservation.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/on_scope_exit.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+std::uint64_t ReservationSize(DiskUsage max_disk_usage, std::uint64_t bytes_used,
+                              double fraction) {
+  const auto kShare(
+      static_cast<std::uint64_t>(fraction * static_cast<double>(max_disk_usage.data)));
+  if (kShare <= bytes_used + kReservationGranularity)
+    return 0;
+  const std::uint64_t kUnused{kShare - bytes_used - kReservationGranularity};
+  return kUnused - (kUnused % kReservationGranularity);
+}
+
+std::uint64_t GetReservation(const fs::path& vault_dir) {
+  boost::system::error_code error_code;
+  const std::uintmax_t kSize{fs::file_size(vault_dir / kReservationFilename, error_code)};
+  return error_code ? 0 : static_cast<std::uint64_t>(kSize);
+}
+
+void SetReservation(const fs::path& vault_dir, std::uint64_t size) {
+  const fs::path kPath{vault_dir / kReservationFilename};
+  if (size == 0) {
+    boost::system::error_code error_code;
+    fs::remove(kPath, error_code);
+    if (error_code) {
+      LOG(kWarning) << "Failed to remove " << kPath << ": " << error_code.message();
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+    }
+    return;
+  }
+
+#ifdef __linux__
+  const int kFd{open(kPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600)};
+  if (kFd < 0) {
+    LOG(kWarning) << "Failed to open " << kPath << ": " << std::strerror(errno);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  on_scope_exit close_fd{[kFd] { close(kFd); }};
+  struct stat file_stat;
+  if (fstat(kFd, &file_stat) != 0) {
+    LOG(kWarning) << "Failed to stat " << kPath << ": " << std::strerror(errno);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  const auto kCurrentSize(static_cast<std::uint64_t>(file_stat.st_size));
+  // Unlike posix_fallocate, fallocate fails rather than falling back to writing zeros on
+  // filesystems which can't allocate blocks directly.
+  int result{0};
+  if (size < kCurrentSize)
+    result = ftruncate(kFd, static_cast<off_t>(size));
+  else if (size > kCurrentSize)
+    result = fallocate(kFd, 0, 0, static_cast<off_t>(size));
+  if (result != 0) {
+    LOG(kWarning) << "Failed to resize " << kPath << " to " << size
+                  << " bytes: " << std::strerror(errno);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+#else
+  LOG(kWarning) << "Storage reservations aren't supported on this platform.";
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+#endif
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
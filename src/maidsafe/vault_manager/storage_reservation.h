@@ -0,0 +1,54 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_STORAGE_RESERVATION_H_
+#define MAIDSAFE_VAULT_MANAGER_STORAGE_RESERVATION_H_
+
+#include <cstdint>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// A vault's reservation is a preallocated file (kReservationFilename) in its vault dir, holding the
+// part of 'fraction' of its disk usage limit which it hasn't yet used.  The file is shrunk as the
+// vault's usage grows, freeing contiguous extents for it which no other process can have taken.
+
+// Returns the reservation size for a vault, leaving at least kReservationGranularity of the
+// reserved share unreserved as headroom until the reservation is next shrunk.  The size is a
+// multiple of kReservationGranularity so that small changes in usage don't resize the file.  0 if
+// 'max_disk_usage' is 0 (unlimited).
+std::uint64_t ReservationSize(DiskUsage max_disk_usage, std::uint64_t bytes_used, double fraction);
+
+// Returns the size of the reservation file in 'vault_dir', or 0 if there is none.
+std::uint64_t GetReservation(const boost::filesystem::path& vault_dir);
+
+// Grows or shrinks the reservation file in 'vault_dir' to 'size' bytes, removing it if 'size' is 0.
+// Growing allocates the blocks rather than leaving the file sparse.  Throws if that can't be done
+// without writing the data, which is always the case other than on Linux.
+void SetReservation(const boost::filesystem::path& vault_dir, std::uint64_t size);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_STORAGE_RESERVATION_H_
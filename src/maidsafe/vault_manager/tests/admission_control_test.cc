@@ -0,0 +1,79 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/admission_control.h"
+
+#include <chrono>
+#include <thread>
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(AdmissionControlTest, BEH_ConnectionCaps) {
+  VaultManagerOptions options;
+  options.max_new_connections = 2;
+  options.max_unvalidated_clients = 1;
+  options.max_accepts_per_second = 0;
+  AdmissionControl admission_control{options};
+
+  EXPECT_TRUE(admission_control.AdmitNewConnection(0));
+  EXPECT_TRUE(admission_control.AdmitNewConnection(1));
+  EXPECT_FALSE(admission_control.AdmitNewConnection(2));
+  EXPECT_TRUE(admission_control.AdmitNewConnection(1));
+  EXPECT_TRUE(admission_control.AdmitUnvalidatedClient(0));
+  EXPECT_FALSE(admission_control.AdmitUnvalidatedClient(1));
+
+  AdmissionCounters counters{admission_control.GetCounters()};
+  EXPECT_EQ(3U, counters.accepted);
+  EXPECT_EQ(1U, counters.rejected_new_connections);
+  EXPECT_EQ(1U, counters.rejected_unvalidated_clients);
+  EXPECT_EQ(0U, counters.rejected_rate_limited);
+}
+
+TEST(AdmissionControlTest, BEH_AcceptRateLimit) {
+  VaultManagerOptions options;
+  options.max_accepts_per_second = 20;
+  options.accept_burst = 5;
+  AdmissionControl admission_control{options};
+
+  int admitted(0);
+  for (int i(0); i != 10; ++i) {
+    if (admission_control.AdmitNewConnection(0))
+      ++admitted;
+  }
+  // Allow for a token or so being refilled during the loop on a slow machine.
+  EXPECT_GE(admitted, 5);
+  EXPECT_LE(admitted, 6);
+  EXPECT_EQ(static_cast<std::uint64_t>(10 - admitted),
+            admission_control.GetCounters().rejected_rate_limited);
+
+  // At 20 per second, a token is available again after 50ms.
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_TRUE(admission_control.AdmitNewConnection(0));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -18,10 +18,18 @@
 
 #include "maidsafe/vault_manager/client_interface.h"
 
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+#include "boost/filesystem/operations.hpp"
 #include "boost/filesystem/path.hpp"
 
+#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
@@ -40,12 +48,31 @@ namespace vault_manager {
 
 namespace test {
 
-TEST(ClientInterfaceTest, BEH_Basic) {
-  std::shared_ptr<fs::path> test_env_root_dir{
-      maidsafe::test::CreateTestPath("MaidSafe_TestClientInterface")};
-  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
-  SetEnvironment(tcp::Port{8888}, *test_env_root_dir, path_to_vault);
+// The test environment is only set once per run, so every test shares the first one's root dir.
+// The VaultManager's config and discovery files are removed around each test, so that each starts
+// with no vaults.
+class ClientInterfaceTest : public testing::Test {
+ protected:
+  ClientInterfaceTest()
+      : test_env_root_dir_(maidsafe::test::CreateTestPath("MaidSafe_TestClientInterface")) {
+    SetEnvironment(tcp::Port{8888}, *test_env_root_dir_,
+                   process::GetOtherExecutablePath("dummy_vault"));
+  }
+
+  void SetUp() override { RemoveVaultManagerFiles(); }
+
+  void TearDown() override { RemoveVaultManagerFiles(); }
+
+  void RemoveVaultManagerFiles() {
+    boost::system::error_code ec;
+    fs::remove(GetConfigFilePath(), ec);
+    fs::remove(GetDiscoveryFilePath(), ec);
+  }
 
+  std::shared_ptr<fs::path> test_env_root_dir_;
+};
+
+TEST_F(ClientInterfaceTest, BEH_Basic) {
   VaultManager vault_manager;
   static_cast<void>(vault_manager);
 
@@ -56,6 +83,195 @@ TEST(ClientInterfaceTest, BEH_Basic) {
   }
 }
 
+TEST_F(ClientInterfaceTest, FUNC_StartVaults) {
+  VaultManager vault_manager;
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+
+  const std::vector<VaultSpec> kVaultSpecs(5);
+  auto results(client_interface.StartVaults(kVaultSpecs, 2));
+  ASSERT_EQ(kVaultSpecs.size(), results.size());
+  std::vector<passport::PmidAndSigner> pmids_and_signers;
+  for (auto& result : results) {
+    std::unique_ptr<passport::PmidAndSigner> pmid_and_signer;
+    ASSERT_NO_THROW(pmid_and_signer = result.get());
+    ASSERT_TRUE(pmid_and_signer != nullptr);
+    for (const auto& previous : pmids_and_signers)
+      EXPECT_NE(previous.first.name(), pmid_and_signer->first.name());
+    pmids_and_signers.push_back(*pmid_and_signer);
+  }
+}
+
+TEST_F(ClientInterfaceTest, FUNC_ConnectAndAsyncStartVault) {
+  VaultManager vault_manager;
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  std::promise<maidsafe_error> validated;
+  std::unique_ptr<ClientInterface> client_interface{ClientInterface::Connect(
+      maid_and_signer.first, [&](maidsafe_error error) { validated.set_value(error); })};
+  auto validated_future(validated.get_future());
+  ASSERT_EQ(std::future_status::ready, validated_future.wait_for(std::chrono::seconds(10)));
+  ASSERT_EQ(make_error_code(CommonErrors::success), validated_future.get().code());
+
+  std::promise<std::unique_ptr<passport::PmidAndSigner>> started;
+  client_interface->AsyncStartVault(
+      fs::path{}, DiskUsage{0},
+#ifdef USE_VLOGGING
+      "",
+#endif
+      [&](maidsafe_error error, std::unique_ptr<passport::PmidAndSigner> pmid_and_signer) {
+        if (error.code() == make_error_code(CommonErrors::success))
+          started.set_value(std::move(pmid_and_signer));
+        else
+          started.set_exception(std::make_exception_ptr(error));
+      });
+  std::unique_ptr<passport::PmidAndSigner> pmid_and_signer;
+  ASSERT_NO_THROW(pmid_and_signer = started.get_future().get());
+  EXPECT_TRUE(pmid_and_signer != nullptr);
+}
+
+TEST_F(ClientInterfaceTest, FUNC_ListVaults) {
+  VaultManager vault_manager;
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+  std::vector<VaultStatus> statuses;
+  ASSERT_NO_THROW(statuses = client_interface.ListVaults().get());
+  EXPECT_TRUE(statuses.empty());
+
+#ifdef USE_VLOGGING
+  auto started(client_interface.StartVault(fs::path{}, DiskUsage{0}, ""));
+#else
+  auto started(client_interface.StartVault(fs::path{}, DiskUsage{0}));
+#endif
+  ASSERT_NO_THROW(started.get());
+  ASSERT_NO_THROW(statuses = client_interface.ListVaults().get());
+  ASSERT_EQ(1U, statuses.size());
+  EXPECT_EQ(ProcessStatus::kRunning, statuses.front().status);
+  EXPECT_EQ(maid_and_signer.first.name().value, statuses.front().owner_name);
+  EXPECT_NE(0U, statuses.front().process_id);
+  EXPECT_EQ(0, statuses.front().restart_count);
+
+  VaultStatus status;
+  ASSERT_NO_THROW(status = client_interface.GetVaultStatus(statuses.front().label).get());
+  EXPECT_EQ(statuses.front().label, status.label);
+  EXPECT_EQ(statuses.front().process_id, status.process_id);
+  EXPECT_THROW(client_interface.GetVaultStatus(GenerateLabel()).get(), maidsafe_error);
+}
+
+TEST_F(ClientInterfaceTest, FUNC_GetHostStats) {
+  VaultManager vault_manager;
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+  HostStats host_stats;
+  ASSERT_NO_THROW(host_stats = client_interface.GetHostStats().get());
+  EXPECT_TRUE(host_stats.vaults.empty());
+  EXPECT_EQ(0U, host_stats.chunk_count);
+  EXPECT_EQ(0U, host_stats.max_disk_usage.data);
+}
+
+TEST_F(ClientInterfaceTest, FUNC_SubscribeToVaultEvents) {
+  VaultManager vault_manager;
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+  std::mutex mutex;
+  std::vector<VaultEvent> events;
+  std::promise<void> started;
+  client_interface.SubscribeToVaultEvents([&](const VaultEvent& event) {
+    std::lock_guard<std::mutex> lock{mutex};
+    events.push_back(event);
+    if (event.type == VaultEventType::kStarted && events.size() == 2U)
+      started.set_value();
+  });
+
+#ifdef USE_VLOGGING
+  ASSERT_NO_THROW(client_interface.StartVault(fs::path{}, DiskUsage{0}, "").get());
+#else
+  ASSERT_NO_THROW(client_interface.StartVault(fs::path{}, DiskUsage{0}).get());
+#endif
+  ASSERT_EQ(std::future_status::ready, started.get_future().wait_for(std::chrono::seconds(10)));
+  std::lock_guard<std::mutex> lock{mutex};
+  ASSERT_EQ(2U, events.size());
+  EXPECT_EQ(VaultEventType::kSpawned, events[0].type);
+  EXPECT_EQ(VaultEventType::kStarted, events[1].type);
+  EXPECT_EQ(events[0].label, events[1].label);
+  EXPECT_EQ(events[0].process_id, events[1].process_id);
+  EXPECT_EQ(events[0].sequence_number + 1, events[1].sequence_number);
+}
+
+TEST_F(ClientInterfaceTest, FUNC_ReconnectAfterVaultManagerRestart) {
+  std::unique_ptr<VaultManager> vault_manager{new VaultManager};
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+  vault_manager.reset();
+
+  // The request is held until the client has reconnected and resumed its session.
+#ifdef USE_VLOGGING
+  auto started(client_interface.StartVault(fs::path{}, DiskUsage{0}, ""));
+#else
+  auto started(client_interface.StartVault(fs::path{}, DiskUsage{0}));
+#endif
+  vault_manager.reset(new VaultManager);
+  std::unique_ptr<passport::PmidAndSigner> pmid_and_signer;
+  ASSERT_NO_THROW(pmid_and_signer = started.get());
+  EXPECT_TRUE(pmid_and_signer != nullptr);
+}
+
+TEST_F(ClientInterfaceTest, FUNC_AdoptVaultAfterVaultManagerRestart) {
+  VaultManagerOptions options;
+  options.stop_vaults_on_exit = false;
+  std::unique_ptr<VaultManager> vault_manager{new VaultManager{options}};
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  ClientInterface client_interface{maid_and_signer.first};
+#ifdef USE_VLOGGING
+  ASSERT_NO_THROW(client_interface.StartVault(fs::path{}, DiskUsage{0}, "").get());
+#else
+  ASSERT_NO_THROW(client_interface.StartVault(fs::path{}, DiskUsage{0}).get());
+#endif
+  std::vector<VaultStatus> statuses;
+  ASSERT_NO_THROW(statuses = client_interface.ListVaults().get());
+  ASSERT_EQ(1U, statuses.size());
+  const std::uint64_t kProcessId{statuses.front().process_id};
+
+  // The vault outlives the VaultManager, then reconnects to and is adopted by its replacement.
+  vault_manager.reset();
+  vault_manager.reset(new VaultManager);
+  const auto kDeadline(std::chrono::steady_clock::now() + std::chrono::seconds(20));
+  do {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_NO_THROW(statuses = client_interface.ListVaults().get());
+    ASSERT_EQ(1U, statuses.size());
+  } while (statuses.front().status != ProcessStatus::kRunning &&
+           std::chrono::steady_clock::now() < kDeadline);
+  EXPECT_EQ(ProcessStatus::kRunning, statuses.front().status);
+  EXPECT_EQ(kProcessId, statuses.front().process_id);
+  EXPECT_EQ(0, statuses.front().restart_count);
+}
+
+TEST_F(ClientInterfaceTest, FUNC_SharedIoService) {
+  VaultManager vault_manager;
+  AsioService asio_service(2);
+  const int kClientCount(5);
+  std::vector<std::unique_ptr<ClientInterface>> client_interfaces;
+  for (int i(0); i < kClientCount; ++i) {
+    passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+    client_interfaces.emplace_back(
+        new ClientInterface{maid_and_signer.first, asio_service.service()});
+  }
+
+#ifdef USE_VLOGGING
+  auto started(client_interfaces.front()->StartVault(fs::path{}, DiskUsage{0}, ""));
+#else
+  auto started(client_interfaces.front()->StartVault(fs::path{}, DiskUsage{0}));
+#endif
+  std::unique_ptr<passport::PmidAndSigner> pmid_and_signer;
+  ASSERT_NO_THROW(pmid_and_signer = started.get());
+  EXPECT_TRUE(pmid_and_signer != nullptr);
+
+  // Destroying the clients while the shared io_service is still running mustn't leave any of their
+  // handlers pending.
+  client_interfaces.clear();
+  asio_service.Stop();
+}
+
 }  // namespace test
 
 }  // namespace vault_manager
@@ -0,0 +1,151 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/config_file.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+crypto::AES256KeyAndIV RandomKeyAndIv() {
+  return crypto::AES256KeyAndIV{RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
+}
+
+// The layout written before the config file was versioned.
+struct UnversionedConfigFile {
+  template <typename Archive>
+  void save(Archive& archive) const {
+    archive(symm_key_and_iv, vaults.size());
+    for (const auto& vault : vaults) {
+      archive(passport::EncryptPmid(vault.pmid_and_signer->first, symm_key_and_iv),
+              passport::EncryptAnpmid(vault.pmid_and_signer->second, symm_key_and_iv),
+              vault.vault_dir, vault.label, vault.max_disk_usage,
+              vault.owner_name.IsInitialised());
+      if (vault.owner_name.IsInitialised())
+        archive(vault.owner_name);
+    }
+  }
+
+  crypto::AES256KeyAndIV symm_key_and_iv;
+  std::vector<VaultInfo> vaults;
+};
+
+std::vector<VaultInfo> CreateVaults() {
+  std::vector<VaultInfo> vaults(2);
+  for (std::size_t i(0); i < vaults.size(); ++i) {
+    vaults[i].pmid_and_signer =
+        std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+    vaults[i].vault_dir = "vault_" + std::to_string(i);
+    vaults[i].label = GenerateLabel();
+    vaults[i].max_disk_usage = DiskUsage(1000 * (i + 1));
+    vaults[i].process_id = 100 + i;
+  }
+  vaults[1].owner_name = Identity{RandomString(64)};
+  return vaults;
+}
+
+void ExpectEqual(const VaultInfo& expected, const VaultInfo& actual, bool expect_process_id) {
+  ASSERT_TRUE(actual.pmid_and_signer);
+  EXPECT_EQ(expected.pmid_and_signer->first.name(), actual.pmid_and_signer->first.name());
+  EXPECT_EQ(expected.pmid_and_signer->second.name(), actual.pmid_and_signer->second.name());
+  EXPECT_EQ(expected.vault_dir, actual.vault_dir);
+  EXPECT_EQ(expected.label, actual.label);
+  EXPECT_EQ(expected.max_disk_usage, actual.max_disk_usage);
+  EXPECT_EQ(expected.owner_name, actual.owner_name);
+  EXPECT_EQ(expect_process_id ? expected.process_id : 0U, actual.process_id);
+}
+
+}  // unnamed namespace
+
+TEST(ConfigFileTest, BEH_RoundTrip) {
+  const crypto::AES256KeyAndIV kSymmKeyAndIV{RandomKeyAndIv()}, kSessionTicketKey{RandomKeyAndIv()};
+  const std::vector<VaultInfo> kVaults{CreateVaults()};
+
+  ConfigFile parsed{
+      Parse<ConfigFile>(Serialise(ConfigFile{kSymmKeyAndIV, kSessionTicketKey, kVaults}))};
+  EXPECT_EQ(kSymmKeyAndIV, parsed.symm_key_and_iv);
+  EXPECT_EQ(kSessionTicketKey, parsed.session_ticket_key);
+  ASSERT_EQ(kVaults.size(), parsed.vaults.size());
+  for (std::size_t i(0); i < kVaults.size(); ++i)
+    ExpectEqual(kVaults[i], parsed.vaults[i], true);
+}
+
+TEST(ConfigFileTest, BEH_ParseUnversioned) {
+  UnversionedConfigFile unversioned;
+  unversioned.symm_key_and_iv = RandomKeyAndIv();
+  unversioned.vaults = CreateVaults();
+
+  ConfigFile parsed{Parse<ConfigFile>(Serialise(unversioned))};
+  EXPECT_EQ(unversioned.symm_key_and_iv, parsed.symm_key_and_iv);
+  EXPECT_FALSE(parsed.session_ticket_key.IsInitialised());
+  ASSERT_EQ(unversioned.vaults.size(), parsed.vaults.size());
+  for (std::size_t i(0); i < unversioned.vaults.size(); ++i)
+    ExpectEqual(unversioned.vaults[i], parsed.vaults[i], false);
+}
+
+TEST(ConfigFileTest, BEH_HandlerAddsSessionTicketKey) {
+  std::shared_ptr<boost::filesystem::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestConfigFile")};
+  const boost::filesystem::path kConfigFilePath{*test_path / "config.dat"};
+  UnversionedConfigFile unversioned;
+  unversioned.symm_key_and_iv = RandomKeyAndIv();
+  unversioned.vaults = CreateVaults();
+  ASSERT_TRUE(WriteFile(kConfigFilePath, Serialise(unversioned)));
+
+  crypto::AES256KeyAndIV session_ticket_key;
+  {
+    ConfigFileHandler handler{kConfigFilePath};
+    EXPECT_EQ(unversioned.symm_key_and_iv, handler.SymmKeyAndIV());
+    ASSERT_TRUE(handler.SessionTicketKey().IsInitialised());
+    EXPECT_NE(handler.SymmKeyAndIV(), handler.SessionTicketKey());
+    session_ticket_key = handler.SessionTicketKey();
+  }
+
+  // The generated key is persisted, along with the existing vaults.
+  ConfigFileHandler handler{kConfigFilePath};
+  EXPECT_EQ(unversioned.symm_key_and_iv, handler.SymmKeyAndIV());
+  EXPECT_EQ(session_ticket_key, handler.SessionTicketKey());
+  const std::vector<VaultInfo> kVaults{handler.ReadConfigFile()};
+  ASSERT_EQ(unversioned.vaults.size(), kVaults.size());
+  for (std::size_t i(0); i < kVaults.size(); ++i)
+    ExpectEqual(unversioned.vaults[i], kVaults[i], false);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
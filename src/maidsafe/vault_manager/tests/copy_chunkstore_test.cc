@@ -0,0 +1,93 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/copy_chunkstore.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+std::string Contents(const fs::path& path) {
+  std::ifstream file(path.string(), std::ios::binary);
+  return std::string{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+}  // unnamed namespace
+
+TEST(CopyChunkstoreTest, BEH_CopyAndResume) {
+  std::shared_ptr<fs::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestCopyChunkstore")};
+  const fs::path kSource(*test_path / "source"), kTarget(*test_path / "target");
+  fs::create_directories(kSource / "sub");
+  std::vector<std::string> contents{RandomString(100000), RandomString(1), std::string{}};
+  ASSERT_TRUE(WriteFile(kSource / "a", contents[0]));
+  ASSERT_TRUE(WriteFile(kSource / "sub" / "b", contents[1]));
+  ASSERT_TRUE(WriteFile(kSource / "sub" / "c", contents[2]));
+
+  // Leave a stale partial file and one already-copied file, as if an earlier copy was interrupted.
+  fs::create_directories(kTarget);
+  ASSERT_TRUE(WriteFile(kTarget / "a.partial", "stale"));
+  fs::create_directories(kTarget / "sub");
+  ASSERT_TRUE(WriteFile(kTarget / "sub" / "b", contents[1]));
+
+  std::vector<std::uint64_t> progress;
+  std::uint64_t total{0};
+  // Copying at 200kB/s should take roughly half a second.
+  const auto kStart(std::chrono::steady_clock::now());
+  CopyChunkstore(kSource, kTarget, 200000, [&](std::uint64_t copied, std::uint64_t bytes_total) {
+    progress.push_back(copied);
+    total = bytes_total;
+  });
+  EXPECT_GE(std::chrono::steady_clock::now() - kStart, std::chrono::milliseconds(400));
+
+  EXPECT_EQ(100001U, total);
+  ASSERT_FALSE(progress.empty());
+  EXPECT_EQ(100001U, progress.back());
+  EXPECT_EQ(contents[0], Contents(kTarget / "a"));
+  EXPECT_EQ(contents[1], Contents(kTarget / "sub" / "b"));
+  EXPECT_TRUE(fs::exists(kTarget / "sub" / "c"));
+  EXPECT_EQ(0U, fs::file_size(kTarget / "sub" / "c"));
+  EXPECT_FALSE(fs::exists(kTarget / "a.partial"));
+
+  EXPECT_THROW(CopyChunkstore(*test_path / "missing", kTarget, 0), std::exception);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,82 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/discovery_file.h"
+
+#include <iterator>
+#include <memory>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(DiscoveryFileTest, BEH_WriteReadAndRemove) {
+  std::shared_ptr<fs::path> test_dir{maidsafe::test::CreateTestPath("MaidSafe_TestDiscoveryFile")};
+  const fs::path kDiscoveryFilePath{*test_dir / kDiscoveryFilename};
+  EXPECT_FALSE(ReadDiscoveryFile(kDiscoveryFilePath));
+
+  const DiscoveryInfo kInfo{tcp::Port{5483}, process::GetProcessId(), kProtocolVersion};
+  ASSERT_NO_THROW(WriteDiscoveryFile(kDiscoveryFilePath, kInfo));
+  auto read_info(ReadDiscoveryFile(kDiscoveryFilePath));
+  ASSERT_TRUE(read_info);
+  EXPECT_EQ(kInfo.port, read_info->port);
+  EXPECT_EQ(kInfo.process_id, read_info->process_id);
+  EXPECT_EQ(kInfo.protocol_version, read_info->protocol_version);
+
+  // Overwriting mustn't leave temporary files behind.
+  ASSERT_NO_THROW(WriteDiscoveryFile(kDiscoveryFilePath, kInfo));
+  EXPECT_EQ(1, std::distance(fs::directory_iterator(*test_dir), fs::directory_iterator()));
+
+  // Only the owning process should remove the file.
+  RemoveDiscoveryFile(kDiscoveryFilePath, kInfo.process_id + 1);
+  EXPECT_TRUE(fs::exists(kDiscoveryFilePath));
+  RemoveDiscoveryFile(kDiscoveryFilePath, kInfo.process_id);
+  EXPECT_FALSE(fs::exists(kDiscoveryFilePath));
+}
+
+TEST(DiscoveryFileTest, BEH_IgnoreInvalid) {
+  std::shared_ptr<fs::path> test_dir{maidsafe::test::CreateTestPath("MaidSafe_TestDiscoveryFile")};
+  const fs::path kDiscoveryFilePath{*test_dir / kDiscoveryFilename};
+
+  ASSERT_TRUE(WriteFile(kDiscoveryFilePath, "Rubbish"));
+  EXPECT_FALSE(ReadDiscoveryFile(kDiscoveryFilePath));
+
+  ASSERT_NO_THROW(WriteDiscoveryFile(
+      kDiscoveryFilePath,
+      DiscoveryInfo{tcp::Port{5483}, process::GetProcessId(), kProtocolVersion + 1}));
+  EXPECT_FALSE(ReadDiscoveryFile(kDiscoveryFilePath));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,139 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/disk_budget.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+DiskBudget::Vault MakeVault(const std::string& label, const std::string& vault_dir,
+                            std::uint64_t requested, std::uint64_t bytes_used) {
+  DiskBudget::Vault vault;
+  vault.label = NonEmptyString{label};
+  vault.vault_dir = vault_dir;
+  vault.requested = DiskUsage{requested};
+  vault.bytes_used = bytes_used;
+  vault.reserved = 0;
+  return vault;
+}
+
+std::map<std::string, std::uint64_t> ToMap(
+    const std::vector<std::pair<NonEmptyString, DiskUsage>>& changes) {
+  std::map<std::string, std::uint64_t> result;
+  for (const auto& change : changes)
+    result[change.first.string()] = change.second.data;
+  return result;
+}
+
+}  // unnamed namespace
+
+TEST(DiskBudgetTest, BEH_SharePerFilesystem) {
+  // Vault dirs under "/a" are on filesystem 1, those under "/b" on filesystem 2.
+  std::map<std::string, std::uint64_t> available{{"/a", 1000}, {"/b", 2000}};
+  DiskBudget disk_budget{0.5, [&](const fs::path& vault_dir) {
+    FilesystemSpace space;
+    space.id = vault_dir.string()[1] == 'a' ? 1 : 2;
+    space.available = available[vault_dir.parent_path().string()];
+    return space;
+  }};
+
+  std::vector<DiskBudget::Vault> vaults{
+      MakeVault("v1", "/a/1", 0, 100), MakeVault("v2", "/a/2", 0, 0),
+      MakeVault("v3", "/b/3", 300, 0), MakeVault("v4", "/b/4", 0, 0)};
+  EXPECT_EQ(7U, disk_budget.Allocation(NonEmptyString{"v5"}, DiskUsage{7}).data);
+
+  // "/a": (100 used + 500 free) shared equally.  "/b": 1000 shared, but "v3" is capped at 300.
+  auto changes(ToMap(disk_budget.Rebalance(vaults)));
+  EXPECT_EQ((std::map<std::string, std::uint64_t>{{"v1", 300}, {"v2", 300}, {"v3", 300},
+                                                  {"v4", 700}}),
+            changes);
+  EXPECT_EQ(700U, disk_budget.Allocation(NonEmptyString{"v4"}, DiskUsage{0}).data);
+
+  // Small changes in free space are ignored.
+  available["/a"] = 1020;
+  EXPECT_TRUE(disk_budget.Rebalance(vaults).empty());
+
+  // No vault is allocated less than it already uses.
+  available["/a"] = 100;
+  vaults[0].bytes_used = 500;
+  changes = ToMap(disk_budget.Rebalance(vaults));
+  EXPECT_EQ((std::map<std::string, std::uint64_t>{{"v1", 500}, {"v2", 50}}), changes);
+
+  // A new co-located vault takes a share from the others; a removed one is forgotten.
+  vaults.erase(vaults.begin() + 2);
+  vaults.push_back(MakeVault("v5", "/b/5", 0, 0));
+  changes = ToMap(disk_budget.Rebalance(vaults));
+  EXPECT_EQ((std::map<std::string, std::uint64_t>{{"v4", 500}, {"v5", 500}}), changes);
+  EXPECT_EQ(0U, disk_budget.Allocation(NonEmptyString{"v3"}, DiskUsage{0}).data);
+}
+
+TEST(DiskBudgetTest, BEH_ReservationsCountAsFree) {
+  DiskBudget disk_budget{0.5, [](const fs::path&) {
+    FilesystemSpace space;
+    space.id = 1;
+    space.available = 400;
+    return space;
+  }};
+  std::vector<DiskBudget::Vault> vaults{MakeVault("v1", "/a/1", 0, 0),
+                                        MakeVault("v2", "/a/2", 0, 0)};
+  vaults[0].reserved = 500;
+  vaults[1].reserved = 100;
+  // Half of (400 free + 600 reserved), shared equally.
+  EXPECT_EQ((std::map<std::string, std::uint64_t>{{"v1", 250}, {"v2", 250}}),
+            ToMap(disk_budget.Rebalance(vaults)));
+}
+
+TEST(DiskBudgetTest, BEH_UnqueryableFilesystem) {
+  bool fail(false);
+  DiskBudget disk_budget{1.0, [&](const fs::path&) {
+    if (fail)
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+    FilesystemSpace space;
+    space.id = 1;
+    space.available = 1000;
+    return space;
+  }};
+  std::vector<DiskBudget::Vault> vaults{MakeVault("v1", "/a/1", 0, 0),
+                                        MakeVault("v2", "", 0, 0)};
+  EXPECT_EQ((std::map<std::string, std::uint64_t>{{"v1", 1000}}),
+            ToMap(disk_budget.Rebalance(vaults)));
+
+  fail = true;
+  EXPECT_TRUE(disk_budget.Rebalance(vaults).empty());
+  EXPECT_EQ(1000U, disk_budget.Allocation(NonEmptyString{"v1"}, DiskUsage{0}).data);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
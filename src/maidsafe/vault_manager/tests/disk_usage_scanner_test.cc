@@ -0,0 +1,101 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/disk_usage_scanner.h"
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+void WriteBytes(const fs::path& path, std::size_t size) {
+  ASSERT_TRUE(WriteFile(path, std::string(size, 'a')));
+}
+
+// Backdates 'dir' so that it's old enough for the scanner to cache.
+void Backdate(const fs::path& dir) { fs::last_write_time(dir, std::time_t{1000000000}); }
+
+}  // unnamed namespace
+
+TEST(DiskUsageScannerTest, BEH_TotalsEachVaultDir) {
+  std::shared_ptr<fs::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestDiskUsageScanner")};
+  const fs::path kVault0{*test_path / "vault_0"}, kVault1{*test_path / "vault_1"};
+  fs::create_directories(kVault0 / "a" / "b");
+  fs::create_directories(kVault1);
+  WriteBytes(kVault0 / "chunk_0", 100);
+  WriteBytes(kVault0 / "a" / "chunk_1", 20);
+  WriteBytes(kVault0 / "a" / "b" / "chunk_2", 3);
+  WriteBytes(kVault1 / "chunk_0", 4000);
+  WriteBytes(kVault1 / "ignored", 50000);
+
+  DiskUsageScanner scanner{2, "ignored"};
+  EXPECT_EQ((std::vector<std::uint64_t>{123, 4000}), scanner.Scan({kVault0, kVault1}));
+  // A missing vault dir is counted as empty rather than failing the whole scan.
+  EXPECT_EQ((std::vector<std::uint64_t>{4000, 0}),
+            scanner.Scan({kVault1, *test_path / "missing"}));
+}
+
+TEST(DiskUsageScannerTest, BEH_RescanOnlyChangedDirectories) {
+  std::shared_ptr<fs::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestDiskUsageScanner")};
+  const fs::path kVault{*test_path / "vault"};
+  fs::create_directories(kVault / "a");
+  fs::create_directories(kVault / "b");
+  WriteBytes(kVault / "a" / "chunk_0", 10);
+  WriteBytes(kVault / "b" / "chunk_1", 20);
+  Backdate(kVault);
+  Backdate(kVault / "a");
+  Backdate(kVault / "b");
+
+  DiskUsageScanner scanner;
+  EXPECT_EQ(std::vector<std::uint64_t>{30}, scanner.Scan({kVault}));
+
+  // Rewriting a file in place leaves its directory's mtime unchanged, but the file is still
+  // re-stat'ed.
+  WriteBytes(kVault / "a" / "chunk_0", 50);
+  Backdate(kVault / "a");
+  EXPECT_EQ(std::vector<std::uint64_t>{70}, scanner.Scan({kVault}));
+
+  // Adding or removing entries changes the directory's mtime, so it's re-listed.
+  WriteBytes(kVault / "b" / "chunk_2", 300);
+  EXPECT_EQ(std::vector<std::uint64_t>{370}, scanner.Scan({kVault}));
+  fs::remove_all(kVault / "a");
+  EXPECT_EQ(std::vector<std::uint64_t>{320}, scanner.Scan({kVault}));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -17,8 +17,13 @@
     use of the MaidSafe Software.                                                                 */
 
 #include <chrono>
+#include <csignal>
 #include <cstdint>
+#include <cstdlib>
 #include <future>
+#include <set>
+#include <sstream>
+#include <string>
 
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
@@ -26,6 +31,22 @@
 
 #include "maidsafe/vault_manager/vault_config.h"
 #include "maidsafe/vault_manager/vault_interface.h"
+#include "maidsafe/vault_manager/tests/test_utils.h"
+
+namespace {
+
+std::set<std::string> GetBehaviours() {
+  std::set<std::string> behaviours;
+  const char* const kValue{
+      std::getenv(maidsafe::vault_manager::test::kDummyVaultBehaviourVariable)};
+  std::istringstream value_stream{kValue ? kValue : ""};
+  std::string behaviour;
+  while (std::getline(value_stream, behaviour, ','))
+    behaviours.insert(behaviour);
+  return behaviours;
+}
+
+}  // unnamed namespace
 
 int main(int argc, char* argv[]) {
   using maidsafe::vault_manager::VaultConfig;
@@ -35,12 +56,23 @@ int main(int argc, char* argv[]) {
     auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
     if (unuseds.size() != 2U)
       BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+    const std::set<std::string> kBehaviours{GetBehaviours()};
+    if (kBehaviours.count("ignore_sigterm") != 0U)
+      std::signal(SIGTERM, SIG_IGN);
     uint16_t port{static_cast<uint16_t>(std::stoi(std::string{&unuseds[1][0]}))};
     maidsafe::vault_manager::VaultInterface vault_interface{port};
     connected_to_vault_manager = true;
 
+    if (kBehaviours.count("drain") != 0U) {
+      vault_interface.SetDrainFunctor(
+          [&](std::chrono::steady_clock::time_point) { vault_interface.DrainComplete(); });
+    } else if (kBehaviours.count("ignore_drain") != 0U) {
+      vault_interface.SetDrainFunctor([](std::chrono::steady_clock::time_point) {});
+    }
     std::future<void> worker;
     VaultConfig config{vault_interface.GetConfiguration()};
+    if (kBehaviours.count("join") != 0U)
+      vault_interface.SendJoined();
     switch (config.test_config.test_type) {
       case VaultConfig::TestType::kNone:
         break;
@@ -0,0 +1,70 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/heartbeat_monitor.h"
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(HeartbeatMonitorTest, BEH_MissedHeartbeats) {
+  HeartbeatMonitor heartbeat_monitor(3);
+  heartbeat_monitor.OnHeartbeat(0);
+  EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+  EXPECT_EQ(0, heartbeat_monitor.MissedCount());
+
+  EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+  EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+  EXPECT_EQ(2, heartbeat_monitor.MissedCount());
+  // A single late heartbeat resets the count.
+  heartbeat_monitor.OnHeartbeat(0);
+  EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+  EXPECT_EQ(0, heartbeat_monitor.MissedCount());
+
+  EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+  EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+  EXPECT_TRUE(heartbeat_monitor.OnIntervalElapsed());
+  EXPECT_EQ(3, heartbeat_monitor.MissedCount());
+}
+
+TEST(HeartbeatMonitorTest, BEH_StalledProgress) {
+  HeartbeatMonitor heartbeat_monitor(2);
+  for (std::uint64_t progress(1); progress < 5; ++progress) {
+    heartbeat_monitor.OnHeartbeat(progress);
+    EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+  }
+
+  // Heartbeats still arrive, but the vault's event loop has stopped making progress.
+  heartbeat_monitor.OnHeartbeat(4);
+  EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+  heartbeat_monitor.OnHeartbeat(4);
+  EXPECT_TRUE(heartbeat_monitor.OnIntervalElapsed());
+
+  heartbeat_monitor.OnHeartbeat(5);
+  EXPECT_FALSE(heartbeat_monitor.OnIntervalElapsed());
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
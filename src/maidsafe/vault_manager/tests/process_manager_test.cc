@@ -1,4 +1,4 @@
-/*  Copyright 2012 MaidSafe.net limited
+/*  Copyright 2014 MaidSafe.net limited
 
     This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
     version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
@@ -18,10 +18,21 @@
 
 #include "maidsafe/vault_manager/process_manager.h"
 
-#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "asio/io_service_strand.hpp"
+#include "boost/filesystem/operations.hpp"
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/asio_service.h"
@@ -29,9 +40,15 @@
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/common/tcp/listener.h"
+#include "maidsafe/passport/passport.h"
 
 #include "maidsafe/vault_manager/config.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/vault_started.h"
+#include "maidsafe/vault_manager/messages/vault_started_response.h"
 #include "maidsafe/vault_manager/tests/test_utils.h"
 
 namespace fs = boost::filesystem;
@@ -52,6 +69,392 @@ TEST(ProcessManagerTest, BEH_Constructor) {
   asio_service.reset();
 }
 
+// Plays the part of the VaultManager for a ProcessManager running dummy_vaults: it listens for the
+// vaults' connections, passes their messages to the ProcessManager and records the vault events.
+// The ProcessManager is only ever called on the single asio thread, as in the VaultManager.
+class ProcessManagerTest : public testing::Test {
+ protected:
+  ProcessManagerTest()
+      : test_path_(maidsafe::test::CreateTestPath("MaidSafe_TestProcessManager")),
+        path_to_vault_(process::GetOtherExecutablePath("dummy_vault")),
+        symm_key_and_iv_(RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)),
+        asio_service_(1),
+        strand_(asio_service_.service()),
+        listener_(),
+        process_manager_(),
+        mutex_(),
+        cond_var_(),
+        events_() {}
+
+  void TearDown() override {
+    if (process_manager_) {
+      Run([this] { process_manager_->StopAll(); });
+      EXPECT_TRUE(WaitUntil([this] { return process_manager_->GetAll().empty(); }));
+    }
+    if (listener_)
+      Run([this] { listener_->StopListening(); });
+    asio_service_.Stop();
+    process_manager_.reset();
+    SetDummyVaultBehaviour("");
+  }
+
+  void StartProcessManager(std::chrono::milliseconds drain_timeout = kVaultDrainTimeout) {
+    listener_ = tcp::Listener::MakeShared(
+        strand_, [this](tcp::ConnectionPtr connection) { HandleNewConnection(connection); },
+        tcp::Port{9999});
+    process_manager_ = ProcessManager::MakeShared(
+        asio_service_.service(), path_to_vault_, listener_->ListeningPort(),
+        kMaxConcurrentVaultStarts, [this](VaultEvent event) { RecordEvent(std::move(event)); },
+        std::chrono::milliseconds(0), kHeartbeatMissThreshold, drain_timeout, false);
+  }
+
+  template <typename Functor>
+  auto Run(Functor functor) -> decltype(functor()) {
+    std::packaged_task<decltype(functor())()> task{functor};
+    auto result(task.get_future());
+    asio_service_.service().post([&task] { task(); });
+    return result.get();
+  }
+
+  bool WaitUntil(std::function<bool()> predicate,
+                 std::chrono::steady_clock::duration timeout = std::chrono::seconds(30)) {
+    const auto kDeadline(std::chrono::steady_clock::now() + timeout);
+    while (!Run(predicate)) {
+      if (std::chrono::steady_clock::now() > kDeadline)
+        return false;
+      Sleep(std::chrono::milliseconds(100));
+    }
+    return true;
+  }
+
+  std::vector<NonEmptyString> AddVaults(int count) {
+    std::vector<NonEmptyString> labels;
+    for (int i(0); i < count; ++i) {
+      VaultInfo vault_info;
+      vault_info.pmid_and_signer =
+          std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+      vault_info.vault_dir = *test_path_ / ("vault_" + RandomAlphaNumericString(8));
+      fs::create_directories(vault_info.vault_dir);
+      vault_info.label = GenerateLabel();
+      labels.push_back(vault_info.label);
+      Run([&] { process_manager_->AddProcess(vault_info); });
+    }
+    return labels;
+  }
+
+  // The future holds the error and exit code passed to the stopped vault's on_exit functor.
+  std::future<std::pair<maidsafe_error, int>> StopVault(const NonEmptyString& label) {
+    auto stopped(std::make_shared<std::promise<std::pair<maidsafe_error, int>>>());
+    Run([&] {
+      process_manager_->StopProcess(process_manager_->Find(label).tcp_connection,
+                                    [stopped](maidsafe_error error, int exit_code) {
+                                      stopped->set_value(std::make_pair(error, exit_code));
+                                    });
+    });
+    return stopped->get_future();
+  }
+
+  // Returns a copy of dummy_vault, to be upgraded to.
+  fs::path CopyVault() {
+    fs::path copy_path{*test_path_ /
+                       ("upgraded_dummy_vault" + path_to_vault_.extension().string())};
+    fs::copy_file(path_to_vault_, copy_path);
+    return copy_path;
+  }
+
+  bool WaitForEvents(VaultEventType type, std::size_t count,
+                     std::chrono::steady_clock::duration timeout = std::chrono::seconds(30)) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    return cond_var_.wait_for(lock, timeout, [&] { return DoCountEvents(type) >= count; });
+  }
+
+  std::size_t CountEvents(VaultEventType type) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return DoCountEvents(type);
+  }
+
+  std::vector<VaultEvent> Events() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return events_;
+  }
+
+  ProcessId GetProcessId(const NonEmptyString& label) {
+    return Run([&] {
+      for (const auto& status : process_manager_->GetStatuses()) {
+        if (status.label == label)
+          return ProcessId{status.process_id};
+      }
+      return ProcessId{0};
+    });
+  }
+
+  // Only checked on Linux, where the vault's command line shows which executable it was started
+  // from.
+  bool IsRunningFrom(const NonEmptyString& label, const fs::path& executable_path) {
+#ifdef __linux__
+    std::ifstream cmdline_file{"/proc/" + std::to_string(GetProcessId(label)) + "/cmdline",
+                               std::ios::binary};
+    const std::string kCmdline{std::istreambuf_iterator<char>(cmdline_file),
+                               std::istreambuf_iterator<char>()};
+    return kCmdline.find(executable_path.string()) != std::string::npos;
+#else
+    static_cast<void>(label);
+    static_cast<void>(executable_path);
+    return true;
+#endif
+  }
+
+  std::shared_ptr<fs::path> test_path_;
+  const fs::path path_to_vault_;
+  const crypto::AES256KeyAndIV symm_key_and_iv_;
+  AsioService asio_service_;
+  asio::io_service::strand strand_;
+  std::shared_ptr<tcp::Listener> listener_;
+  std::shared_ptr<ProcessManager> process_manager_;
+
+ private:
+  void HandleNewConnection(tcp::ConnectionPtr connection) {
+    connection->Start(
+        [=](tcp::Message message) { HandleReceivedMessage(connection, std::move(message)); },
+        [=] { process_manager_->HandleConnectionClosed(connection); });
+  }
+
+  void HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Message&& message) {
+    try {
+      InputVectorStream binary_input_stream(std::move(message));
+      MessageTag tag(static_cast<MessageTag>(-1));
+      Parse(binary_input_stream, tag);
+      switch (tag) {
+        case MessageTag::kVaultStarted: {
+          VaultInfo vault_info{process_manager_->HandleVaultStarted(
+              connection, {Parse<VaultStarted>(binary_input_stream).process_id})};
+          Send(connection, VaultStartedResponse(vault_info, symm_key_and_iv_,
+                                                std::chrono::milliseconds(0)));
+          break;
+        }
+        case MessageTag::kJoinedNetwork:
+          process_manager_->HandleJoinedNetwork(connection);
+          break;
+        case MessageTag::kVaultDrained:
+          process_manager_->HandleDrained(connection);
+          break;
+        default:
+          break;
+      }
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to handle incoming message: " << boost::diagnostic_information(e);
+    }
+  }
+
+  void RecordEvent(VaultEvent event) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      events_.push_back(std::move(event));
+    }
+    cond_var_.notify_all();
+  }
+
+  std::size_t DoCountEvents(VaultEventType type) const {
+    return static_cast<std::size_t>(std::count_if(
+        std::begin(events_), std::end(events_),
+        [type](const VaultEvent& event) { return event.type == type; }));
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  std::vector<VaultEvent> events_;
+};
+
+TEST_F(ProcessManagerTest, BEH_UpgradeWavesWaitForJoins) {
+  SetDummyVaultBehaviour("join");
+  StartProcessManager();
+  const auto kLabels(AddVaults(3));
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kJoined, kLabels.size()));
+  const std::size_t kEventsBeforeUpgrade{Events().size()};
+
+  const fs::path kNewExecutable{CopyVault()};
+  const int kWaveSize{2};
+  std::promise<maidsafe_error> upgraded;
+  Run([&] {
+    process_manager_->UpgradeVaults(kNewExecutable, kWaveSize, std::chrono::minutes(1),
+                                    [&](maidsafe_error error) { upgraded.set_value(error); });
+  });
+  auto upgraded_future(upgraded.get_future());
+  ASSERT_EQ(std::future_status::ready, upgraded_future.wait_for(std::chrono::seconds(60)));
+  EXPECT_EQ(make_error_code(CommonErrors::success), upgraded_future.get().code());
+
+  // No vault of a wave may be stopped until every vault of the previous wave has rejoined.
+  const auto kEvents(Events());
+  std::size_t stopped_count{0}, joined_count{0};
+  for (auto itr(std::begin(kEvents) + kEventsBeforeUpgrade); itr != std::end(kEvents); ++itr) {
+    if (itr->type == VaultEventType::kJoined) {
+      ++joined_count;
+    } else if (itr->type == VaultEventType::kStopped) {
+      EXPECT_GE(joined_count, (stopped_count / kWaveSize) * kWaveSize);
+      ++stopped_count;
+    }
+  }
+  EXPECT_EQ(kLabels.size(), stopped_count);
+  EXPECT_EQ(kLabels.size(), joined_count);
+  for (const auto& label : kLabels)
+    EXPECT_TRUE(IsRunningFrom(label, kNewExecutable));
+}
+
+#ifndef MAIDSAFE_WIN32
+TEST_F(ProcessManagerTest, BEH_UpgradeRollsBackOnStartFailure) {
+  SetDummyVaultBehaviour("join");
+  StartProcessManager();
+  const auto kLabels(AddVaults(1));
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kJoined, 1));
+
+  const fs::path kFailingExecutable{*test_path_ / "failing_vault"};
+  {
+    std::ofstream script{kFailingExecutable.string()};
+    script << "#!/bin/sh\nexit 1\n";
+  }
+  fs::permissions(kFailingExecutable, fs::owner_all);
+  std::promise<maidsafe_error> upgraded;
+  Run([&] {
+    process_manager_->UpgradeVaults(kFailingExecutable, 1, std::chrono::minutes(1),
+                                    [&](maidsafe_error error) { upgraded.set_value(error); });
+  });
+  auto upgraded_future(upgraded.get_future());
+  ASSERT_EQ(std::future_status::ready, upgraded_future.wait_for(std::chrono::seconds(30)));
+  EXPECT_EQ(make_error_code(VaultManagerErrors::vault_exited_with_error),
+            upgraded_future.get().code());
+
+  // The vault is restarted on the previous executable.
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kJoined, 2));
+  EXPECT_EQ(3U, CountEvents(VaultEventType::kSpawned));
+  EXPECT_TRUE(IsRunningFrom(kLabels.front(), path_to_vault_));
+}
+#endif
+
+TEST_F(ProcessManagerTest, BEH_UpgradeRollsBackOnWaveTimeout) {
+  // The vaults never join, so the first wave times out.
+  StartProcessManager();
+  const auto kLabels(AddVaults(2));
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kStarted, kLabels.size()));
+  const ProcessId kUntouchedProcessId{GetProcessId(kLabels.back())};
+
+  const fs::path kNewExecutable{CopyVault()};
+  std::promise<maidsafe_error> upgraded;
+  Run([&] {
+    process_manager_->UpgradeVaults(kNewExecutable, 1, std::chrono::seconds(2),
+                                    [&](maidsafe_error error) { upgraded.set_value(error); });
+  });
+  auto upgraded_future(upgraded.get_future());
+  ASSERT_EQ(std::future_status::ready, upgraded_future.wait_for(std::chrono::seconds(30)));
+  EXPECT_EQ(make_error_code(VaultManagerErrors::timed_out), upgraded_future.get().code());
+
+  // Only the first wave's vault was upgraded, and it's restarted on the previous executable.
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kStarted, 4));
+  EXPECT_EQ(2U, CountEvents(VaultEventType::kStopped));
+  for (const auto& event : Events()) {
+    if (event.type == VaultEventType::kStopped)
+      EXPECT_EQ(kLabels.front(), event.label);
+  }
+  EXPECT_EQ(kUntouchedProcessId, GetProcessId(kLabels.back()));
+  EXPECT_TRUE(IsRunningFrom(kLabels.front(), path_to_vault_));
+}
+
+TEST_F(ProcessManagerTest, BEH_UpgradeAbandonedByStopAll) {
+  SetDummyVaultBehaviour("join");
+  StartProcessManager();
+  const auto kLabels(AddVaults(2));
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kJoined, kLabels.size()));
+
+  const fs::path kNewExecutable{CopyVault()};
+  std::promise<maidsafe_error> upgraded;
+  Run([&] {
+    process_manager_->UpgradeVaults(kNewExecutable, 1, std::chrono::minutes(1),
+                                    [&](maidsafe_error error) { upgraded.set_value(error); });
+    process_manager_->StopAll();
+  });
+  auto upgraded_future(upgraded.get_future());
+  ASSERT_EQ(std::future_status::ready, upgraded_future.wait_for(std::chrono::seconds(0)));
+  EXPECT_EQ(make_error_code(CommonErrors::unable_to_handle_request),
+            upgraded_future.get().code());
+
+  // The vault stopped by the upgrade's first wave isn't restarted.
+  ASSERT_TRUE(WaitUntil([this] { return process_manager_->GetAll().empty(); }));
+  EXPECT_EQ(kLabels.size(), CountEvents(VaultEventType::kStopped));
+  EXPECT_EQ(kLabels.size(), CountEvents(VaultEventType::kSpawned));
+}
+
+TEST_F(ProcessManagerTest, BEH_UpgradeAbandonedByStopAllWithInterval) {
+  SetDummyVaultBehaviour("join");
+  StartProcessManager();
+  const auto kLabels(AddVaults(1));
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kJoined, kLabels.size()));
+
+  const fs::path kNewExecutable{CopyVault()};
+  std::promise<maidsafe_error> upgraded;
+  Run([&] {
+    process_manager_->UpgradeVaults(kNewExecutable, 1, std::chrono::minutes(1),
+                                    [&](maidsafe_error error) { upgraded.set_value(error); });
+    process_manager_->StopAllWithInterval();
+  });
+  auto upgraded_future(upgraded.get_future());
+  ASSERT_EQ(std::future_status::ready, upgraded_future.wait_for(std::chrono::seconds(0)));
+  EXPECT_EQ(make_error_code(CommonErrors::unable_to_handle_request),
+            upgraded_future.get().code());
+
+  ASSERT_TRUE(WaitUntil([this] { return process_manager_->GetAll().empty(); }));
+  EXPECT_EQ(kLabels.size(), CountEvents(VaultEventType::kStopped));
+  EXPECT_EQ(kLabels.size(), CountEvents(VaultEventType::kSpawned));
+}
+
+TEST_F(ProcessManagerTest, BEH_StopOnDrainComplete) {
+  SetDummyVaultBehaviour("join,drain");
+  StartProcessManager(std::chrono::minutes(1));
+  const auto kLabels(AddVaults(1));
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kJoined, 1));
+
+  // The vault exits as soon as it has drained, well before the drain timeout.
+  auto stopped(StopVault(kLabels.front()));
+  ASSERT_EQ(std::future_status::ready, stopped.wait_for(std::chrono::seconds(10)));
+  const auto kResult(stopped.get());
+  EXPECT_EQ(make_error_code(CommonErrors::success), kResult.first.code());
+  EXPECT_EQ(0, kResult.second);
+}
+
+#ifndef MAIDSAFE_WIN32
+TEST_F(ProcessManagerTest, BEH_StopSendsSigtermOnDrainTimeout) {
+  SetDummyVaultBehaviour("join,ignore_drain");
+  const std::chrono::seconds kDrainTimeout{1};
+  StartProcessManager(kDrainTimeout);
+  const auto kLabels(AddVaults(1));
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kJoined, 1));
+
+  // SIGTERM stops the vault before it would be killed.
+  const auto kStartTime(std::chrono::steady_clock::now());
+  auto stopped(StopVault(kLabels.front()));
+  ASSERT_EQ(std::future_status::ready, stopped.wait_for(std::chrono::seconds(30)));
+  const auto kElapsed(std::chrono::steady_clock::now() - kStartTime);
+  EXPECT_NE(make_error_code(VaultManagerErrors::vault_terminated), stopped.get().first.code());
+  EXPECT_GE(kElapsed, kDrainTimeout);
+  EXPECT_LT(kElapsed, kDrainTimeout + kVaultTerminateTimeout);
+}
+
+TEST_F(ProcessManagerTest, BEH_StopKillsVaultIgnoringSigterm) {
+  SetDummyVaultBehaviour("join,ignore_drain,ignore_sigterm");
+  const std::chrono::seconds kDrainTimeout{1};
+  StartProcessManager(kDrainTimeout);
+  const auto kLabels(AddVaults(1));
+  ASSERT_TRUE(WaitForEvents(VaultEventType::kJoined, 1));
+
+  const auto kStartTime(std::chrono::steady_clock::now());
+  auto stopped(StopVault(kLabels.front()));
+  ASSERT_EQ(std::future_status::ready, stopped.wait_for(std::chrono::seconds(30)));
+  const auto kElapsed(std::chrono::steady_clock::now() - kStartTime);
+  const auto kResult(stopped.get());
+  EXPECT_EQ(make_error_code(VaultManagerErrors::vault_terminated), kResult.first.code());
+  EXPECT_EQ(-1, kResult.second);
+  EXPECT_GE(kElapsed, kDrainTimeout + kVaultTerminateTimeout);
+}
+#endif
+
 }  // namespace test
 
 }  // namespace vault_manager
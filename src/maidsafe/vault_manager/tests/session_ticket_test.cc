@@ -0,0 +1,89 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/utils.h"
+
+#include <chrono>
+#include <string>
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+crypto::AES256KeyAndIV RandomKeyAndIv() {
+  return crypto::AES256KeyAndIV{RandomBytes(crypto::AES256_KeySize + crypto::AES256_IVSize)};
+}
+
+void ExpectRejected(const crypto::CipherText& ticket, const crypto::AES256KeyAndIV& key) {
+  try {
+    ParseSessionTicket(ticket, key);
+    ADD_FAILURE() << "Ticket should have been rejected.";
+  } catch (const maidsafe_error& error) {
+    EXPECT_EQ(make_error_code(VaultManagerErrors::unvalidated_client), error.code());
+  }
+}
+
+}  // unnamed namespace
+
+TEST(SessionTicketTest, BEH_Valid) {
+  const crypto::AES256KeyAndIV kKey{RandomKeyAndIv()};
+  const Identity kMaidName{RandomString(64)};
+  const crypto::CipherText kTicket{CreateSessionTicket(kMaidName, kKey)};
+  EXPECT_EQ(kMaidName, ParseSessionTicket(kTicket, kKey));
+  // Each ticket has a random nonce, so no two encrypt alike.
+  EXPECT_NE(kTicket.data, CreateSessionTicket(kMaidName, kKey).data);
+}
+
+TEST(SessionTicketTest, BEH_Forged) {
+  // E.g. a vault using the config file key it was sent, which mustn't be the session ticket key.
+  const crypto::AES256KeyAndIV kKey{RandomKeyAndIv()}, kForgersKey{RandomKeyAndIv()};
+  ExpectRejected(CreateSessionTicket(Identity{RandomString(64)}, kForgersKey), kKey);
+  ExpectRejected(crypto::CipherText{NonEmptyString{RandomBytes(64, 256)}}, kKey);
+}
+
+TEST(SessionTicketTest, BEH_Tampered) {
+  const crypto::AES256KeyAndIV kKey{RandomKeyAndIv()};
+  const crypto::CipherText kTicket{CreateSessionTicket(Identity{RandomString(64)}, kKey)};
+  // Flip one bit at a time through the whole ticket.
+  for (std::size_t i(0); i < kTicket.data.string().size() * 8; i += 7) {
+    std::string tampered{kTicket.data.string()};
+    tampered[i / 8] ^= static_cast<char>(1 << (i % 8));
+    ExpectRejected(crypto::CipherText{NonEmptyString{tampered}}, kKey);
+  }
+}
+
+TEST(SessionTicketTest, BEH_Expired) {
+  const crypto::AES256KeyAndIV kKey{RandomKeyAndIv()};
+  ExpectRejected(
+      CreateSessionTicket(Identity{RandomString(64)}, kKey, std::chrono::seconds(-1)), kKey);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
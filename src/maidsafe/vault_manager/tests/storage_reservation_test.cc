@@ -0,0 +1,77 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/storage_reservation.h"
+
+#include <memory>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(StorageReservationTest, BEH_ReservationSize) {
+  const std::uint64_t kGranule(kReservationGranularity);
+  const DiskUsage kMaxDiskUsage{10 * kGranule};
+  EXPECT_EQ(0U, ReservationSize(DiskUsage{0}, 0, 1.0));
+  // One granule of the share is left as headroom.
+  EXPECT_EQ(9 * kGranule, ReservationSize(kMaxDiskUsage, 0, 1.0));
+  EXPECT_EQ(4 * kGranule, ReservationSize(kMaxDiskUsage, 0, 0.5));
+  // Usage shrinks the reservation a whole granule at a time.
+  EXPECT_EQ(8 * kGranule, ReservationSize(kMaxDiskUsage, 1, 1.0));
+  EXPECT_EQ(7 * kGranule, ReservationSize(kMaxDiskUsage, 2 * kGranule, 1.0));
+  EXPECT_EQ(0U, ReservationSize(kMaxDiskUsage, 9 * kGranule, 1.0));
+  EXPECT_EQ(0U, ReservationSize(kMaxDiskUsage, 20 * kGranule, 1.0));
+}
+
+TEST(StorageReservationTest, BEH_SetReservation) {
+  std::shared_ptr<fs::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestStorageReservation")};
+  EXPECT_EQ(0U, GetReservation(*test_path));
+  EXPECT_NO_THROW(SetReservation(*test_path, 0));
+#ifdef __linux__
+  try {
+    SetReservation(*test_path, 1 << 20);
+  } catch (const maidsafe_error&) {
+    return;  // The test filesystem may not support fallocate.
+  }
+  EXPECT_EQ(1U << 20, GetReservation(*test_path));
+  SetReservation(*test_path, 1 << 16);
+  EXPECT_EQ(1U << 16, GetReservation(*test_path));
+  SetReservation(*test_path, 0);
+  EXPECT_FALSE(fs::exists(*test_path / kReservationFilename));
+#else
+  EXPECT_THROW(SetReservation(*test_path, 1 << 20), maidsafe_error);
+#endif
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -73,6 +73,14 @@ int GetNumRunningProcesses(std::string process_name) {
   }
 }
 
+void SetDummyVaultBehaviour(const std::string& behaviour) {
+#ifdef MAIDSAFE_WIN32
+  _putenv_s(kDummyVaultBehaviourVariable, behaviour.c_str());
+#else
+  setenv(kDummyVaultBehaviourVariable, behaviour.c_str(), 1);
+#endif
+}
+
 }  // namespace test
 
 }  //  namespace vault_manager
@@ -29,6 +29,17 @@ namespace test {
 
 int GetNumRunningProcesses(std::string process_name);
 
+// The environment variable read by dummy_vault on startup to choose how it behaves, since it's only
+// ever started via a ProcessManager.  Its value is a comma-separated list of:
+//   join - sends JoinedNetwork once it has its configuration
+//   drain - completes draining as soon as it's asked to stop
+//   ignore_drain - never completes draining, so has to be signalled to stop
+//   ignore_sigterm - ignores SIGTERM, so has to be killed if it doesn't drain
+const char* const kDummyVaultBehaviourVariable = "MAIDSAFE_DUMMY_VAULT_BEHAVIOUR";
+
+// Sets the behaviour of dummy_vaults started from now on by this process.
+void SetDummyVaultBehaviour(const std::string& behaviour);
+
 }  // namespace test
 
 }  // namespace vault_manager
@@ -0,0 +1,173 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/timing_wheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+typedef std::chrono::steady_clock::duration Duration;
+
+std::chrono::microseconds ElapsedSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                               start);
+}
+
+}  // unnamed namespace
+
+TEST(TimingWheelTest, BEH_ExpiresInOrder) {
+  AsioService asio_service(1);
+  TimingWheel& timing_wheel(TimingWheel::Get(asio_service.service()));
+  EXPECT_EQ(&timing_wheel, &TimingWheel::Get(asio_service.service()));
+
+  std::mutex mutex;
+  std::vector<int> order;
+  std::promise<void> done;
+  auto record([&](int index) {
+    std::lock_guard<std::mutex> lock{mutex};
+    order.push_back(index);
+    if (order.size() == 3U)
+      done.set_value();
+  });
+  timing_wheel.Arm(std::chrono::milliseconds(300), [&] { record(2); });
+  timing_wheel.Arm(std::chrono::milliseconds(0), [&] { record(0); });
+  timing_wheel.Arm(std::chrono::milliseconds(100), [&] { record(1); });
+  EXPECT_EQ(3U, timing_wheel.PendingCount());
+
+  ASSERT_EQ(std::future_status::ready,
+            done.get_future().wait_for(std::chrono::seconds(5)));
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), order);
+  EXPECT_EQ(0U, timing_wheel.PendingCount());
+}
+
+TEST(TimingWheelTest, BEH_Cancel) {
+  AsioService asio_service(1);
+  TimingWheel& timing_wheel(TimingWheel::Get(asio_service.service()));
+
+  TimingWheel::Handle unarmed;
+  EXPECT_FALSE(unarmed.Cancel());
+
+  std::atomic<bool> cancelled_fired(false);
+  std::promise<void> fired;
+  TimingWheel::Handle cancelled{
+      timing_wheel.Arm(std::chrono::milliseconds(100), [&] { cancelled_fired = true; })};
+  TimingWheel::Handle expired{
+      timing_wheel.Arm(std::chrono::milliseconds(200), [&] { fired.set_value(); })};
+  EXPECT_TRUE(cancelled.Cancel());
+  EXPECT_FALSE(cancelled.Cancel());
+  EXPECT_EQ(1U, timing_wheel.PendingCount());
+
+  ASSERT_EQ(std::future_status::ready, fired.get_future().wait_for(std::chrono::seconds(5)));
+  EXPECT_FALSE(expired.Cancel());
+  EXPECT_FALSE(cancelled_fired);
+
+  // A slot reused by a later deadline mustn't be cancellable via the stale handle.
+  TimingWheel::Handle reused{timing_wheel.Arm(std::chrono::hours(100), [] {})};
+  EXPECT_FALSE(expired.Cancel());
+  EXPECT_TRUE(reused.Cancel());
+}
+
+TEST(TimingWheelTest, FUNC_TenThousandPendingDeadlines) {
+  const int kCount(10000);
+  AsioService asio_service(1);
+  TimingWheel& timing_wheel(TimingWheel::Get(asio_service.service()));
+
+  // Compare against the previous approach of one shared steady_timer per deadline.
+  std::vector<TimerPtr> timers;
+  timers.reserve(kCount);
+  auto start(std::chrono::steady_clock::now());
+  for (int i(0); i < kCount; ++i) {
+    timers.emplace_back(std::make_shared<Timer>(asio_service.service(), kRpcTimeout));
+    timers.back()->async_wait([](const std::error_code&) {});
+  }
+  const auto kTimerArmTime(ElapsedSince(start));
+  start = std::chrono::steady_clock::now();
+  for (auto& timer : timers)
+    timer->cancel();
+  const auto kTimerCancelTime(ElapsedSince(start));
+  timers.clear();
+
+  std::vector<TimingWheel::Handle> handles;
+  handles.reserve(kCount);
+  start = std::chrono::steady_clock::now();
+  for (int i(0); i < kCount; ++i)
+    handles.emplace_back(timing_wheel.Arm(kRpcTimeout, [] {}));
+  const auto kWheelArmTime(ElapsedSince(start));
+  EXPECT_EQ(static_cast<std::size_t>(kCount), timing_wheel.PendingCount());
+  start = std::chrono::steady_clock::now();
+  for (auto& handle : handles)
+    EXPECT_TRUE(handle.Cancel());
+  const auto kWheelCancelTime(ElapsedSince(start));
+  EXPECT_EQ(0U, timing_wheel.PendingCount());
+
+  TLOG(kDefaultColour) << kCount << " deadlines - steady_timer arm: " << kTimerArmTime.count()
+                       << "us, cancel: " << kTimerCancelTime.count()
+                       << "us.  TimingWheel arm: " << kWheelArmTime.count()
+                       << "us, cancel: " << kWheelCancelTime.count() << "us\n";
+
+  // Let half expire at spread-out deadlines and check none fires early or is badly late.
+  std::atomic<int> fired_count(0), early_count(0), late_count(0);
+  std::promise<void> all_fired;
+  const Duration kMaxLateness(kTimingWheelResolution * 10);
+  handles.clear();
+  for (int i(0); i < kCount; ++i) {
+    const Duration kTimeout(std::chrono::milliseconds(50 + RandomUint32() % 1500));
+    const auto kDue(std::chrono::steady_clock::now() + kTimeout);
+    handles.emplace_back(timing_wheel.Arm(kTimeout, [&, kDue] {
+      const auto kNow(std::chrono::steady_clock::now());
+      if (kNow < kDue)
+        ++early_count;
+      else if (kNow - kDue > kMaxLateness)
+        ++late_count;
+      if (++fired_count == kCount / 2)
+        all_fired.set_value();
+    }));
+  }
+  for (int i(0); i < kCount; i += 2)
+    EXPECT_TRUE(handles[i].Cancel());
+
+  ASSERT_EQ(std::future_status::ready, all_fired.get_future().wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(kCount / 2, fired_count);
+  EXPECT_EQ(0, early_count);
+  EXPECT_EQ(0, late_count);
+  EXPECT_EQ(0U, timing_wheel.PendingCount());
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,99 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_event_log.h"
+
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/vault_manager/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+VaultEvent MakeEvent(VaultEventType type) {
+  VaultEvent event;
+  event.type = type;
+  event.label = GenerateLabel();
+  return event;
+}
+
+}  // unnamed namespace
+
+TEST(VaultEventLogTest, BEH_SequenceAndReplay) {
+  VaultEventLog vault_event_log(10);
+  const std::uint64_t kFirst(vault_event_log.NextSequenceNumber());
+  EXPECT_NE(0U, kFirst);
+  EXPECT_TRUE(vault_event_log.Since(0).empty());
+
+  std::vector<VaultEvent> recorded;
+  for (auto type : {VaultEventType::kSpawned, VaultEventType::kStarted, VaultEventType::kJoined})
+    recorded.push_back(vault_event_log.Record(MakeEvent(type)));
+  for (std::size_t i(0); i < recorded.size(); ++i)
+    EXPECT_EQ(kFirst + i, recorded[i].sequence_number);
+
+  auto replayed(vault_event_log.Since(0));
+  ASSERT_EQ(recorded.size(), replayed.size());
+  for (std::size_t i(0); i < recorded.size(); ++i) {
+    EXPECT_EQ(recorded[i].sequence_number, replayed[i].sequence_number);
+    EXPECT_EQ(recorded[i].type, replayed[i].type);
+    EXPECT_EQ(recorded[i].label, replayed[i].label);
+  }
+
+  replayed = vault_event_log.Since(recorded[0].sequence_number);
+  ASSERT_EQ(2U, replayed.size());
+  EXPECT_EQ(recorded[1].sequence_number, replayed[0].sequence_number);
+  EXPECT_TRUE(vault_event_log.Since(recorded.back().sequence_number).empty());
+
+  // A later VaultManager run continues the sequence, so a subscriber resuming from this run's
+  // events gets everything retained by the new run.
+  VaultEventLog next_vault_event_log(10);
+  EXPECT_GT(next_vault_event_log.NextSequenceNumber(), recorded.back().sequence_number);
+  next_vault_event_log.Record(MakeEvent(VaultEventType::kSpawned));
+  EXPECT_EQ(1U, next_vault_event_log.Since(recorded.back().sequence_number).size());
+}
+
+TEST(VaultEventLogTest, BEH_HistoryIsBounded) {
+  const std::size_t kCapacity(5);
+  VaultEventLog vault_event_log(kCapacity);
+  std::vector<VaultEvent> recorded;
+  for (std::size_t i(0); i < kCapacity * 3; ++i)
+    recorded.push_back(vault_event_log.Record(MakeEvent(VaultEventType::kExited)));
+
+  auto replayed(vault_event_log.Since(0));
+  ASSERT_EQ(kCapacity, replayed.size());
+  EXPECT_EQ(recorded[recorded.size() - kCapacity].sequence_number,
+            replayed.front().sequence_number);
+  EXPECT_EQ(recorded.back().sequence_number, replayed.back().sequence_number);
+  // The gap between the requested and first replayed sequence number shows events were missed.
+  replayed = vault_event_log.Since(recorded.front().sequence_number);
+  ASSERT_EQ(kCapacity, replayed.size());
+  EXPECT_GT(replayed.front().sequence_number, recorded.front().sequence_number + 1);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
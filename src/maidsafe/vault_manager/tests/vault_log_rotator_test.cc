@@ -0,0 +1,128 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_log_rotator.h"
+
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+std::size_t CountCompressed(const fs::path& log_folder) {
+  std::size_t count(0);
+  for (fs::directory_iterator itr(log_folder), end; itr != end; ++itr) {
+    if (itr->path().extension() == ".gz")
+      ++count;
+  }
+  return count;
+}
+
+}  // unnamed namespace
+
+TEST(VaultLogRotatorTest, BEH_RotateOpenAndCompressClosedLogs) {
+  std::shared_ptr<fs::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultLogRotator")};
+  const std::time_t kNow{std::time(nullptr)};
+  const fs::path kClosedLog{*test_path / "closed.log"}, kEmptyLog{*test_path / "empty.log"},
+      kOpenLog{*test_path / "open.log"}, kSmallLog{*test_path / "small.log"};
+  ASSERT_TRUE(WriteFile(kClosedLog, std::string(50, 'c')));
+  ASSERT_TRUE(WriteFile(kEmptyLog, ""));
+  ASSERT_TRUE(WriteFile(kOpenLog, std::string(200, 'o')));
+  ASSERT_TRUE(WriteFile(kSmallLog, std::string(10, 's')));
+  fs::last_write_time(kClosedLog, kNow - 100);
+  fs::last_write_time(kEmptyLog, kNow - 100);
+
+  VaultLogRotator rotator{100, std::chrono::hours(1), 1 << 20};
+  rotator.Maintain(*test_path, kNow - 50);
+  // Closed logs are compressed (or removed if empty).  The open log which has reached the size
+  // limit is truncated rather than removed, since the vault may still be writing to it.
+  EXPECT_FALSE(fs::exists(kClosedLog));
+  EXPECT_FALSE(fs::exists(kEmptyLog));
+  ASSERT_TRUE(fs::exists(kOpenLog));
+  EXPECT_EQ(0U, fs::file_size(kOpenLog));
+  EXPECT_EQ(10U, fs::file_size(kSmallLog));
+  EXPECT_EQ(2U, CountCompressed(*test_path));
+
+  // Once no vault is writing, every remaining log is closed.
+  rotator.Maintain(*test_path, std::numeric_limits<std::time_t>::max());
+  EXPECT_FALSE(fs::exists(kOpenLog));
+  EXPECT_FALSE(fs::exists(kSmallLog));
+  EXPECT_EQ(3U, CountCompressed(*test_path));
+}
+
+TEST(VaultLogRotatorTest, BEH_RotateByAge) {
+  std::shared_ptr<fs::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultLogRotator")};
+  const fs::path kLog{*test_path / "vault.log"};
+  ASSERT_TRUE(WriteFile(kLog, "log"));
+
+  // The first sighting starts the clock, so a zero age rotates on the next pass.
+  VaultLogRotator rotator{1 << 20, std::chrono::seconds(0), 1 << 20};
+  rotator.Maintain(*test_path, 0);
+  EXPECT_EQ(0U, fs::file_size(kLog));
+  EXPECT_EQ(1U, CountCompressed(*test_path));
+  // Empty logs aren't rotated.
+  rotator.Maintain(*test_path, 0);
+  EXPECT_EQ(1U, CountCompressed(*test_path));
+}
+
+TEST(VaultLogRotatorTest, BEH_DeleteOldestOverBudget) {
+  std::shared_ptr<fs::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultLogRotator")};
+  const std::time_t kNow{std::time(nullptr)};
+  for (int i(0); i < 4; ++i) {
+    const fs::path kRotated{*test_path / ("vault.log." + std::to_string(i) + ".gz")};
+    ASSERT_TRUE(WriteFile(kRotated, std::string(100, 'r')));
+    fs::last_write_time(kRotated, kNow - 100 + i);
+  }
+  ASSERT_TRUE(WriteFile(*test_path / "vault.log", std::string(100, 'o')));
+
+  VaultLogRotator rotator{1 << 20, std::chrono::hours(1), 250};
+  rotator.Maintain(*test_path, 0);
+  EXPECT_FALSE(fs::exists(*test_path / "vault.log.0.gz"));
+  EXPECT_FALSE(fs::exists(*test_path / "vault.log.1.gz"));
+  EXPECT_FALSE(fs::exists(*test_path / "vault.log.2.gz"));
+  EXPECT_TRUE(fs::exists(*test_path / "vault.log.3.gz"));
+  EXPECT_TRUE(fs::exists(*test_path / "vault.log"));
+
+  // The open log is never deleted, even if it alone exceeds the budget.
+  VaultLogRotator{1 << 20, std::chrono::hours(1), 0}.Maintain(*test_path, 0);
+  EXPECT_TRUE(fs::exists(*test_path / "vault.log"));
+  EXPECT_EQ(0U, CountCompressed(*test_path));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
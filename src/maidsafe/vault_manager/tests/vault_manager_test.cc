@@ -18,16 +18,27 @@
 
 #include "maidsafe/vault_manager/vault_manager.h"
 
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <mutex>
 
+#include "asio/io_service_strand.hpp"
 #include "boost/filesystem/path.hpp"
 
+#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/common/tcp/connection.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/discovery_file.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_started.h"
 #include "maidsafe/vault_manager/tests/test_utils.h"
 
 namespace fs = boost::filesystem;
@@ -38,6 +49,37 @@ namespace vault_manager {
 
 namespace test {
 
+namespace {
+
+enum class Reply { kAnswered, kClosed, kNone };
+
+// Sends 'message' as the first on a new connection to the VaultManager listening on 'port'.  The
+// VaultManager closes unanswered new connections after kRpcTimeout, so a reply is only waited for
+// until half of that has elapsed.
+template <typename Message>
+Reply SendFirstMessage(tcp::Port port, Message message) {
+  AsioService asio_service{1};
+  asio::io_service::strand strand{asio_service.service()};
+  auto reply(std::make_shared<std::promise<Reply>>());
+  auto reply_flag(std::make_shared<std::once_flag>());
+  auto set_reply([reply, reply_flag](Reply value) {
+    std::call_once(*reply_flag, [&] { reply->set_value(value); });
+  });
+  tcp::ConnectionPtr connection{tcp::Connection::MakeShared(strand, port)};
+  connection->Start([set_reply](tcp::Message) { set_reply(Reply::kAnswered); },
+                    [set_reply] { set_reply(Reply::kClosed); });
+  Send(connection, std::move(message));
+  auto reply_future(reply->get_future());
+  Reply result{Reply::kNone};
+  if (reply_future.wait_for(kRpcTimeout / 2) == std::future_status::ready)
+    result = reply_future.get();
+  connection->Close();
+  asio_service.Stop();
+  return result;
+}
+
+}  // unnamed namespace
+
 TEST(VaultManagerTest, BEH_Basic) {
   std::shared_ptr<fs::path> test_env_root_dir{
       maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
@@ -49,6 +91,26 @@ TEST(VaultManagerTest, BEH_Basic) {
   std::this_thread::sleep_for(std::chrono::seconds(1));
 }
 
+TEST(VaultManagerTest, BEH_RejectsOtherProtocolVersions) {
+  std::shared_ptr<fs::path> test_env_root_dir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  SetEnvironment(tcp::Port{7777}, *test_env_root_dir, path_to_vault);
+
+  VaultManager vault_manager;
+  auto discovery_info(ReadDiscoveryFile(GetDiscoveryFilePath()));
+  ASSERT_TRUE(static_cast<bool>(discovery_info));
+  const tcp::Port kPort{discovery_info->port};
+  const std::uint32_t kOtherVersion{kProtocolVersion + 1};
+  const crypto::CipherText kTicket{NonEmptyString{RandomBytes(64)}};
+
+  EXPECT_EQ(Reply::kAnswered, SendFirstMessage(kPort, ValidateConnectionRequest(kProtocolVersion)));
+  EXPECT_EQ(Reply::kClosed, SendFirstMessage(kPort, ValidateConnectionRequest(kOtherVersion)));
+  EXPECT_EQ(Reply::kClosed, SendFirstMessage(kPort, ResumeSessionRequest(kOtherVersion, kTicket)));
+  EXPECT_EQ(Reply::kClosed,
+            SendFirstMessage(kPort, VaultStarted(kOtherVersion, process::GetProcessId())));
+}
+
 }  // namespace test
 
 }  // namespace vault_manager
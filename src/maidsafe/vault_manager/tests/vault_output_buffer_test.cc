@@ -0,0 +1,132 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_output_buffer.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+
+#ifndef MAIDSAFE_WIN32
+#include <unistd.h>
+#endif
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/convert.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(VaultOutputBufferTest, BEH_ReadFromCursor) {
+  VaultOutputBuffer buffer{8};
+  VaultOutput output{buffer.Read(0, 100)};
+  EXPECT_TRUE(output.data.empty());
+  EXPECT_EQ(0U, output.begin);
+  EXPECT_EQ(0U, output.next_cursor);
+
+  buffer.Append("abcde", 5);
+  output = buffer.Read(0, 3);
+  EXPECT_EQ("abc", output.data);
+  EXPECT_EQ(0U, output.begin);
+  EXPECT_EQ(3U, output.next_cursor);
+  output = buffer.Read(output.next_cursor, 100);
+  EXPECT_EQ("de", output.data);
+  EXPECT_EQ(3U, output.begin);
+  EXPECT_EQ(5U, output.next_cursor);
+
+  // Wrap around, overwriting "abc".
+  buffer.Append("fghij", 5);
+  EXPECT_EQ(2U, buffer.Begin());
+  EXPECT_EQ(10U, buffer.End());
+  output = buffer.Read(5, 100);
+  EXPECT_EQ("fghij", output.data);
+  EXPECT_EQ(5U, output.begin);
+  EXPECT_EQ(10U, output.next_cursor);
+  output = buffer.Read(0, 100);
+  EXPECT_EQ("cdefghij", output.data);
+  EXPECT_EQ(2U, output.begin);
+  EXPECT_EQ("hij", buffer.Tail(3));
+  EXPECT_EQ("cdefghij", buffer.Tail(100));
+
+  // Nothing new at the end, and a cursor from beyond the end restarts from the oldest byte.
+  output = buffer.Read(10, 100);
+  EXPECT_TRUE(output.data.empty());
+  EXPECT_EQ(10U, output.next_cursor);
+  output = buffer.Read(1000, 2);
+  EXPECT_EQ("cd", output.data);
+  EXPECT_EQ(2U, output.begin);
+
+  // An append larger than the capacity keeps only its end.
+  buffer.Append("0123456789ABCDEF", 16);
+  EXPECT_EQ(18U, buffer.Begin());
+  EXPECT_EQ(26U, buffer.End());
+  EXPECT_EQ("89ABCDEF", buffer.Read(0, 100).data);
+}
+
+#ifndef MAIDSAFE_WIN32
+TEST(VaultOutputBufferTest, BEH_ReaderPersistsTailOnClose) {
+  std::shared_ptr<fs::path> test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultOutputBuffer")};
+  const fs::path kPersistPath{*test_path / "logs" / "output.log"};
+  int pipe_fds[2];
+  ASSERT_EQ(0, pipe(pipe_fds));
+
+  AsioService asio_service(1);
+  auto output(std::make_shared<VaultOutputBuffer>(64));
+  std::shared_ptr<VaultOutputReader> reader;
+  std::promise<void> started;
+  asio_service.service().post([&] {
+    reader = VaultOutputReader::MakeShared(asio_service.service(), pipe_fds[0], output);
+    reader->PersistTailOnClose(kPersistPath, 10);
+    started.set_value();
+  });
+  started.get_future().get();
+
+  const std::string kOutput{"Some output\nand some more output\n"};
+  ASSERT_EQ(static_cast<ssize_t>(kOutput.size()),
+            write(pipe_fds[1], kOutput.data(), kOutput.size()));
+  ASSERT_EQ(0, close(pipe_fds[1]));
+
+  const auto kDeadline(std::chrono::steady_clock::now() + std::chrono::seconds(5));
+  while (!fs::exists(kPersistPath) && std::chrono::steady_clock::now() < kDeadline)
+    Sleep(std::chrono::milliseconds(10));
+  ASSERT_TRUE(fs::exists(kPersistPath));
+  EXPECT_EQ(kOutput.substr(kOutput.size() - 10), convert::ToString(ReadFile(kPersistPath).value()));
+
+  std::promise<VaultOutput> read;
+  asio_service.service().post([&] { read.set_value(output->Read(0, 100)); });
+  EXPECT_EQ(kOutput, read.get_future().get().data);
+  asio_service.Stop();
+}
+#endif
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
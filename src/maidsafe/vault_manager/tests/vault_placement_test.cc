@@ -0,0 +1,87 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_placement.h"
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(VaultPlacementTest, BEH_ChooseRoot) {
+  // Paths under "/a" are on filesystem 1, "/b" on 2 and "/c" on 3.  "/c" can't be queried.
+  std::map<std::uint64_t, std::uint64_t> available{{1, 1000}, {2, 1500}};
+  std::map<std::uint64_t, std::uint64_t> io_ticks{{1, 0}, {2, 0}};
+  VaultPlacement placement{{"/a", "/b", "/c"},
+                           [&](const fs::path& path) {
+                             FilesystemSpace space;
+                             space.id = static_cast<std::uint64_t>(path.string()[1] - 'a' + 1);
+                             if (space.id == 3)
+                               BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+                             space.available = available[space.id];
+                             return space;
+                           },
+                           [&](std::uint64_t id) { return io_ticks.at(id); }};
+  EXPECT_TRUE(placement.Enabled());
+  EXPECT_FALSE(VaultPlacement{std::vector<fs::path>{}}.Enabled());
+
+  // The most free space wins when neither root has vaults.
+  EXPECT_EQ(fs::path{"/b"}, placement.ChooseRoot({}));
+  // "/b" now has its 1500 shared between two vaults, against 1000 for one on "/a".
+  EXPECT_EQ(fs::path{"/a"}, placement.ChooseRoot({"/b/1"}));
+  EXPECT_EQ(fs::path{"/b"}, placement.ChooseRoot({"/b/1", "/a/2"}));
+  // Vault dirs which can't be queried aren't counted.
+  EXPECT_EQ(fs::path{"/b"}, placement.ChooseRoot({"/c/1", "/c/2"}));
+
+  // A busy device is avoided even though it has more space.
+  placement.SampleIoUtilisation();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  io_ticks[2] = 1000;
+  placement.SampleIoUtilisation();
+  EXPECT_EQ(fs::path{"/a"}, placement.ChooseRoot({}));
+  // Once it's idle again it's preferred again.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  placement.SampleIoUtilisation();
+  EXPECT_EQ(fs::path{"/b"}, placement.ChooseRoot({}));
+}
+
+TEST(VaultPlacementTest, BEH_NoUsableRoot) {
+  VaultPlacement placement{{"/a"}, [](const fs::path&) -> FilesystemSpace {
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }};
+  placement.SampleIoUtilisation();
+  EXPECT_THROW(placement.ChooseRoot({}), maidsafe_error);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,111 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_stats_history.h"
+
+#include <chrono>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/vault_manager/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+VaultStats MakeStats(std::uint64_t chunk_count, std::uint64_t get_requests,
+                     std::uint64_t put_requests) {
+  VaultStats stats;
+  stats.chunk_count = chunk_count;
+  stats.bytes_used = chunk_count * 1024;
+  stats.get_requests = get_requests;
+  stats.put_requests = put_requests;
+  stats.routing_table_size = 64;
+  return stats;
+}
+
+VaultStatus MakeStatus(const NonEmptyString& label, std::uint64_t max_disk_usage) {
+  VaultStatus status;
+  status.label = label;
+  status.max_disk_usage = DiskUsage{max_disk_usage};
+  return status;
+}
+
+}  // unnamed namespace
+
+TEST(VaultStatsHistoryTest, BEH_Aggregate) {
+  VaultStatsHistory history(10);
+  const auto kStart(std::chrono::steady_clock::now());
+  const NonEmptyString kLabel0(GenerateLabel()), kLabel1(GenerateLabel());
+  std::vector<VaultStatus> vaults{MakeStatus(kLabel0, 1000000), MakeStatus(kLabel1, 2000000)};
+  EXPECT_TRUE(history.GetHostStats(vaults).vaults.empty());
+
+  history.Add(kLabel0, MakeStats(10, 0, 0), kStart);
+  history.Add(kLabel0, MakeStats(20, 100, 50), kStart + std::chrono::seconds(10));
+  history.Add(kLabel1, MakeStats(5, 0, 0), kStart);
+
+  HostStats host_stats(history.GetHostStats(vaults));
+  ASSERT_EQ(2U, host_stats.vaults.size());
+  EXPECT_EQ(kLabel0, host_stats.vaults[0].label);
+  EXPECT_EQ(20U, host_stats.vaults[0].latest.chunk_count);
+  EXPECT_DOUBLE_EQ(10.0, host_stats.vaults[0].get_requests_per_second);
+  EXPECT_DOUBLE_EQ(5.0, host_stats.vaults[0].put_requests_per_second);
+  // A single sample gives no rate.
+  EXPECT_DOUBLE_EQ(0.0, host_stats.vaults[1].get_requests_per_second);
+  EXPECT_EQ(25U, host_stats.chunk_count);
+  EXPECT_EQ(25U * 1024, host_stats.bytes_used);
+  EXPECT_EQ(3000000U, host_stats.max_disk_usage.data);
+  EXPECT_DOUBLE_EQ(10.0, host_stats.get_requests_per_second);
+
+  // History of a vault which has gone is discarded.
+  vaults.pop_back();
+  EXPECT_EQ(1U, history.GetHostStats(vaults).vaults.size());
+  vaults.push_back(MakeStatus(kLabel1, 2000000));
+  EXPECT_EQ(1U, history.GetHostStats(vaults).vaults.size());
+}
+
+TEST(VaultStatsHistoryTest, BEH_BoundedHistoryAndRestart) {
+  VaultStatsHistory history(3);
+  const auto kStart(std::chrono::steady_clock::now());
+  const NonEmptyString kLabel(GenerateLabel());
+  const std::vector<VaultStatus> kVaults{MakeStatus(kLabel, 1000)};
+
+  // Only the last three samples (at 2s, 3s and 4s) are retained.
+  for (int i(0); i < 5; ++i)
+    history.Add(kLabel, MakeStats(0, i * i * 10, 0), kStart + std::chrono::seconds(i));
+  HostStats host_stats(history.GetHostStats(kVaults));
+  ASSERT_EQ(1U, host_stats.vaults.size());
+  EXPECT_DOUBLE_EQ((160.0 - 40.0) / 2.0, host_stats.vaults[0].get_requests_per_second);
+
+  // The counters restart with the vault, so earlier samples are ignored.
+  history.Add(kLabel, MakeStats(0, 5, 0), kStart + std::chrono::seconds(5));
+  history.Add(kLabel, MakeStats(0, 25, 0), kStart + std::chrono::seconds(7));
+  host_stats = history.GetHostStats(kVaults);
+  EXPECT_DOUBLE_EQ(10.0, host_stats.vaults[0].get_requests_per_second);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,273 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/timing_wheel.h"
+
+#include <utility>
+
+#include "asio/error.hpp"
+#include "boost/exception/diagnostic_information.hpp"
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+const std::chrono::steady_clock::duration kResolution{
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(kTimingWheelResolution)};
+
+}  // unnamed namespace
+
+asio::io_service::id TimingWheel::id;
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int TimingWheel::kLevels;
+const int TimingWheel::kSlotBits;
+const std::uint32_t TimingWheel::kSlotCount;
+const std::uint64_t TimingWheel::kSlotMask;
+const std::uint32_t TimingWheel::kNil;
+#endif
+
+bool TimingWheel::Handle::Cancel() { return wheel_ ? wheel_->Cancel(*this) : false; }
+
+TimingWheel::TimingWheel(asio::io_service& io_service)
+    : asio::io_service::service(io_service),
+      kEpoch_(std::chrono::steady_clock::now()),
+      mutex_(),
+      timer_(io_service),
+      current_tick_(0),
+      scheduled_tick_(0),
+      wait_pending_(false),
+      pending_count_(0),
+      free_head_(kNil),
+      entries_(),
+      slot_heads_() {
+  slot_heads_.fill(kNil);
+}
+
+TimingWheel::~TimingWheel() { assert(pending_count_ == 0); }
+
+TimingWheel& TimingWheel::Get(asio::io_service& io_service) {
+  return asio::use_service<TimingWheel>(io_service);
+}
+
+TimingWheel::Handle TimingWheel::Arm(std::chrono::steady_clock::duration timeout,
+                                     Functor on_expiry) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  const auto now(std::chrono::steady_clock::now());
+  // While idle the wheel doesn't tick, so catch up before working out where the new entry belongs.
+  if (pending_count_ == 0)
+    current_tick_ = TickAt(now);
+  std::uint64_t expiry_tick{
+      TickAt(now + timeout + kResolution - std::chrono::steady_clock::duration(1))};
+  if (expiry_tick <= current_tick_)
+    expiry_tick = current_tick_ + 1;
+
+  const std::uint32_t index{Allocate()};
+  Entry& entry(entries_[index]);
+  entry.expiry_tick = expiry_tick;
+  entry.on_expiry = std::move(on_expiry);
+  Link(index);
+  ++pending_count_;
+  ScheduleWake();
+  return Handle{this, index, entry.generation};
+}
+
+bool TimingWheel::Cancel(const Handle& handle) {
+  if (handle.wheel_ != this)
+    return false;
+  Functor discarded;  // Destroyed outside the lock in case it owns anything which calls back in.
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (handle.index_ >= entries_.size())
+      return false;
+    Entry& entry(entries_[handle.index_]);
+    if (entry.generation != handle.generation_ || entry.slot == kNil)
+      return false;
+    Unlink(handle.index_);
+    discarded = std::move(entry.on_expiry);
+    Release(handle.index_);
+    --pending_count_;
+  }
+  return true;
+}
+
+std::size_t TimingWheel::PendingCount() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return pending_count_;
+}
+
+void TimingWheel::shutdown_service() {
+  std::vector<Entry> discarded;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    discarded.swap(entries_);
+    slot_heads_.fill(kNil);
+    free_head_ = kNil;
+    pending_count_ = 0;
+    wait_pending_ = false;
+    std::error_code ignored_ec;
+    timer_.cancel(ignored_ec);
+  }
+}
+
+std::uint64_t TimingWheel::TickAt(std::chrono::steady_clock::time_point time_point) const {
+  return time_point <= kEpoch_ ? 0U : static_cast<std::uint64_t>((time_point - kEpoch_) /
+                                                                  kResolution);
+}
+
+std::uint32_t TimingWheel::Allocate() {
+  if (free_head_ == kNil) {
+    entries_.emplace_back();
+    return static_cast<std::uint32_t>(entries_.size() - 1);
+  }
+  const std::uint32_t index{free_head_};
+  free_head_ = entries_[index].next;
+  return index;
+}
+
+void TimingWheel::Release(std::uint32_t index) {
+  Entry& entry(entries_[index]);
+  entry.on_expiry = nullptr;
+  ++entry.generation;
+  entry.slot = kNil;
+  entry.previous = kNil;
+  entry.next = free_head_;
+  free_head_ = index;
+}
+
+void TimingWheel::Link(std::uint32_t index) {
+  Entry& entry(entries_[index]);
+  const std::uint64_t delta{entry.expiry_tick > current_tick_ ? entry.expiry_tick - current_tick_
+                                                              : 0U};
+  int level(0);
+  while (level < kLevels - 1 && delta >= (1ULL << (kSlotBits * (level + 1))))
+    ++level;
+  std::uint64_t tick{entry.expiry_tick};
+  const std::uint64_t kMaxDelta{(1ULL << (kSlotBits * kLevels)) - 1};
+  if (delta > kMaxDelta)  // Parked in the outermost slot; will be re-linked when cascaded.
+    tick = current_tick_ + kMaxDelta;
+
+  const std::uint32_t slot{static_cast<std::uint32_t>(
+      level * kSlotCount + ((tick >> (kSlotBits * level)) & kSlotMask))};
+  entry.slot = slot;
+  entry.previous = kNil;
+  entry.next = slot_heads_[slot];
+  if (entry.next != kNil)
+    entries_[entry.next].previous = index;
+  slot_heads_[slot] = index;
+}
+
+void TimingWheel::Unlink(std::uint32_t index) {
+  Entry& entry(entries_[index]);
+  if (entry.previous != kNil)
+    entries_[entry.previous].next = entry.next;
+  else
+    slot_heads_[entry.slot] = entry.next;
+  if (entry.next != kNil)
+    entries_[entry.next].previous = entry.previous;
+  entry.slot = kNil;
+  entry.previous = kNil;
+  entry.next = kNil;
+}
+
+void TimingWheel::Cascade(int level, std::uint32_t slot_index) {
+  const std::uint32_t slot{level * kSlotCount + slot_index};
+  std::uint32_t index{slot_heads_[slot]};
+  slot_heads_[slot] = kNil;
+  while (index != kNil) {
+    const std::uint32_t next{entries_[index].next};
+    Link(index);
+    index = next;
+  }
+}
+
+std::uint64_t TimingWheel::NextWakeTick() const {
+  // Either the next occupied innermost slot, or the next tick at which outer levels cascade.
+  for (std::uint64_t tick(current_tick_ + 1);; ++tick) {
+    if ((tick & kSlotMask) == 0 || slot_heads_[tick & kSlotMask] != kNil)
+      return tick;
+  }
+}
+
+void TimingWheel::ScheduleWake() {
+  const std::uint64_t wake_tick{NextWakeTick()};
+  if (wait_pending_ && scheduled_tick_ <= wake_tick)
+    return;
+  scheduled_tick_ = wake_tick;
+  wait_pending_ = true;
+  timer_.expires_at(kEpoch_ +
+                    kResolution * static_cast<std::chrono::steady_clock::rep>(wake_tick));
+  timer_.async_wait([this](const std::error_code& error_code) { OnTimerExpiry(error_code); });
+}
+
+void TimingWheel::OnTimerExpiry(const std::error_code& error_code) {
+  if (error_code == asio::error::operation_aborted)
+    return;
+  if (error_code)
+    LOG(kError) << "Error waiting for timing wheel tick: " << error_code.message();
+
+  std::vector<Functor> expired;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    wait_pending_ = false;
+    const std::uint64_t now_tick{TickAt(std::chrono::steady_clock::now())};
+    while (current_tick_ < now_tick && pending_count_ != 0) {
+      ++current_tick_;
+      const std::uint32_t inner_slot{static_cast<std::uint32_t>(current_tick_ & kSlotMask)};
+      if (inner_slot == 0) {
+        for (int level(1); level < kLevels; ++level) {
+          const std::uint32_t slot_index{
+              static_cast<std::uint32_t>((current_tick_ >> (kSlotBits * level)) & kSlotMask)};
+          Cascade(level, slot_index);
+          if (slot_index != 0)
+            break;
+        }
+      }
+      while (slot_heads_[inner_slot] != kNil) {
+        const std::uint32_t index{slot_heads_[inner_slot]};
+        Unlink(index);
+        expired.emplace_back(std::move(entries_[index].on_expiry));
+        Release(index);
+        --pending_count_;
+      }
+    }
+    if (pending_count_ == 0)
+      current_tick_ = now_tick;
+    else
+      ScheduleWake();
+  }
+
+  for (auto& on_expiry : expired) {
+    try {
+      if (on_expiry)
+        on_expiry();
+    } catch (const std::exception& e) {
+      LOG(kError) << "Error executing timing wheel functor: " << boost::diagnostic_information(e);
+    } catch (...) {
+      LOG(kError) << "Unknown error type while executing timing wheel functor.";
+    }
+  }
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
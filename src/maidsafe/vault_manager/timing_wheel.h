@@ -0,0 +1,124 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_TIMING_WHEEL_H_
+#define MAIDSAFE_VAULT_MANAGER_TIMING_WHEEL_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "asio/steady_timer.hpp"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// A hierarchical timing wheel registered as a service on an asio::io_service, so that every
+// component sharing an io_service also shares a single underlying steady_timer.  Arming a deadline
+// reuses a slot from an internal pool and cancelling one is O(1).  Expiry functors are invoked on a
+// thread running the io_service, outside the wheel's internal lock.
+//
+// Deadlines are rounded up to the next multiple of kTimingWheelResolution.  All public functions
+// are thread-safe.
+class TimingWheel : public asio::io_service::service {
+ public:
+  typedef std::function<void()> Functor;
+
+  // Copyable reference to an armed deadline.  Cancelling a default-constructed, already-cancelled
+  // or already-expired handle is a harmless no-op.  A handle must not be used after the
+  // io_service owning its wheel has been destroyed.
+  class Handle {
+   public:
+    Handle() : wheel_(nullptr), index_(0), generation_(0) {}
+    // Returns true if the deadline was still pending and has now been cancelled.
+    bool Cancel();
+
+   private:
+    friend class TimingWheel;
+    Handle(TimingWheel* wheel, std::uint32_t index, std::uint32_t generation)
+        : wheel_(wheel), index_(index), generation_(generation) {}
+
+    TimingWheel* wheel_;
+    std::uint32_t index_, generation_;
+  };
+
+  static asio::io_service::id id;
+
+  explicit TimingWheel(asio::io_service& io_service);
+  ~TimingWheel();
+
+  // Returns the wheel shared by all users of 'io_service', creating it if required.
+  static TimingWheel& Get(asio::io_service& io_service);
+
+  Handle Arm(std::chrono::steady_clock::duration timeout, Functor on_expiry);
+  bool Cancel(const Handle& handle);
+  std::size_t PendingCount() const;
+
+ private:
+  TimingWheel(const TimingWheel&) = delete;
+  TimingWheel(TimingWheel&&) = delete;
+  TimingWheel& operator=(TimingWheel) = delete;
+
+  static const int kLevels = 4;
+  static const int kSlotBits = 6;
+  static const std::uint32_t kSlotCount = 1U << kSlotBits;
+  static const std::uint64_t kSlotMask = kSlotCount - 1;
+  static const std::uint32_t kNil = static_cast<std::uint32_t>(-1);
+
+  struct Entry {
+    Entry() : expiry_tick(0), on_expiry(), generation(0), slot(kNil), previous(kNil), next(kNil) {}
+    std::uint64_t expiry_tick;
+    Functor on_expiry;
+    std::uint32_t generation, slot, previous, next;
+  };
+
+  void shutdown_service() override;
+
+  std::uint64_t TickAt(std::chrono::steady_clock::time_point time_point) const;
+  std::uint32_t Allocate();
+  void Release(std::uint32_t index);
+  void Link(std::uint32_t index);
+  void Unlink(std::uint32_t index);
+  void Cascade(int level, std::uint32_t slot_index);
+  std::uint64_t NextWakeTick() const;
+  void ScheduleWake();
+  void OnTimerExpiry(const std::error_code& error_code);
+
+  const std::chrono::steady_clock::time_point kEpoch_;
+  mutable std::mutex mutex_;
+  Timer timer_;
+  std::uint64_t current_tick_, scheduled_tick_;
+  bool wait_pending_;
+  std::size_t pending_count_;
+  std::uint32_t free_head_;
+  std::vector<Entry> entries_;
+  std::array<std::uint32_t, kLevels * kSlotCount> slot_heads_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_TIMING_WHEEL_H_
@@ -18,7 +18,13 @@
 
 #include "maidsafe/vault_manager/tools/actions/start_network.h"
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <exception>
 #include <limits>
+#include <map>
+#include <set>
 #include <memory>
 #include <string>
 #include <thread>
@@ -155,48 +161,104 @@ std::future<std::unique_ptr<passport::PmidAndSigner>> StartVault(
 #endif
 }
 
-void StartFirstTwoVaults(LocalNetworkController* local_network_controller, DiskUsage max_usage) {
-  TLOG(kDefaultColour) << "Starting vault 1\n";  // index 2 in pmid list
-  std::string vault_dir_name{DebugId(GetPmidAndSigner(2).first.name().value)};
-  fs::create_directories(local_network_controller->test_env_root_dir / vault_dir_name);
-  auto first_vault_future(StartVault(local_network_controller,
-                                     local_network_controller->test_env_root_dir / vault_dir_name,
-                                     max_usage, 2));
-  try {
-    first_vault_future.get();
-  } catch (const std::exception& e) {
-    LOG(kWarning) << boost::diagnostic_information(e);
-  }
-  Sleep(std::chrono::seconds(3));
-
-  TLOG(kDefaultColour) << "Starting vault 2\n";  // index 3 in pmid list
-  vault_dir_name = DebugId(GetPmidAndSigner(3).first.name().value);
-  fs::create_directories(local_network_controller->test_env_root_dir / vault_dir_name);
-  auto second_vault_future(StartVault(local_network_controller,
-                                      local_network_controller->test_env_root_dir / vault_dir_name,
-                                      max_usage, 3));
-  try {
-    second_vault_future.get();
-  } catch (const std::exception& e) {
-    LOG(kWarning) << boost::diagnostic_information(e);
-  }
-  Sleep(std::chrono::seconds(3));
+std::future<std::unique_ptr<passport::PmidAndSigner>> StartVault(
+    LocalNetworkController* local_network_controller, DiskUsage max_usage, int pmid_list_index) {
+  const fs::path kVaultDir{local_network_controller->test_env_root_dir /
+                           DebugId(GetPmidAndSigner(pmid_list_index).first.name().value)};
+  fs::create_directories(kVaultDir);
+  return StartVault(local_network_controller, kVaultDir, max_usage, pmid_list_index);
 }
 
-void StartRemainingVaults(LocalNetworkController* local_network_controller, DiskUsage max_usage) {
-  const int kRemainingIndex(local_network_controller->vault_count + 2);
-  for (int i(4); i < kRemainingIndex; ++i) {
+// The first two vaults bootstrap off the zero state nodes, so are started one at a time.
+void StartFirstTwoVaults(LocalNetworkController* local_network_controller, DiskUsage max_usage,
+                         JoinTracker& join_tracker) {
+  int joined_count(join_tracker.JoinedCount());
+  for (int i(2); i < 4; ++i) {
     TLOG(kDefaultColour) << "Starting vault " << i - 1 << '\n';  // index i in pmid list
-    std::string vault_dir_name{DebugId(GetPmidAndSigner(i).first.name().value)};
-    fs::create_directories(local_network_controller->test_env_root_dir / vault_dir_name);
-    auto vault_future(StartVault(local_network_controller,
-                                 local_network_controller->test_env_root_dir / vault_dir_name,
-                                 max_usage, i));
-    vault_future.get();
-    Sleep(std::chrono::milliseconds(500));
+    auto vault_future(StartVault(local_network_controller, max_usage, i));
+    try {
+      vault_future.get();
+    } catch (const std::exception& e) {
+      LOG(kWarning) << boost::diagnostic_information(e);
+      continue;
+    }
+    if (!join_tracker.WaitForJoinedCount(++joined_count, GetDefault().kVaultJoinTimeout))
+      TLOG(kYellow) << "Vault " << i - 1 << " hasn't reported joining the network\n";
   }
 }
 
+// Starts the remaining vaults concurrently, keeping no more than 'max_vaults_joining' started but
+// not yet joined.  A vault which fails to start is retried up to kVaultStartAttempts times.
+void StartRemainingVaults(LocalNetworkController* local_network_controller, DiskUsage max_usage,
+                          JoinTracker& join_tracker) {
+  const int kMaxJoining(std::max(local_network_controller->max_vaults_joining, 1));
+  // Only joins by vaults started here are counted, so that a late join by an earlier vault doesn't
+  // let an extra vault start.
+  std::set<NonEmptyString> earlier_labels;
+  for (const auto& vault_status : local_network_controller->client_interface->ListVaults().get())
+    earlier_labels.insert(vault_status.label);
+  std::deque<int> queued;
+  for (int i(4); i < local_network_controller->vault_count + 2; ++i)
+    queued.push_back(i);
+  std::map<int, int> attempts;
+  std::map<int, std::future<std::unique_ptr<passport::PmidAndSigner>>> starting;
+  std::exception_ptr failure;
+  // Vaults which haven't reported joining within kVaultJoinTimeout are presumed to have joined, so
+  // that a vault which never reports doesn't stall the rest.
+  int started(0), presumed_joined(0);
+  auto last_progress(std::chrono::steady_clock::now());
+  auto joining([&] {
+    return started + static_cast<int>(starting.size()) - presumed_joined -
+           join_tracker.JoinedCount(earlier_labels);
+  });
+
+  while (!queued.empty() || !starting.empty()) {
+    while (!queued.empty() && joining() < kMaxJoining) {
+      const int kIndex(queued.front());
+      queued.pop_front();
+      TLOG(kDefaultColour) << "Starting vault " << kIndex - 1 << '\n';  // index kIndex in pmid list
+      ++attempts[kIndex];
+      starting.emplace(kIndex, StartVault(local_network_controller, max_usage, kIndex));
+    }
+
+    for (auto itr(std::begin(starting)); itr != std::end(starting);) {
+      if (itr->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        ++itr;
+        continue;
+      }
+      try {
+        itr->second.get();
+        ++started;
+      } catch (const std::exception& e) {
+        LOG(kWarning) << boost::diagnostic_information(e);
+        if (attempts[itr->first] < GetDefault().kVaultStartAttempts) {
+          TLOG(kYellow) << "Failed to start vault " << itr->first - 1 << " - retrying\n";
+          queued.push_back(itr->first);
+        } else {
+          TLOG(kRed) << "Failed to start vault " << itr->first - 1 << '\n';
+          failure = std::current_exception();
+        }
+      }
+      itr = starting.erase(itr);
+      last_progress = std::chrono::steady_clock::now();
+    }
+
+    const int kJoined(join_tracker.JoinedCount());
+    if (join_tracker.WaitForJoinedCount(kJoined + 1, std::chrono::milliseconds(100))) {
+      last_progress = std::chrono::steady_clock::now();
+    } else if (!queued.empty() && joining() >= kMaxJoining &&
+               std::chrono::steady_clock::now() - last_progress > GetDefault().kVaultJoinTimeout) {
+      TLOG(kYellow) << "No vault has reported joining the network for "
+                    << GetDefault().kVaultJoinTimeout.count() << "s - starting the next anyway\n";
+      ++presumed_joined;
+      last_progress = std::chrono::steady_clock::now();
+    }
+  }
+
+  if (failure)
+    std::rethrow_exception(failure);
+}
+
 }  // unnamed namespace
 
 class PublicPmidStorer {
@@ -244,17 +306,24 @@ class PublicPmidStorer {
 
 
 void StartNetwork(LocalNetworkController* local_network_controller) {
-  TLOG(kDefaultColour) << "\nCreating " << local_network_controller->vault_count
-                       << " sets of Pmid keys (this may take a while)\n";
+  if (local_network_controller->key_chain_path.empty()) {
+    TLOG(kDefaultColour) << "\nCreating " << local_network_controller->vault_count + 2
+                         << " sets of Pmid keys (this may take a while)\n";
+  } else {
+    TLOG(kDefaultColour) << "\nLoading " << local_network_controller->vault_count + 2
+                         << " sets of Pmid keys from " << local_network_controller->key_chain_path
+                         << " (any missing will be created and saved there)\n";
+  }
   ClientInterface::SetTestEnvironment(
       static_cast<tcp::Port>(local_network_controller->vault_manager_port),
       local_network_controller->test_env_root_dir, local_network_controller->path_to_vault,
-      local_network_controller->vault_count + 2);
+      local_network_controller->vault_count + 2, local_network_controller->key_chain_path);
 
   auto space_info(fs::space(local_network_controller->test_env_root_dir));
   DiskUsage max_usage{(9 * space_info.available) / (10 * local_network_controller->vault_count)};
   std::promise<void> zero_state_nodes_started, finished_with_zero_state_nodes;
   std::thread zero_state_launcher;
+  std::unique_ptr<JoinTracker> join_tracker;
   try {
     zero_state_launcher = std::move(std::thread{[&] {
       StartZeroStateRoutingNodes(zero_state_nodes_started,
@@ -263,7 +332,9 @@ void StartNetwork(LocalNetworkController* local_network_controller) {
     zero_state_nodes_started.get_future().get();
     Sleep(std::chrono::seconds(1));
     StartVaultManagerAndClientInterface(local_network_controller);
-    StartFirstTwoVaults(local_network_controller, max_usage);
+    join_tracker =
+        maidsafe::make_unique<JoinTracker>(*local_network_controller->client_interface);
+    StartFirstTwoVaults(local_network_controller, max_usage, *join_tracker);
 
     finished_with_zero_state_nodes.set_value();
     zero_state_launcher.join();
@@ -279,10 +350,27 @@ void StartNetwork(LocalNetworkController* local_network_controller) {
   // Copies "local_network_bootstrap.dat" to "bootstrap_override.dat".
   maidsafe::test::PrepareBootstrapFile(routing::test::LocalNetworkBootstrapFile());
 
-  StartRemainingVaults(local_network_controller, max_usage);
+  StartRemainingVaults(local_network_controller, max_usage, *join_tracker);
   TLOG(kDefaultColour) << "Started Network of " << local_network_controller->vault_count
                        << " Vaults - waiting for network to stabilise\n";
-  Sleep(std::chrono::seconds(local_network_controller->vault_count * 10));
+  const auto kStableTimeout(local_network_controller->network_stable_timeout.count() > 0
+                                ? local_network_controller->network_stable_timeout
+                                : std::chrono::seconds(local_network_controller->vault_count * 10));
+  const double kStableFraction(
+      std::min(std::max(local_network_controller->network_stable_fraction, 0.0), 1.0));
+  const int kRequiredJoins(std::max(
+      static_cast<int>(std::ceil(kStableFraction * local_network_controller->vault_count)), 1));
+  if (join_tracker->WaitUntilSettled(kRequiredJoins, GetDefault().kNetworkQuietPeriod,
+                                     kStableTimeout)) {
+    TLOG(kDefaultColour) << join_tracker->JoinedCount() << " of "
+                         << local_network_controller->vault_count
+                         << " Vaults have joined and the network has settled\n";
+  } else {
+    TLOG(kYellow) << "Only " << join_tracker->JoinedCount() << " of "
+                  << local_network_controller->vault_count << " Vaults have joined after "
+                  << kStableTimeout.count() << "s - continuing anyway\n";
+  }
+  join_tracker.reset();
 
   TLOG(kDefaultColour) << "Storing PublicPmid keys (this may take a while)\n";
   {
@@ -44,6 +44,11 @@ Default::Default()
       kVaultManagerPort(44444),
       kVaultCountNewNetwork(16),
       kVaultCount(1),
+      kMaxVaultsJoining(4),
+      kVaultStartAttempts(3),
+      kVaultJoinTimeout(60),
+      kNetworkQuietPeriod(15),
+      kNetworkStableFraction(0.9),
       kCreateTestRootDir(true),
       kClearTestRootDir(true),
       kSendHostnameToVisualiserServer(false) {}
@@ -53,7 +58,8 @@ const Default& GetDefault() {
   return the_defaults;
 }
 
-LocalNetworkController::LocalNetworkController(const boost::filesystem::path& script_path)
+LocalNetworkController::LocalNetworkController(const boost::filesystem::path& script_path,
+                                               const boost::filesystem::path& key_chain_path_in)
     : script_commands(),
       entered_commands(1, {"### Commands begin."}),
       current_command(),
@@ -62,8 +68,12 @@ LocalNetworkController::LocalNetworkController(const boost::filesystem::path& sc
       test_env_root_dir(),
       path_to_vault(),
       path_to_bootstrap_file(),
+      key_chain_path(key_chain_path_in),
       vault_manager_port(0),
       vault_count(0),
+      max_vaults_joining(GetDefault().kMaxVaultsJoining),
+      network_stable_timeout(0),
+      network_stable_fraction(GetDefault().kNetworkStableFraction),
       new_network(false),
       vlog_session_id(),
       send_hostname_to_visualiser_server() {
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_TOOLS_LOCAL_NETWORK_CONTROLLER_H_
 #define MAIDSAFE_VAULT_MANAGER_TOOLS_LOCAL_NETWORK_CONTROLLER_H_
 
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <string>
@@ -47,6 +48,20 @@ struct Default {
   const int kVaultManagerPort;
   const int kVaultCountNewNetwork;
   const int kVaultCount;
+  // Vaults started by StartNetwork beyond the first two are started concurrently, but no more than
+  // this many are left waiting to join the network at a time.
+  const int kMaxVaultsJoining;
+  const int kVaultStartAttempts;
+  // If no vault joins for this long, the next vault is started regardless.
+  const std::chrono::seconds kVaultJoinTimeout;
+  // Once enough vaults have joined (see kNetworkStableFraction), the network is treated as stable
+  // when no vault has joined or rejoined for this long.  If that hasn't happened after the stable
+  // timeout (which defaults to 10s per vault), the network is treated as stable regardless.
+  const std::chrono::seconds kNetworkQuietPeriod;
+  // The fraction of the network's vaults, rounded up, which must have joined before the network can
+  // be treated as stable.  Allows a few vaults which fail to join not to delay setup until the
+  // stable timeout.
+  const double kNetworkStableFraction;
   const bool kCreateTestRootDir;
   const bool kClearTestRootDir;
   const bool kSendHostnameToVisualiserServer;
@@ -55,15 +70,21 @@ struct Default {
 const Default& GetDefault();
 
 struct LocalNetworkController {
-  explicit LocalNetworkController(const boost::filesystem::path& script_path);
+  // If 'key_chain_path' is non-empty, a new network's Pmids are taken from that key chain file,
+  // which is created on first use (see ClientInterface::SetTestEnvironment).
+  LocalNetworkController(const boost::filesystem::path& script_path,
+                         const boost::filesystem::path& key_chain_path);
   ~LocalNetworkController();
   std::deque<std::string> script_commands;
   std::vector<std::string> entered_commands;
   std::unique_ptr<Command> current_command;
   std::unique_ptr<ClientInterface> client_interface;
   std::unique_ptr<VaultManager> vault_manager;
-  boost::filesystem::path test_env_root_dir, path_to_vault, path_to_bootstrap_file;
-  int vault_manager_port, vault_count;
+  boost::filesystem::path test_env_root_dir, path_to_vault, path_to_bootstrap_file, key_chain_path;
+  int vault_manager_port, vault_count, max_vaults_joining;
+  // Zero to use the default.
+  std::chrono::seconds network_stable_timeout;
+  double network_stable_fraction;
   bool new_network;
   std::unique_ptr<std::string> vlog_session_id;
   std::unique_ptr<bool> send_hostname_to_visualiser_server;
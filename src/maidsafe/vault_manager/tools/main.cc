@@ -16,6 +16,13 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/error.h"
@@ -24,17 +31,75 @@
 #include "maidsafe/vault_manager/tools/commands/commands.h"
 #include "maidsafe/vault_manager/tools/local_network_controller.h"
 
+namespace {
+
+// Returns the value of a numeric command line option, or reports the problem and throws if the
+// value isn't a number in the range [min_value, max_value].
+template <typename Number>
+Number ParseNumericOption(const std::string& option, const std::string& value, Number min_value,
+                          Number max_value) {
+  // Parsed at full width so that out-of-range values aren't truncated before being checked.
+  typedef typename std::conditional<std::is_integral<Number>::value, long long, double>::type Wide;
+  std::size_t parsed_size(0);
+  Wide number(0);
+  try {
+    number = std::is_integral<Number>::value ? static_cast<Wide>(std::stoll(value, &parsed_size))
+                                             : static_cast<Wide>(std::stod(value, &parsed_size));
+  } catch (const std::logic_error&) {
+    parsed_size = 0;
+  }
+  // Written so that a NaN fails the range check.
+  if (parsed_size == 0 || parsed_size != value.size() ||
+      !(number >= static_cast<Wide>(min_value) && number <= static_cast<Wide>(max_value))) {
+    TLOG(kRed) << "Invalid option \"" << option << value << "\" - expected a number from "
+               << min_value << " to " << max_value << "\n";
+    BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+  }
+  return static_cast<Number>(number);
+}
+
+}  // unnamed namespace
+
 int main(int argc, char* argv[]) {
   try {
-    boost::filesystem::path script_path;
+    boost::filesystem::path script_path, key_chain_path;
+    int max_vaults_joining(maidsafe::vault_manager::tools::GetDefault().kMaxVaultsJoining);
+    int network_stable_timeout_s(0);
+    double network_stable_fraction(
+        maidsafe::vault_manager::tools::GetDefault().kNetworkStableFraction);
     // TODO(Fraser#5#): 2014-05-19 - Use program options to input script_path and help
     auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
-    if (unuseds.size() == 2U)
-      script_path = boost::filesystem::path{std::string{&unuseds[1][0]}};
-    else if (unuseds.size() != 1U)
-      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+    const std::string kKeyChainOption{"--key_chain_file="},
+        kMaxJoiningOption{"--max_vaults_joining="},
+        kStableTimeoutOption{"--network_stable_timeout_s="},
+        kStableFractionOption{"--network_stable_fraction="};
+    for (std::size_t i(1); i < unuseds.size(); ++i) {
+      const std::string kArg{&unuseds[i][0]};
+      if (kArg.compare(0, kKeyChainOption.size(), kKeyChainOption) == 0)
+        key_chain_path = boost::filesystem::path{kArg.substr(kKeyChainOption.size())};
+      else if (kArg.compare(0, kMaxJoiningOption.size(), kMaxJoiningOption) == 0)
+        max_vaults_joining =
+            ParseNumericOption(kMaxJoiningOption, kArg.substr(kMaxJoiningOption.size()), 1,
+                               std::numeric_limits<int>::max());
+      else if (kArg.compare(0, kStableTimeoutOption.size(), kStableTimeoutOption) == 0)
+        network_stable_timeout_s =
+            ParseNumericOption(kStableTimeoutOption, kArg.substr(kStableTimeoutOption.size()), 0,
+                               std::numeric_limits<int>::max());
+      else if (kArg.compare(0, kStableFractionOption.size(), kStableFractionOption) == 0)
+        network_stable_fraction = ParseNumericOption(
+            kStableFractionOption, kArg.substr(kStableFractionOption.size()), 0.0, 1.0);
+      else if (script_path.empty())
+        script_path = boost::filesystem::path{kArg};
+      else
+        BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+    }
 
-    maidsafe::vault_manager::tools::LocalNetworkController local_network_controller{script_path};
+    maidsafe::vault_manager::tools::LocalNetworkController local_network_controller{
+        script_path, key_chain_path};
+    local_network_controller.max_vaults_joining = max_vaults_joining;
+    local_network_controller.network_stable_timeout =
+        std::chrono::seconds(network_stable_timeout_s);
+    local_network_controller.network_stable_fraction = network_stable_fraction;
     for (;;) {
       local_network_controller.current_command->PrintTitle();
       local_network_controller.current_command->GetChoice();
@@ -17,7 +17,12 @@
     use of the MaidSafe Software.                                                                 */
 
 #include "maidsafe/vault_manager/tools/utils.h"
+
+#include <algorithm>
+
+#include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
+#include "maidsafe/common/utils.h"
 
 #include "maidsafe/vault_manager/tools/local_network_controller.h"
 
@@ -35,6 +40,67 @@ void StartVaultManagerAndClientInterface(LocalNetworkController* local_network_c
       maidsafe::make_unique<ClientInterface>(maid_and_signer.first);
 }
 
+JoinTracker::JoinTracker(ClientInterface& client_interface)
+    : client_interface_(client_interface),
+      mutex_(),
+      cond_var_(),
+      joined_labels_(),
+      last_join_time_(std::chrono::steady_clock::now()) {
+  client_interface_.SubscribeToVaultEvents(
+      [this](const VaultEvent& vault_event) { HandleVaultEvent(vault_event); });
+}
+
+JoinTracker::~JoinTracker() { client_interface_.UnsubscribeFromVaultEvents(); }
+
+int JoinTracker::JoinedCount() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return static_cast<int>(joined_labels_.size());
+}
+
+int JoinTracker::JoinedCount(const std::set<NonEmptyString>& excluded_labels) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return static_cast<int>(std::count_if(
+      std::begin(joined_labels_), std::end(joined_labels_),
+      [&](const NonEmptyString& label) { return excluded_labels.count(label) == 0; }));
+}
+
+bool JoinTracker::WaitForJoinedCount(int count, std::chrono::steady_clock::duration timeout) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  return cond_var_.wait_for(lock, timeout, [this, count] {
+    return static_cast<int>(joined_labels_.size()) >= count;
+  });
+}
+
+bool JoinTracker::WaitUntilSettled(int count, std::chrono::steady_clock::duration quiet_period,
+                                   std::chrono::steady_clock::duration timeout) {
+  const auto kDeadline(std::chrono::steady_clock::now() + timeout);
+  std::unique_lock<std::mutex> lock{mutex_};
+  for (;;) {
+    const auto kNow(std::chrono::steady_clock::now());
+    const bool kEnoughJoined{static_cast<int>(joined_labels_.size()) >= count};
+    if (kEnoughJoined && kNow - last_join_time_ >= quiet_period)
+      return true;
+    if (kNow >= kDeadline)
+      return false;
+    // Woken by each join, which restarts the quiet period.
+    cond_var_.wait_until(lock, kEnoughJoined ? std::min(kDeadline, last_join_time_ + quiet_period)
+                                             : kDeadline);
+  }
+}
+
+void JoinTracker::HandleVaultEvent(const VaultEvent& vault_event) {
+  if (vault_event.type != VaultEventType::kJoined)
+    return;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    const bool kRejoined{!joined_labels_.insert(vault_event.label).second};
+    last_join_time_ = std::chrono::steady_clock::now();
+    LOG(kInfo) << "Vault " << hex::Encode(vault_event.label) << " has "
+               << (kRejoined ? "rejoined" : "joined") << " the network.";
+  }
+  cond_var_.notify_all();
+}
+
 }  // namespace tools
 
 }  // namespace vault_manager
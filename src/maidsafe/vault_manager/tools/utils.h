@@ -19,6 +19,15 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_TOOLS_UTILS_H_
 #define MAIDSAFE_VAULT_MANAGER_TOOLS_UTILS_H_
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/client_interface.h"
+#include "maidsafe/vault_manager/vault_event.h"
 
 namespace maidsafe {
 
@@ -30,6 +39,38 @@ struct LocalNetworkController;
 
 void StartVaultManagerAndClientInterface(LocalNetworkController* local_network_controller);
 
+// Counts the vaults which have joined the network, as reported via the VaultManager's vault events.
+// A vault which rejoins after being restarted is only counted once, but its rejoining still counts
+// as network activity for WaitUntilSettled.
+class JoinTracker {
+ public:
+  explicit JoinTracker(ClientInterface& client_interface);
+  ~JoinTracker();
+  JoinTracker(const JoinTracker&) = delete;
+  JoinTracker(JoinTracker&&) = delete;
+  JoinTracker& operator=(JoinTracker) = delete;
+
+  int JoinedCount() const;
+  // Returns how many vaults other than those in 'excluded_labels' have joined.
+  int JoinedCount(const std::set<NonEmptyString>& excluded_labels) const;
+  // Blocks until at least 'count' vaults have joined or 'timeout' has passed.  Returns true if
+  // 'count' was reached.
+  bool WaitForJoinedCount(int count, std::chrono::steady_clock::duration timeout);
+  // Blocks until at least 'count' vaults have joined and no vault has joined or rejoined for
+  // 'quiet_period', or until 'timeout' has passed.  Returns true in the former case.
+  bool WaitUntilSettled(int count, std::chrono::steady_clock::duration quiet_period,
+                        std::chrono::steady_clock::duration timeout);
+
+ private:
+  void HandleVaultEvent(const VaultEvent& vault_event);
+
+  ClientInterface& client_interface_;
+  mutable std::mutex mutex_;
+  std::condition_variable cond_var_;
+  std::set<NonEmptyString> joined_labels_;
+  std::chrono::steady_clock::time_point last_join_time_;
+};
+
 }  // namespace tools
 
 }  // namespace vault_manager
@@ -20,13 +20,20 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <mutex>
+#include <string>
 
 #include "boost/filesystem/operations.hpp"
+#include "cryptopp/hmac.h"
+#include "cryptopp/misc.h"
+#include "cryptopp/sha.h"
 
+#include "maidsafe/common/application_support_directories.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
@@ -37,13 +44,34 @@
 #include "maidsafe/vault_manager/vault_info.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/heartbeat.h"
+#include "maidsafe/vault_manager/messages/host_stats_request.h"
+#include "maidsafe/vault_manager/messages/host_stats_response.h"
+#include "maidsafe/vault_manager/messages/list_vaults_request.h"
+#include "maidsafe/vault_manager/messages/list_vaults_response.h"
 #include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_progress.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_request.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/resume_session_response.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
+#include "maidsafe/vault_manager/messages/start_vaults_request.h"
+#include "maidsafe/vault_manager/messages/subscribe_to_vault_events_request.h"
+#include "maidsafe/vault_manager/messages/tail_vault_output_request.h"
+#include "maidsafe/vault_manager/messages/tail_vault_output_response.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_drain_progress.h"
+#include "maidsafe/vault_manager/messages/vault_event_notification.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
+#include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
+#include "maidsafe/vault_manager/messages/vault_spawned.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
 #include "maidsafe/vault_manager/messages/vault_started_response.h"
+#include "maidsafe/vault_manager/messages/vault_stats_report.h"
 
 namespace fs = boost::filesystem;
 
@@ -54,17 +82,70 @@ namespace vault_manager {
 #if !defined(_MSC_VER) || _MSC_VER >= 1900
 const MessageTag Challenge::tag;
 const MessageTag ChallengeResponse::tag;
+const MessageTag Heartbeat::tag;
+const MessageTag HostStatsRequest::tag;
+const MessageTag HostStatsResponse::tag;
+const MessageTag ListVaultsRequest::tag;
+const MessageTag ListVaultsResponse::tag;
 const MessageTag LogMessage::tag;
 const MessageTag MaxDiskUsageUpdate::tag;
+const MessageTag MoveChunkstoreProgress::tag;
+const MessageTag MoveChunkstoreRequest::tag;
+const MessageTag MoveChunkstoreResponse::tag;
+const MessageTag ResumeSessionRequest::tag;
+const MessageTag ResumeSessionResponse::tag;
+const MessageTag SessionTicket::tag;
 const MessageTag StartVaultRequest::tag;
+const MessageTag StartVaultsRequest::tag;
+const MessageTag SubscribeToVaultEventsRequest::tag;
+const MessageTag TailVaultOutputRequest::tag;
+const MessageTag TailVaultOutputResponse::tag;
 const MessageTag TakeOwnershipRequest::tag;
+const MessageTag ValidateConnectionRequest::tag;
+const MessageTag VaultDrainProgress::tag;
+const MessageTag VaultEventNotification::tag;
 const MessageTag VaultRunningResponse::tag;
+const MessageTag VaultShutdownRequest::tag;
+const MessageTag VaultSpawned::tag;
 const MessageTag VaultStarted::tag;
 const MessageTag VaultStartedResponse::tag;
+const MessageTag VaultStatsReport::tag;
 #endif
 
 namespace {
 
+const std::size_t kSessionTicketNonceSize(16);
+
+struct SessionTicketContents {
+  // An HMAC-SHA512 keyed by a hash of the session ticket key, so that a ticket can't be forged or
+  // altered without knowledge of that key.  The random nonce also ensures that no two tickets
+  // encrypt alike, despite the session ticket key having a fixed IV.
+  std::string Mac(const crypto::AES256KeyAndIV& session_ticket_key) const {
+    const crypto::SHA512Hash kMacKey{
+        crypto::Hash<crypto::SHA512>("session ticket MAC key" + session_ticket_key.string())};
+    const SerialisedData kData{Serialise(nonce, maid_name, expiry)};
+    CryptoPP::HMAC<CryptoPP::SHA512> hmac{
+        reinterpret_cast<const unsigned char*>(kMacKey.string().data()), kMacKey.string().size()};
+    std::string mac(hmac.DigestSize(), '\0');
+    hmac.CalculateDigest(reinterpret_cast<unsigned char*>(&mac[0]), kData.data(), kData.size());
+    return mac;
+  }
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(nonce, maid_name, expiry, mac);
+  }
+
+  std::string nonce;
+  Identity maid_name;
+  std::int64_t expiry;  // Seconds since epoch, so that tickets survive a VaultManager restart.
+  std::string mac;
+};
+
+std::int64_t SecondsSinceEpoch(std::chrono::system_clock::time_point time_point) {
+  return std::chrono::duration_cast<std::chrono::seconds>(time_point.time_since_epoch()).count();
+}
+
 #ifdef TESTING
 std::once_flag test_env_flag;
 tcp::Port g_test_vault_manager_port(0);
@@ -72,6 +153,57 @@ fs::path g_test_env_root_dir, g_path_to_vault;
 bool g_using_default_environment(true);
 std::vector<passport::PmidAndSigner> g_pmids_and_signers;
 std::vector<passport::PublicPmid> g_public_pmids;
+
+// The keys are generated on all cores, but are returned in index order regardless of which thread
+// generated each, so that GetPmidAndSigner(i) always refers to the same key as GetPublicPmids()[i].
+template <typename Keys>
+std::vector<Keys> CreateKeys(std::size_t count, std::function<Keys()> create_keys) {
+  std::vector<std::unique_ptr<Keys>> created(count);
+  ParallelFor(count, [&](std::size_t index) {
+    created[index] = maidsafe::make_unique<Keys>(create_keys());
+  });
+
+  std::vector<Keys> keys;
+  keys.reserve(count);
+  for (auto& created_keys : created)
+    keys.emplace_back(std::move(*created_keys));
+  return keys;
+}
+
+// Reads the key chains saved in 'key_chain_path', adding to the file if it holds fewer than
+// 'count', and returns the first 'count' Pmids and their signers.
+std::vector<passport::PmidAndSigner> LoadOrCreatePmidsAndSigners(const fs::path& key_chain_path,
+                                                                 std::size_t count) {
+  std::vector<passport::detail::AnmaidToPmid> key_chains;
+  boost::system::error_code ec;
+  if (fs::exists(key_chain_path, ec)) {
+    try {
+      key_chains = passport::detail::ReadKeyChainList(key_chain_path);
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to read key chains from " << key_chain_path
+                    << ", so they'll be replaced: " << boost::diagnostic_information(e);
+      key_chains.clear();
+    }
+  }
+
+  if (key_chains.size() < count) {
+    LOG(kInfo) << "Creating " << count - key_chains.size() << " key chains to add to the "
+               << key_chains.size() << " in " << key_chain_path;
+    auto created(CreateKeys<passport::detail::AnmaidToPmid>(
+        count - key_chains.size(), [] { return passport::detail::AnmaidToPmid(); }));
+    std::move(std::begin(created), std::end(created), std::back_inserter(key_chains));
+    if (!passport::detail::WriteKeyChainList(key_chain_path, key_chains)) {
+      LOG(kError) << "Failed to write key chains to " << key_chain_path;
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+    }
+  }
+
+  std::vector<passport::PmidAndSigner> pmids_and_signers;
+  pmids_and_signers.reserve(count);
+  for (std::size_t i(0); i < count; ++i)
+    pmids_and_signers.emplace_back(key_chains[i].pmid, key_chains[i].anpmid);
+  return pmids_and_signers;
+}
 #endif
 
 }  // unnamed namespace
@@ -87,6 +219,7 @@ std::unique_ptr<VaultConfig> GetValue(const VaultStartedResponse& vault_started_
   auto vault_config = maidsafe::make_unique<VaultConfig>(*vault_started_response.pmid,
                                                          vault_started_response.vault_dir,
                                                          vault_started_response.max_disk_usage);
+  vault_config->heartbeat_interval = vault_started_response.heartbeat_interval;
 #ifdef USE_VLOGGING
   vault_config->vlog_session_id = vault_started_response.vlog_session_id;
 #endif
@@ -100,6 +233,13 @@ std::unique_ptr<VaultConfig> GetValue(const VaultStartedResponse& vault_started_
   return vault_config;
 }
 
+std::unique_ptr<crypto::CipherText> GetValue(
+    const ResumeSessionResponse& resume_session_response) {
+  if (resume_session_response.error)
+    BOOST_THROW_EXCEPTION(*resume_session_response.error);
+  return maidsafe::make_unique<crypto::CipherText>(*resume_session_response.ticket);
+}
+
 }  // namespace detail
 
 NonEmptyString GenerateLabel() {
@@ -119,11 +259,73 @@ tcp::Port GetInitialListeningPort() {
 #endif
 }
 
+crypto::CipherText CreateSessionTicket(const Identity& maid_name,
+                                       const crypto::AES256KeyAndIV& session_ticket_key,
+                                       std::chrono::seconds lifetime) {
+  SessionTicketContents contents;
+  contents.nonce = RandomString(kSessionTicketNonceSize);
+  contents.maid_name = maid_name;
+  contents.expiry = SecondsSinceEpoch(std::chrono::system_clock::now() + lifetime);
+  contents.mac = contents.Mac(session_ticket_key);
+  return crypto::SymmEncrypt(crypto::PlainText{Serialise(contents)}, session_ticket_key);
+}
+
+Identity ParseSessionTicket(const crypto::CipherText& ticket,
+                            const crypto::AES256KeyAndIV& session_ticket_key) {
+  SessionTicketContents contents;
+  try {
+    contents =
+        Parse<SessionTicketContents>(crypto::SymmDecrypt(ticket, session_ticket_key).string());
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to parse session ticket: " << boost::diagnostic_information(e);
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  const std::string kExpectedMac{contents.Mac(session_ticket_key)};
+  if (contents.nonce.size() != kSessionTicketNonceSize ||
+      contents.mac.size() != kExpectedMac.size() ||
+      !CryptoPP::VerifyBufsEqual(reinterpret_cast<const unsigned char*>(contents.mac.data()),
+                                 reinterpret_cast<const unsigned char*>(kExpectedMac.data()),
+                                 kExpectedMac.size())) {
+    LOG(kWarning) << "Session ticket has been altered.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  if (contents.expiry < SecondsSinceEpoch(std::chrono::system_clock::now())) {
+    LOG(kInfo) << "Session ticket for " << contents.maid_name << " has expired.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  return contents.maid_name;
+}
+
+std::chrono::milliseconds ReconnectDelay(int attempt) {
+  const std::chrono::milliseconds kMaxDelay(kMaxReconnectDelay);
+  std::chrono::milliseconds delay(kInitialReconnectDelay);
+  for (int i(0); i < attempt && delay < kMaxDelay; ++i)
+    delay *= 2;
+  delay = std::min(delay, kMaxDelay);
+  return delay / 2 + std::chrono::milliseconds(RandomUint32() % (delay.count() / 2 + 1));
+}
+
+fs::path GetPath(const fs::path& path) {
+#ifdef TESTING
+  return (GetTestEnvironmentRootDir().empty() ? GetUserAppDir() : GetTestEnvironmentRootDir()) /
+         path;
+#else
+  return GetSystemAppSupportDir() / path;
+#endif
+}
+
+fs::path GetConfigFilePath() { return GetPath(kConfigFilename); }
+
+fs::path GetDiscoveryFilePath() { return GetPath(kDiscoveryFilename); }
+
+fs::path GetVaultDir(const std::string& debug_id) { return GetPath(debug_id); }
+
 #ifdef TESTING
 namespace test {
 
 void SetEnvironment(tcp::Port test_vault_manager_port, const fs::path& test_env_root_dir,
-                    const fs::path& path_to_vault, int pmid_list_size) {
+                    const fs::path& path_to_vault, int pmid_list_size,
+                    const fs::path& key_chain_path) {
   std::call_once(test_env_flag, [=] {
     if (!fs::exists(test_env_root_dir) || !fs::is_directory(test_env_root_dir)) {
       LOG(kError) << test_env_root_dir << " doesn't exist or is not a directory.";
@@ -132,10 +334,15 @@ void SetEnvironment(tcp::Port test_vault_manager_port, const fs::path& test_env_
     g_test_vault_manager_port = test_vault_manager_port;
     g_test_env_root_dir = test_env_root_dir;
     g_path_to_vault = path_to_vault;
-    for (int i(0); i < pmid_list_size; ++i) {
-      g_pmids_and_signers.emplace_back(passport::CreatePmidAndSigner());
-      g_public_pmids.emplace_back(passport::PublicPmid{g_pmids_and_signers.back().first});
+    const std::size_t kPmidCount(static_cast<std::size_t>(std::max(pmid_list_size, 0)));
+    if (key_chain_path.empty()) {
+      g_pmids_and_signers = CreateKeys<passport::PmidAndSigner>(
+          kPmidCount, [] { return passport::CreatePmidAndSigner(); });
+    } else {
+      g_pmids_and_signers = LoadOrCreatePmidsAndSigners(key_chain_path, kPmidCount);
     }
+    for (const auto& pmid_and_signer : g_pmids_and_signers)
+      g_public_pmids.emplace_back(passport::PublicPmid{pmid_and_signer.first});
     g_using_default_environment = false;
   });
 }
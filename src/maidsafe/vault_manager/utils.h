@@ -19,9 +19,14 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_UTILS_H_
 #define MAIDSAFE_VAULT_MANAGER_UTILS_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <future>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "asio/steady_timer.hpp"
@@ -29,6 +34,7 @@
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/crypto.h"
+#include "maidsafe/common/identity.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/common/tcp/connection.h"
 #include "maidsafe/passport/passport.h"
@@ -42,6 +48,7 @@ namespace maidsafe {
 namespace vault_manager {
 
 struct Challenge;
+struct ResumeSessionResponse;
 struct VaultStartedResponse;
 
 namespace detail {
@@ -50,6 +57,8 @@ std::unique_ptr<asymm::PlainText> GetValue(const Challenge& challenge);
 
 std::unique_ptr<VaultConfig> GetValue(const VaultStartedResponse& vault_started_response);
 
+std::unique_ptr<crypto::CipherText> GetValue(const ResumeSessionResponse& resume_session_response);
+
 }  // namespace detail
 
 template <typename T>
@@ -57,16 +66,67 @@ void Send(tcp::ConnectionPtr connection, T message) {
   connection->Send(Serialise(T::tag, std::move(message)));
 }
 
+// Calls 'functor(index)' once for each index in [0, count) using up to 'max_threads' threads (one
+// per core if 0), the caller's included.  Each thread takes the next index as soon as it's free, so
+// uneven costs are balanced.  Returns once every call has completed.  'functor' mustn't throw.
+template <typename Functor>
+void ParallelFor(std::size_t count, Functor functor, unsigned max_threads = 0) {
+  if (max_threads == 0)
+    max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  std::atomic<std::size_t> next_index(0);
+  auto run([&] {
+    for (std::size_t index(next_index++); index < count; index = next_index++)
+      functor(index);
+  });
+
+  const std::size_t kThreadCount(std::min(count, std::size_t{max_threads}));
+  std::vector<std::future<void>> workers;
+  for (std::size_t i(1); i < kThreadCount; ++i)
+    workers.emplace_back(std::async(std::launch::async, run));
+  run();
+  for (auto& worker : workers)
+    worker.get();
+}
+
 NonEmptyString GenerateLabel();
 
 tcp::Port GetInitialListeningPort();
 
+// A session ticket allows a client which has already answered a Challenge to skip doing so when
+// it reconnects, including to a restarted VaultManager.  It is opaque to the client, being
+// encrypted and authenticated using the VaultManager's session ticket key, which must never be
+// shared with vaults.
+crypto::CipherText CreateSessionTicket(const Identity& maid_name,
+                                       const crypto::AES256KeyAndIV& session_ticket_key,
+                                       std::chrono::seconds lifetime = kSessionTicketLifetime);
+
+// Returns the name of the client to which the ticket was issued.  Throws if the ticket is invalid
+// or has expired.
+Identity ParseSessionTicket(const crypto::CipherText& ticket,
+                            const crypto::AES256KeyAndIV& session_ticket_key);
+
+// Returns the delay before reconnection attempt number 'attempt' (zero-based): exponential backoff
+// from kInitialReconnectDelay capped at kMaxReconnectDelay, with the upper half randomised so that
+// many clients losing the same VaultManager don't reconnect in lockstep.
+std::chrono::milliseconds ReconnectDelay(int attempt);
+
+// Paths below the VaultManager's application support directory (or the test environment root dir
+// if one has been set).
+boost::filesystem::path GetPath(const boost::filesystem::path& path);
+boost::filesystem::path GetConfigFilePath();
+boost::filesystem::path GetDiscoveryFilePath();
+boost::filesystem::path GetVaultDir(const std::string& debug_id);
+
 #ifdef TESTING
 namespace test {
 
+// If 'key_chain_path' is given, the Pmids are loaded from that key chain file, which is created (or
+// extended) and saved if it holds fewer than 'pmid_list_size' key chains.  Otherwise new Pmids are
+// generated.
 void SetEnvironment(tcp::Port test_vault_manager_port,
                     const boost::filesystem::path& test_env_root_dir,
-                    const boost::filesystem::path& path_to_vault, int pmid_list_size = 0);
+                    const boost::filesystem::path& path_to_vault, int pmid_list_size = 0,
+                    const boost::filesystem::path& key_chain_path = boost::filesystem::path());
 
 }  // namespace test
 
@@ -30,6 +30,7 @@ VaultConfig::VaultConfig(const passport::Pmid& pmid_in, const boost::filesystem:
     : pmid(pmid_in),
       vault_dir(vault_dir_in),
       max_disk_usage(max_disk_usage_in),
+      heartbeat_interval(0),
 #ifdef TESTING
       test_config(),
       send_hostname_to_visualiser_server(false),
@@ -41,6 +42,7 @@ VaultConfig::VaultConfig(const VaultConfig& other)
     : pmid(other.pmid),
       vault_dir(other.vault_dir),
       max_disk_usage(other.max_disk_usage),
+      heartbeat_interval(other.heartbeat_interval),
 #ifdef TESTING
       test_config(other.test_config),
       send_hostname_to_visualiser_server(other.send_hostname_to_visualiser_server),
@@ -52,6 +54,7 @@ VaultConfig::VaultConfig(VaultConfig&& other)
     : pmid(std::move(other.pmid)),
       vault_dir(std::move(other.vault_dir)),
       max_disk_usage(std::move(other.max_disk_usage)),
+      heartbeat_interval(std::move(other.heartbeat_interval)),
 #ifdef TESTING
       test_config(std::move(other.test_config)),
       send_hostname_to_visualiser_server(std::move(other.send_hostname_to_visualiser_server)),
@@ -69,6 +72,7 @@ void swap(VaultConfig& lhs, VaultConfig& rhs) {
   swap(lhs.pmid, rhs.pmid);
   swap(lhs.vault_dir, rhs.vault_dir);
   swap(lhs.max_disk_usage, rhs.max_disk_usage);
+  swap(lhs.heartbeat_interval, rhs.heartbeat_interval);
 #ifdef TESTING
   swap(lhs.test_config, rhs.test_config);
   swap(lhs.send_hostname_to_visualiser_server, rhs.send_hostname_to_visualiser_server);
@@ -0,0 +1,70 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_event_log.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "maidsafe/common/tcp/connection.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+VaultEventLog::VaultEventLog(std::size_t capacity)
+    : kCapacity_(std::max(capacity, std::size_t{1})),
+      next_sequence_number_(static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count())),
+      history_(),
+      subscribers_() {}
+
+VaultEvent VaultEventLog::Record(VaultEvent event) {
+  event.sequence_number = next_sequence_number_++;
+  if (history_.size() == kCapacity_)
+    history_.pop_front();
+  history_.push_back(event);
+  return event;
+}
+
+std::vector<VaultEvent> VaultEventLog::Since(std::uint64_t after_sequence_number) const {
+  auto itr(std::upper_bound(std::begin(history_), std::end(history_), after_sequence_number,
+                            [](std::uint64_t sequence_number, const VaultEvent& event) {
+                              return sequence_number < event.sequence_number;
+                            }));
+  return std::vector<VaultEvent>(itr, std::end(history_));
+}
+
+std::uint64_t VaultEventLog::NextSequenceNumber() const { return next_sequence_number_; }
+
+void VaultEventLog::AddSubscriber(tcp::ConnectionPtr connection) {
+  subscribers_.insert(connection);
+}
+
+bool VaultEventLog::RemoveSubscriber(tcp::ConnectionPtr connection) {
+  return subscribers_.erase(connection) != 0;
+}
+
+std::vector<tcp::ConnectionPtr> VaultEventLog::Subscribers() const {
+  return std::vector<tcp::ConnectionPtr>(std::begin(subscribers_), std::end(subscribers_));
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,65 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_LOG_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_LOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_event.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Sequences vault lifecycle events and retains the most recent 'capacity' of them so that a
+// resubscribing client can catch up.  Also tracks which client connections are subscribed.  Not
+// threadsafe; the VaultManager only uses this on its own thread.
+class VaultEventLog {
+ public:
+  explicit VaultEventLog(std::size_t capacity = kVaultEventHistorySize);
+
+  // Stamps 'event' with the next sequence number, retains it and returns the stamped copy.
+  VaultEvent Record(VaultEvent event);
+  // Returns the retained events with a sequence number greater than 'after_sequence_number', oldest
+  // first.
+  std::vector<VaultEvent> Since(std::uint64_t after_sequence_number) const;
+  std::uint64_t NextSequenceNumber() const;
+
+  void AddSubscriber(tcp::ConnectionPtr connection);
+  bool RemoveSubscriber(tcp::ConnectionPtr connection);
+  std::vector<tcp::ConnectionPtr> Subscribers() const;
+
+ private:
+  const std::size_t kCapacity_;
+  std::uint64_t next_sequence_number_;
+  std::deque<VaultEvent> history_;
+  std::set<tcp::ConnectionPtr, std::owner_less<tcp::ConnectionPtr>> subscribers_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_LOG_H_
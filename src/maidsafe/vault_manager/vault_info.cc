@@ -30,6 +30,7 @@ VaultInfo::VaultInfo()
       max_disk_usage(0),
       owner_name(),
       label(),
+      process_id(0),
 #ifdef USE_VLOGGING
       vlog_session_id(),
       send_hostname_to_visualiser_server(false),
@@ -43,6 +44,7 @@ VaultInfo::VaultInfo(const VaultInfo& other)
       max_disk_usage(other.max_disk_usage),
       owner_name(other.owner_name),
       label(other.label),
+      process_id(other.process_id),
 #ifdef USE_VLOGGING
       vlog_session_id(other.vlog_session_id),
       send_hostname_to_visualiser_server(other.send_hostname_to_visualiser_server),
@@ -56,6 +58,7 @@ VaultInfo::VaultInfo(VaultInfo&& other)
       max_disk_usage(std::move(other.max_disk_usage)),
       owner_name(std::move(other.owner_name)),
       label(std::move(other.label)),
+      process_id(std::move(other.process_id)),
 #ifdef USE_VLOGGING
       vlog_session_id(std::move(other.vlog_session_id)),
       send_hostname_to_visualiser_server(std::move(other.send_hostname_to_visualiser_server)),
@@ -75,6 +78,7 @@ void swap(VaultInfo& lhs, VaultInfo& rhs) {
   swap(lhs.max_disk_usage, rhs.max_disk_usage);
   swap(lhs.owner_name, rhs.owner_name);
   swap(lhs.label, rhs.label);
+  swap(lhs.process_id, rhs.process_id);
 #ifdef USE_VLOGGING
   swap(lhs.vlog_session_id, rhs.vlog_session_id);
   swap(lhs.send_hostname_to_visualiser_server, rhs.send_hostname_to_visualiser_server);
@@ -47,6 +47,9 @@ struct VaultInfo {
   DiskUsage max_disk_usage;
   Identity owner_name;
   NonEmptyString label;
+  // The vault's process ID when the config file was last written, so that a restarted VaultManager
+  // can adopt the vault if it's still running.  Zero if the vault wasn't running.
+  std::uint64_t process_id;
 #ifdef USE_VLOGGING
   std::string vlog_session_id;
   bool send_hostname_to_visualiser_server;
@@ -24,11 +24,23 @@
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/tcp/connection.h"
 
+#include "maidsafe/vault_manager/discovery_file.h"
+#include "maidsafe/vault_manager/handler_guard.h"
 #include "maidsafe/vault_manager/rpc_helper.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/heartbeat.h"
 #include "maidsafe/vault_manager/messages/joined_network.h"
+#include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_progress.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_request.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_response.h"
+#include "maidsafe/vault_manager/messages/vault_drain_progress.h"
+#include "maidsafe/vault_manager/messages/vault_drained.h"
+#include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
 #include "maidsafe/vault_manager/messages/vault_started_response.h"
+#include "maidsafe/vault_manager/messages/vault_stats_report.h"
 
 namespace fs = boost::filesystem;
 
@@ -37,38 +49,218 @@ namespace maidsafe {
 namespace vault_manager {
 
 VaultInterface::VaultInterface(tcp::Port vault_manager_port)
+    : VaultInterface(vault_manager_port, nullptr) {}
+
+VaultInterface::VaultInterface(tcp::Port vault_manager_port, asio::io_service& io_service)
+    : VaultInterface(vault_manager_port, &io_service) {}
+
+VaultInterface::VaultInterface(tcp::Port vault_manager_port, asio::io_service* io_service)
     : exit_code_promise_(),
       exit_code_flag_(),
       vault_manager_port_(vault_manager_port),
       on_vault_started_response_(),
+      config_mutex_(),
       vault_config_(),
-      asio_service_(1),
-      strand_(asio_service_.service()),
+      on_max_disk_usage_update_(),
+      on_move_chunkstore_(),
+      on_drain_(),
+      progress_(0),
+      stats_mutex_(),
+      pending_stats_(),
+      asio_service_(io_service ? nullptr : maidsafe::make_unique<AsioService>(1)),
+      io_service_(io_service ? *io_service : asio_service_->service()),
+      strand_(io_service_),
+      handler_guard_(std::make_shared<HandlerGuard>()),
+      connection_mutex_(),
+      stopping_(false),
+      reconnect_attempt_(0),
+      reconnect_deadline_(),
       tcp_connection_(tcp::Connection::MakeShared(strand_, vault_manager_port_)),
-      connection_closer_([&] { tcp_connection_->Close(); }) {
+      connection_closer_([&] { CloseAndDrain(tcp_connection_, strand_, *handler_guard_); }) {
   tcp_connection_->Start(
-      [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
-      [this] { OnConnectionClosed(); });
+      Guard(handler_guard_,
+            [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); }),
+      Guard(handler_guard_, [this] { OnConnectionClosed(); }));
   LOG(kSuccess) << "Connected to VaultManager which is listening on port " << vault_manager_port_;
   std::mutex mutex;
   auto vault_config_future(SetResponseCallback<std::unique_ptr<VaultConfig>, VaultStartedResponse>(
-      on_vault_started_response_, asio_service_.service(), mutex));
-  Send(tcp_connection_, VaultStarted(process::GetProcessId()));
-  vault_config_ = vault_config_future.get();
+      on_vault_started_response_, io_service_, mutex, handler_guard_));
+  Send(tcp_connection_, VaultStarted(kProtocolVersion, process::GetProcessId()));
+  {
+    auto vault_config(vault_config_future.get());
+    std::lock_guard<std::mutex> lock{config_mutex_};
+    vault_config_ = std::move(vault_config);
+  }
   LOG(kSuccess) << "Retrieved config info from VaultManager";
+  if (vault_config_->heartbeat_interval > std::chrono::milliseconds(0))
+    SendHeartbeat();
+  TimingWheel::Get(io_service_).Arm(kVaultStatsInterval,
+                                    Guard(handler_guard_, [this] { SendStats(); }));
+}
+
+VaultInterface::~VaultInterface() {
+  std::lock_guard<std::mutex> lock{connection_mutex_};
+  stopping_ = true;
+}
+
+VaultConfig VaultInterface::GetConfiguration() {
+  std::lock_guard<std::mutex> lock{config_mutex_};
+  return *vault_config_;
 }
 
-VaultConfig VaultInterface::GetConfiguration() { return *vault_config_; }
+void VaultInterface::SetMaxDiskUsageUpdateFunctor(OnMaxDiskUsageUpdateFunctor functor) {
+  std::lock_guard<std::mutex> lock{config_mutex_};
+  on_max_disk_usage_update_ = std::move(functor);
+}
 
 int VaultInterface::WaitForExit() { return exit_code_promise_.get_future().get(); }
 
-void VaultInterface::SendJoined() { Send(tcp_connection_, JoinedNetwork()); }
+void VaultInterface::SendJoined() { Send(GetConnection(), JoinedNetwork()); }
+
+void VaultInterface::ReportProgress() { ++progress_; }
+
+void VaultInterface::ReportStats(const VaultStats& stats) {
+  std::lock_guard<std::mutex> lock{stats_mutex_};
+  pending_stats_ = maidsafe::make_unique<VaultStats>(stats);
+}
+
+void VaultInterface::SendStats() {
+  std::unique_ptr<VaultStats> stats;
+  {
+    std::lock_guard<std::mutex> lock{stats_mutex_};
+    stats = std::move(pending_stats_);
+  }
+  std::shared_ptr<tcp::Connection> connection{GetConnection()};
+  if (stats && connection)
+    Send(connection, VaultStatsReport(*stats));
+  TimingWheel::Get(io_service_).Arm(kVaultStatsInterval,
+                                    Guard(handler_guard_, [this] { SendStats(); }));
+}
+
+void VaultInterface::SendHeartbeat() {
+  std::shared_ptr<tcp::Connection> connection{GetConnection()};
+  if (!connection)
+    return;
+  Send(connection, Heartbeat(progress_));
+  TimingWheel::Get(io_service_).Arm(vault_config_->heartbeat_interval,
+                                    Guard(handler_guard_, [this] { SendHeartbeat(); }));
+}
+
+void VaultInterface::SetMoveChunkstoreFunctor(OnMoveChunkstoreFunctor functor) {
+  std::lock_guard<std::mutex> lock{config_mutex_};
+  on_move_chunkstore_ = std::move(functor);
+}
+
+void VaultInterface::ReportChunkstoreMoveProgress(std::uint64_t bytes_moved,
+                                                  std::uint64_t bytes_total) {
+  Send(GetConnection(), MoveChunkstoreProgress(bytes_moved, bytes_total));
+}
+
+void VaultInterface::ChunkstoreMoved(const fs::path& vault_dir, const maidsafe_error& result) {
+  if (result.code() == make_error_code(CommonErrors::success)) {
+    {
+      std::lock_guard<std::mutex> lock{config_mutex_};
+      vault_config_->vault_dir = vault_dir;
+    }
+    LOG(kSuccess) << "Chunkstore moved to " << vault_dir;
+    Send(GetConnection(), MoveChunkstoreResponse(vault_dir));
+  } else {
+    LOG(kWarning) << "Abandoned moving chunkstore to " << vault_dir << ": " << result.what();
+    Send(GetConnection(), MoveChunkstoreResponse(vault_dir, result));
+  }
+}
+
+void VaultInterface::SetDrainFunctor(OnDrainFunctor functor) {
+  std::lock_guard<std::mutex> lock{config_mutex_};
+  on_drain_ = std::move(functor);
+}
+
+void VaultInterface::ReportDrainProgress(std::uint64_t remaining) {
+  Send(GetConnection(), VaultDrainProgress(remaining));
+}
+
+void VaultInterface::DrainComplete() {
+  LOG(kInfo) << "Drained; exiting.";
+  Send(GetConnection(), VaultDrained());
+  std::call_once(exit_code_flag_, [this] { exit_code_promise_.set_value(0); });
+}
 
 void VaultInterface::OnConnectionClosed() {
-  LOG(kError) << "Lost connection to Vault Manager";
-  std::call_once(exit_code_flag_, [this] {
-    exit_code_promise_.set_value(ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
-  });
+  {
+    std::lock_guard<std::mutex> lock{config_mutex_};
+    if (!vault_config_) {
+      LOG(kError) << "Lost connection to Vault Manager before receiving vault configuration.";
+      return std::call_once(exit_code_flag_, [this] {
+        exit_code_promise_.set_value(
+            ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
+      });
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock{connection_mutex_};
+    if (stopping_)
+      return;
+    // Only the first loss starts the deadline; a reconnection closed before the VaultManager has
+    // re-adopted us doesn't extend it.
+    if (reconnect_deadline_ == std::chrono::steady_clock::time_point())
+      reconnect_deadline_ = std::chrono::steady_clock::now() + kVaultReconnectTimeout;
+  }
+  LOG(kWarning) << "Lost connection to Vault Manager.";
+  ScheduleReconnect();
+}
+
+void VaultInterface::ScheduleReconnect() {
+  std::chrono::milliseconds delay{0};
+  {
+    std::lock_guard<std::mutex> lock{connection_mutex_};
+    if (stopping_)
+      return;
+    if (std::chrono::steady_clock::now() >= reconnect_deadline_) {
+      LOG(kError) << "Failed to reconnect to Vault Manager.";
+      stopping_ = true;
+      return std::call_once(exit_code_flag_, [this] {
+        exit_code_promise_.set_value(
+            ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
+      });
+    }
+    delay = ReconnectDelay(reconnect_attempt_++);
+  }
+  LOG(kInfo) << "Reconnecting to Vault Manager in " << delay.count() << "ms.";
+  TimingWheel::Get(io_service_).Arm(delay, Guard(handler_guard_, [this] {
+    strand_.post(Guard(handler_guard_, [this] { Reconnect(); }));
+  }));
+}
+
+void VaultInterface::Reconnect() {
+  // A restarted VaultManager may be listening on a different port.
+  tcp::Port port{vault_manager_port_};
+  auto discovery_info(ReadDiscoveryFile(GetDiscoveryFilePath()));
+  if (discovery_info)
+    port = discovery_info->port;
+
+  tcp::ConnectionPtr connection;
+  try {
+    connection = tcp::Connection::MakeShared(strand_, port);
+  } catch (const std::exception&) {
+    return ScheduleReconnect();
+  }
+  {
+    std::lock_guard<std::mutex> lock{connection_mutex_};
+    if (stopping_)
+      return connection->Close();
+    tcp_connection_ = connection;
+  }
+  connection->Start(
+      Guard(handler_guard_,
+            [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); }),
+      Guard(handler_guard_, [this] { OnConnectionClosed(); }));
+  LOG(kInfo) << "Connected to Vault Manager on port " << port << ".  Requesting re-adoption.";
+  Send(connection, VaultStarted(kProtocolVersion, process::GetProcessId()));
+}
+
+tcp::ConnectionPtr VaultInterface::GetConnection() {
+  std::lock_guard<std::mutex> lock{connection_mutex_};
+  return tcp_connection_;
 }
 
 void VaultInterface::HandleReceivedMessage(tcp::Message&& message) {
@@ -81,7 +273,13 @@ void VaultInterface::HandleReceivedMessage(tcp::Message&& message) {
         HandleVaultStartedResponse(Parse<VaultStartedResponse>(binary_input_stream));
         break;
       case MessageTag::kVaultShutdownRequest:
-        HandleVaultShutdownRequest();
+        HandleVaultShutdownRequest(Parse<VaultShutdownRequest>(binary_input_stream));
+        break;
+      case MessageTag::kMaxDiskUsageUpdate:
+        HandleMaxDiskUsageUpdate(Parse<MaxDiskUsageUpdate>(binary_input_stream));
+        break;
+      case MessageTag::kMoveChunkstoreRequest:
+        HandleMoveChunkstoreRequest(Parse<MoveChunkstoreRequest>(binary_input_stream));
         break;
       default:
         return;
@@ -92,17 +290,89 @@ void VaultInterface::HandleReceivedMessage(tcp::Message&& message) {
 }
 
 void VaultInterface::HandleVaultStartedResponse(VaultStartedResponse&& vault_started_response) {
-  if (on_vault_started_response_)
-    on_vault_started_response_(std::move(vault_started_response));
-  else
-    assert(false);  // already received vault configuration
+  bool configured{false};
+  {
+    std::lock_guard<std::mutex> lock{config_mutex_};
+    configured = (vault_config_ != nullptr);
+  }
+  if (!configured) {
+    if (on_vault_started_response_)
+      on_vault_started_response_(std::move(vault_started_response));
+    else
+      assert(false);
+    return;
+  }
+
+  // We've been re-adopted after reconnecting, possibly to a restarted VaultManager.
+  {
+    std::lock_guard<std::mutex> lock{connection_mutex_};
+    reconnect_attempt_ = 0;
+    reconnect_deadline_ = std::chrono::steady_clock::time_point();
+  }
+  LOG(kSuccess) << "Reconnected to Vault Manager";
+  bool max_disk_usage_changed{false};
+  {
+    std::lock_guard<std::mutex> lock{config_mutex_};
+    max_disk_usage_changed =
+        (vault_config_->max_disk_usage.data != vault_started_response.max_disk_usage.data);
+  }
+  if (max_disk_usage_changed)
+    HandleMaxDiskUsageUpdate(MaxDiskUsageUpdate(vault_started_response.max_disk_usage));
 }
 
-void VaultInterface::HandleVaultShutdownRequest() {
+void VaultInterface::HandleVaultShutdownRequest(VaultShutdownRequest&& vault_shutdown_request) {
   LOG(kInfo) << "Received  ShutdownRequest from Vault Manager";
+  {
+    std::lock_guard<std::mutex> lock{connection_mutex_};
+    if (stopping_)
+      return;
+    stopping_ = true;
+  }
+  OnDrainFunctor on_drain;
+  {
+    std::lock_guard<std::mutex> lock{config_mutex_};
+    on_drain = on_drain_;
+  }
+  if (on_drain) {
+    LOG(kInfo) << "Draining within " << vault_shutdown_request.drain_timeout.count() << "ms.";
+    return on_drain(std::chrono::steady_clock::now() + vault_shutdown_request.drain_timeout);
+  }
   std::call_once(exit_code_flag_, [this] { exit_code_promise_.set_value(0); });
 }
 
+void VaultInterface::HandleMaxDiskUsageUpdate(MaxDiskUsageUpdate&& max_disk_usage_update) {
+  OnMaxDiskUsageUpdateFunctor on_max_disk_usage_update;
+  {
+    std::lock_guard<std::mutex> lock{config_mutex_};
+    if (!vault_config_) {
+      LOG(kWarning) << "Received MaxDiskUsageUpdate before vault configuration.";
+      return;
+    }
+    vault_config_->max_disk_usage = max_disk_usage_update.usage;
+    on_max_disk_usage_update = on_max_disk_usage_update_;
+  }
+  LOG(kInfo) << "Max disk usage updated to " << max_disk_usage_update.usage.data;
+  if (on_max_disk_usage_update)
+    on_max_disk_usage_update(max_disk_usage_update.usage);
+}
+
+void VaultInterface::HandleMoveChunkstoreRequest(MoveChunkstoreRequest&& move_chunkstore_request) {
+  OnMoveChunkstoreFunctor on_move_chunkstore;
+  {
+    std::lock_guard<std::mutex> lock{config_mutex_};
+    on_move_chunkstore = on_move_chunkstore_;
+  }
+  if (!on_move_chunkstore) {
+    LOG(kWarning) << "Unable to move chunkstore while running.";
+    return Send(GetConnection(),
+                MoveChunkstoreResponse(std::move(move_chunkstore_request.vault_dir),
+                                       MakeError(CommonErrors::unable_to_handle_request)));
+  }
+  LOG(kInfo) << "Moving chunkstore to " << move_chunkstore_request.vault_dir;
+  on_move_chunkstore(std::move(move_chunkstore_request.vault_dir),
+                     move_chunkstore_request.max_bytes_per_second);
+}
+
 #ifdef TESTING
 void VaultInterface::KillConnection() {
   maidsafe::Sleep(std::chrono::seconds(1));
@@ -115,7 +385,7 @@ void VaultInterface::SendInvalidMessage() {
 
 void VaultInterface::StopProcess() {
   maidsafe::Sleep(std::chrono::seconds(1));
-  HandleVaultShutdownRequest();
+  HandleVaultShutdownRequest(VaultShutdownRequest());
 }
 #endif
 
@@ -0,0 +1,186 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_log_rotator.h"
+
+#ifdef MAIDSAFE_WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "cryptopp/files.h"
+#include "cryptopp/gzip.h"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+const std::string kCompressedExtension(".gz");
+
+struct LogFile {
+  fs::path path;
+  std::uint64_t size;
+  std::time_t last_write_time;
+};
+
+std::vector<LogFile> ListLogFiles(const fs::path& log_folder) {
+  std::vector<LogFile> log_files;
+  boost::system::error_code error_code;
+  for (fs::directory_iterator itr(log_folder, error_code), end; !error_code && itr != end;
+       itr.increment(error_code)) {
+    boost::system::error_code file_error;
+    if (!fs::is_regular_file(itr->symlink_status(file_error)))
+      continue;
+    LogFile log_file{itr->path(), fs::file_size(itr->path(), file_error),
+                     fs::last_write_time(itr->path(), file_error)};
+    if (!file_error)
+      log_files.push_back(std::move(log_file));
+  }
+  if (error_code)
+    LOG(kWarning) << "Failed to list " << log_folder << ": " << error_code.message();
+  return log_files;
+}
+
+bool IsCompressed(const fs::path& path) { return path.extension() == kCompressedExtension; }
+
+fs::path RotatedPath(const fs::path& log_file, std::time_t now) {
+  return log_file.string() + "." + std::to_string(now);
+}
+
+// Gzips 'source' to 'source'.gz, then removes 'source'.  The data is streamed, so logs which grew
+// large before rotation was enabled don't have to fit in memory.
+void CompressAndRemove(const fs::path& source) {
+  const std::string kTarget{source.string() + kCompressedExtension};
+  CryptoPP::FileSource(source.string().c_str(), true,
+                       new CryptoPP::Gzip(new CryptoPP::FileSink(kTarget.c_str(), true)));
+  fs::remove(source);
+}
+
+}  // unnamed namespace
+
+VaultLogRotator::VaultLogRotator(std::uint64_t max_file_size, std::chrono::seconds max_file_age,
+                                 std::uint64_t budget)
+    : kMaxFileSize_(max_file_size),
+      kMaxFileAge_(max_file_age),
+      kBudget_(budget),
+      last_rotated_() {}
+
+void VaultLogRotator::Maintain(const fs::path& log_folder, std::time_t writer_started) {
+  const std::time_t kNow{std::time(nullptr)};
+  std::map<fs::path, std::time_t> last_rotated;
+  for (const auto& log_file : ListLogFiles(log_folder)) {
+    if (IsCompressed(log_file.path))
+      continue;
+    try {
+      if (log_file.last_write_time < writer_started) {
+        if (log_file.size == 0) {
+          fs::remove(log_file.path);
+        } else {
+          const fs::path kRotated{RotatedPath(log_file.path, kNow)};
+          fs::rename(log_file.path, kRotated);
+          CompressAndRemove(kRotated);
+        }
+        continue;
+      }
+
+      auto itr(last_rotated_.find(log_file.path));
+      std::time_t rotated_at{itr == std::end(last_rotated_) ? kNow : itr->second};
+      if (log_file.size != 0 &&
+          (log_file.size >= kMaxFileSize_ || kNow - rotated_at >= kMaxFileAge_.count())) {
+        const fs::path kRotated{RotatedPath(log_file.path, kNow)};
+        fs::copy_file(log_file.path, kRotated, fs::copy_option::overwrite_if_exists);
+        fs::resize_file(log_file.path, 0);
+        rotated_at = kNow;
+        CompressAndRemove(kRotated);
+      }
+      last_rotated.emplace(log_file.path, rotated_at);
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to rotate " << log_file.path << ": "
+                    << boost::diagnostic_information(e);
+    }
+  }
+  // Forget logs in this folder which have gone, but not those of other folders.
+  for (auto itr(std::begin(last_rotated_)); itr != std::end(last_rotated_);) {
+    if (itr->first.parent_path() == log_folder)
+      itr = last_rotated_.erase(itr);
+    else
+      ++itr;
+  }
+  last_rotated_.insert(std::begin(last_rotated), std::end(last_rotated));
+
+  std::vector<LogFile> log_files{ListLogFiles(log_folder)};
+  std::uint64_t total{0};
+  for (const auto& log_file : log_files)
+    total += log_file.size;
+  std::sort(std::begin(log_files), std::end(log_files), [](const LogFile& lhs, const LogFile& rhs) {
+    return lhs.last_write_time < rhs.last_write_time;
+  });
+  for (const auto& log_file : log_files) {
+    if (total <= kBudget_)
+      break;
+    if (!IsCompressed(log_file.path))
+      continue;
+    boost::system::error_code error_code;
+    if (fs::remove(log_file.path, error_code))
+      total -= log_file.size;
+    else
+      LOG(kWarning) << "Failed to remove " << log_file.path << ": " << error_code.message();
+  }
+  if (total > kBudget_) {
+    LOG(kWarning) << log_folder << " holds " << total << " bytes of open logs, exceeding its "
+                  << kBudget_ << " byte budget.";
+  }
+}
+
+void LowerThreadPriority() {
+#ifdef MAIDSAFE_WIN32
+  // Background mode lowers both the CPU and I/O priority of the thread.
+  SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__linux__)
+  // On Linux, niceness and I/O priority apply to the individual thread.
+  const auto kThreadId(static_cast<id_t>(syscall(SYS_gettid)));
+  setpriority(PRIO_PROCESS, kThreadId, 19);
+  const int kIoprioWhoProcess(1), kIoprioClassIdle(3), kIoprioClassShift(13);
+  syscall(SYS_ioprio_set, kIoprioWhoProcess, kThreadId, kIoprioClassIdle << kIoprioClassShift);
+#endif
+}
+
+void RestoreThreadPriority() {
+#ifdef MAIDSAFE_WIN32
+  SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+#endif
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,68 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_LOG_ROTATOR_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_LOG_ROTATOR_H_
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <map>
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Keeps each vault's log folder within a size budget.  Vaults can't be asked to reopen their logs,
+// so a log which may still be open is rotated by copying it aside and truncating it, as logrotate's
+// 'copytruncate' does; lines written in between are lost, and the vault must write in append mode.
+// Logs known to be closed are compressed where they lie.  Rotated logs are gzipped, and the oldest
+// are deleted while the folder exceeds its budget.  Open logs are never deleted, so the budget can
+// be exceeded by up to their size.  Not threadsafe.
+class VaultLogRotator {
+ public:
+  VaultLogRotator(std::uint64_t max_file_size, std::chrono::seconds max_file_age,
+                  std::uint64_t budget);
+
+  // Rotates any log in 'log_folder' which has reached 'max_file_size' or hasn't been rotated for
+  // 'max_file_age', then enforces the budget.  Logs last modified before 'writer_started' are
+  // treated as closed; pass the current time or later if no vault is writing to 'log_folder'.
+  void Maintain(const boost::filesystem::path& log_folder, std::time_t writer_started);
+
+ private:
+  const std::uint64_t kMaxFileSize_;
+  const std::chrono::seconds kMaxFileAge_;
+  const std::uint64_t kBudget_;
+  // Keyed by the path of each open log.
+  std::map<boost::filesystem::path, std::time_t> last_rotated_;
+};
+
+// Lowers the scheduling and I/O priority of the calling thread, where supported, so that
+// housekeeping doesn't compete with the vaults for the disks.  RestoreThreadPriority undoes this
+// before the thread is returned to a pool (Windows), and elsewhere does nothing since raising the
+// priority again needs privileges; there the thread should end once its work is done.
+void LowerThreadPriority();
+void RestoreThreadPriority();
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_LOG_ROTATOR_H_
@@ -18,12 +18,17 @@
 
 #include "maidsafe/vault_manager/vault_manager.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <future>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "boost/filesystem/operations.hpp"
 
-#include "maidsafe/common/application_support_directories.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/process.h"
@@ -35,24 +40,46 @@
 // #include "maidsafe/nfs/client/maid_client.h"
 
 #include "maidsafe/vault_manager/client_connections.h"
+#include "maidsafe/vault_manager/discovery_file.h"
 #include "maidsafe/vault_manager/new_connections.h"
 #include "maidsafe/vault_manager/process_manager.h"
+#include "maidsafe/vault_manager/storage_reservation.h"
 #include "maidsafe/vault_manager/utils.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/heartbeat.h"
+#include "maidsafe/vault_manager/messages/host_stats_request.h"
+#include "maidsafe/vault_manager/messages/host_stats_response.h"
 #include "maidsafe/vault_manager/messages/joined_network.h"
+#include "maidsafe/vault_manager/messages/list_vaults_request.h"
+#include "maidsafe/vault_manager/messages/list_vaults_response.h"
 #include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_progress.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_request.h"
+#include "maidsafe/vault_manager/messages/move_chunkstore_response.h"
 #include "maidsafe/vault_manager/messages/network_stable_request.h"
 #include "maidsafe/vault_manager/messages/network_stable_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/resume_session_response.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
 #include "maidsafe/vault_manager/messages/set_network_as_stable.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
+#include "maidsafe/vault_manager/messages/start_vaults_request.h"
+#include "maidsafe/vault_manager/messages/subscribe_to_vault_events_request.h"
+#include "maidsafe/vault_manager/messages/tail_vault_output_request.h"
+#include "maidsafe/vault_manager/messages/tail_vault_output_response.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/vault_drain_progress.h"
+#include "maidsafe/vault_manager/messages/vault_drained.h"
+#include "maidsafe/vault_manager/messages/unsubscribe_from_vault_events_request.h"
+#include "maidsafe/vault_manager/messages/vault_event_notification.h"
 #include "maidsafe/vault_manager/messages/validate_connection_request.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
-#include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
+#include "maidsafe/vault_manager/messages/vault_spawned.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
 #include "maidsafe/vault_manager/messages/vault_started_response.h"
+#include "maidsafe/vault_manager/messages/vault_stats_report.h"
 
 namespace fs = boost::filesystem;
 
@@ -62,18 +89,6 @@ namespace vault_manager {
 
 namespace {
 
-fs::path GetPath(const fs::path& p) {
-#ifdef TESTING
-  return (GetTestEnvironmentRootDir().empty() ? GetUserAppDir() : GetTestEnvironmentRootDir()) / p;
-#else
-  return GetSystemAppSupportDir() / p;
-#endif
-}
-
-fs::path GetConfigFilePath() { return GetPath(kConfigFilename); }
-
-fs::path GetVaultDir(const std::string& debug_id) { return GetPath(debug_id); }
-
 fs::path GetVaultExecutablePath() {
 #ifdef TESTING
   if (!GetPathToVault().empty())
@@ -82,6 +97,18 @@ fs::path GetVaultExecutablePath() {
   return process::GetOtherExecutablePath(fs::path{"vault"});
 }
 
+// The first message on every connection carries the peer's protocol version.  A peer using another
+// version has its connection closed, since none of its later messages could be relied upon to
+// parse correctly.  (Peers predating the version field fail to parse their first message, so are
+// closed once their new connection times out.)
+bool IsCurrentProtocolVersion(std::uint32_t protocol_version) {
+  if (protocol_version == kProtocolVersion)
+    return true;
+  LOG(kError) << "Rejecting connection using protocol version " << protocol_version
+              << "; this VaultManager uses version " << kProtocolVersion;
+  return false;
+}
+
 void PutPmidAndSigner(const passport::PmidAndSigner& /*pmid_and_signer*/) {
 //  std::shared_ptr<nfs_client::MaidClient> client_nfs(
 //    nfs_client::MaidClient::MakeShared(passport::MaidAndSigner{passport::CreateMaidAndSigner()}));
@@ -90,21 +117,106 @@ void PutPmidAndSigner(const passport::PmidAndSigner& /*pmid_and_signer*/) {
 //  client_nfs->Stop();
 }
 
+VaultInfo ToVaultInfo(const Identity& owner_name, StartVaultRequest&& start_vault_request) {
+  VaultInfo vault_info;
+  vault_info.label = std::move(start_vault_request.vault_label);
+  vault_info.vault_dir = std::move(start_vault_request.vault_dir);
+  vault_info.max_disk_usage = start_vault_request.max_disk_usage;
+  vault_info.owner_name = owner_name;
+#ifdef TESTING
+  if (start_vault_request.pmid_list_index) {
+    vault_info.pmid_and_signer = std::make_shared<passport::PmidAndSigner>(
+        GetPmidAndSigner(*start_vault_request.pmid_list_index));
+  }
+#endif
+#ifdef USE_VLOGGING
+  vault_info.vlog_session_id = std::move(start_vault_request.vlog_session_id);
+#ifdef TESTING
+  vault_info.send_hostname_to_visualiser_server =
+      start_vault_request.send_hostname_to_visualiser_server;
+#endif
+#endif
+  return vault_info;
+}
+
+// Creates and stores keys for the vault if it doesn't have any, and creates its default vault dir
+// if none was specified.  The default is under 'storage_root' if given, else the app support dir.
+void CreateKeysAndVaultDir(VaultInfo& vault_info, const fs::path& storage_root) {
+  if (!vault_info.pmid_and_signer) {
+    vault_info.pmid_and_signer =
+        std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+    PutPmidAndSigner(*vault_info.pmid_and_signer);
+  }
+  if (vault_info.vault_dir.empty()) {
+    const std::string kDirName{hex::Substr(vault_info.pmid_and_signer->first.name())};
+    vault_info.vault_dir = storage_root.empty() ? GetVaultDir(kDirName) : storage_root / kDirName;
+    if (!fs::exists(vault_info.vault_dir))
+      fs::create_directories(vault_info.vault_dir);
+  }
+}
+
+// Applies CreateKeysAndVaultDir to each vault using up to one thread per core, since key generation
+// dominates the cost of starting a vault.  Returns the outcome for each vault.
+std::vector<maidsafe_error> CreateKeysAndVaultDirs(std::vector<VaultInfo>& vault_infos,
+                                                   const std::vector<fs::path>& storage_roots) {
+  std::vector<maidsafe_error> results(vault_infos.size(), MakeError(CommonErrors::success));
+  ParallelFor(vault_infos.size(), [&](std::size_t index) {
+    try {
+      CreateKeysAndVaultDir(vault_infos[index], storage_roots[index]);
+    } catch (const maidsafe_error& error) {
+      LOG(kWarning) << boost::diagnostic_information(error);
+      results[index] = error;
+    } catch (const std::exception& e) {
+      LOG(kWarning) << boost::diagnostic_information(e);
+      results[index] = MakeError(CommonErrors::unknown);
+    }
+  });
+  return results;
+}
+
 }  // unnamed namespace
 
-VaultManager::VaultManager()
-    : config_file_handler_(GetConfigFilePath()),
+VaultManager::VaultManager(VaultManagerOptions options)
+    : kOptions_(std::move(options)),
+      admission_control_(kOptions_),
+      config_file_handler_(GetConfigFilePath()),
+      vault_event_log_(),
+      vault_stats_history_(),
+      disk_budget_(kOptions_.disk_budget_fraction),
+      disk_usage_scanner_(0, kReservationFilename),
+      vault_placement_(kOptions_.storage_roots),
+      disk_usage_(),
+      reservations_(),
+      vault_log_rotator_(kOptions_.max_vault_log_file_size,
+                         kOptions_.max_vault_log_file_age, kOptions_.vault_log_budget),
+      chunkstore_moves_(),
       network_stable_(false),
       tear_down_with_interval_(false),
+      stopping_(false),
+      creating_keys_(),
       asio_service_(1),
       strand_(asio_service_.service()),
       listener_(tcp::Listener::MakeShared(
           strand_, [this](tcp::ConnectionPtr connection) { HandleNewConnection(connection); },
           GetInitialListeningPort())),
       process_manager_(ProcessManager::MakeShared(asio_service_.service(), GetVaultExecutablePath(),
-                                                  listener_->ListeningPort())),
+                                                  listener_->ListeningPort(),
+                                                  kOptions_.max_concurrent_vault_starts,
+                                                  [this](VaultEvent vault_event) {
+                                                    PublishVaultEvent(std::move(vault_event));
+                                                  },
+                                                  kOptions_.heartbeat_interval,
+                                                  kOptions_.heartbeat_miss_threshold,
+                                                  kOptions_.vault_drain_timeout,
+                                                  kOptions_.capture_vault_output)),
       client_connections_(ClientConnections::MakeShared(asio_service_.service())),
-      new_connections_(NewConnections::MakeShared(asio_service_.service())) {
+      new_connections_(NewConnections::MakeShared(asio_service_.service())),
+      disk_budget_timer_(),
+      disk_usage_scan_timer_(),
+      log_rotation_timer_(),
+      disk_usage_scan_(),
+      log_rotation_(),
+      key_creations_() {
   std::vector<VaultInfo> vaults{config_file_handler_.ReadConfigFile()};
   if (vaults.empty()) {
 #ifndef TESTING
@@ -126,22 +238,44 @@ VaultManager::VaultManager()
     vault_info.vault_dir = GetVaultDir(DebugId(vault_info.pmid_and_signer->first.name().value));
     if (!fs::exists(vault_info.vault_dir))
       fs::create_directories(vault_info.vault_dir);
-    auto space_info(fs::space(vault_info.vault_dir));
-    vault_info.max_disk_usage = DiskUsage{(9 * space_info.available) / 10};
+    // No limit is requested, so the vault is allocated a share of the disk budget once started.
     vault_info.label = GenerateLabel();
     process_manager_->AddProcess(std::move(vault_info));
     LOG(kSuccess) << "Vault process handed over to process manager.";
     config_file_handler_.WriteConfigFile(process_manager_->GetAll());
 #endif
   } else {
-    for (auto& vault_info : vaults)
-      process_manager_->AddProcess(std::move(vault_info));
+    // Vaults left running by a previous VaultManager are adopted rather than restarted, provided
+    // they reconnect.
+    for (auto& vault_info : vaults) {
+      const ProcessId kProcessId{vault_info.process_id};
+      if (kProcessId == 0 || !process_manager_->AdoptProcess(vault_info, kProcessId))
+        process_manager_->AddProcess(std::move(vault_info));
+    }
   }
+  WriteDiscoveryFile(GetDiscoveryFilePath(),
+                     DiscoveryInfo{listener_->ListeningPort(), process::GetProcessId(),
+                                   kProtocolVersion});
+  asio_service_.service().post([this] {
+    vault_placement_.SampleIoUtilisation();
+    ArmDiskBudgetTimer();
+    if (kOptions_.disk_usage_scan_interval > std::chrono::seconds(0))
+      ScanDiskUsage();
+    ArmDiskUsageScanTimer();
+    ArmLogRotationTimer();
+  });
   LOG(kInfo) << "VaultManager started";
 }
 
 void VaultManager::TearDownWithInterval() {
   tear_down_with_interval_ = true;
+  RemoveDiscoveryFile(GetDiscoveryFilePath(), process::GetProcessId());
+  asio_service_.service().post([this] {
+    stopping_ = true;
+    disk_budget_timer_.Cancel();
+    disk_usage_scan_timer_.Cancel();
+    log_rotation_timer_.Cancel();
+  });
   auto listener(listener_);
   auto new_connections(new_connections_);
   auto client_connections(client_connections_);
@@ -158,21 +292,58 @@ void VaultManager::TearDownWithInterval() {
 
 VaultManager::~VaultManager() {
   if (!tear_down_with_interval_) {
+    RemoveDiscoveryFile(GetDiscoveryFilePath(), process::GetProcessId());
+    asio_service_.service().post([this] {
+      stopping_ = true;
+      disk_budget_timer_.Cancel();
+      disk_usage_scan_timer_.Cancel();
+      log_rotation_timer_.Cancel();
+    });
     auto listener(listener_);
     auto new_connections(new_connections_);
     auto client_connections(client_connections_);
     auto process_manager(process_manager_);
+    const bool stop_vaults{kOptions_.stop_vaults_on_exit};
     asio_service_.service().post([=] {
       listener->StopListening();
       new_connections->CloseAll();
       client_connections->CloseAll();
-      process_manager->StopAll();
+      if (stop_vaults)
+        process_manager->StopAll();
+      else
+        process_manager->ReleaseAll();
     });
     asio_service_.Stop();
   }
 }
 
+AdmissionCounters VaultManager::GetAdmissionCounters() const {
+  return admission_control_.GetCounters();
+}
+
+std::future<void> VaultManager::UpgradeVaults(fs::path new_executable_path, int wave_size,
+                                              std::chrono::steady_clock::duration wave_timeout) {
+  auto done(std::make_shared<std::promise<void>>());
+  asio_service_.service().post([=] {
+    try {
+      process_manager_->UpgradeVaults(new_executable_path, wave_size, wave_timeout,
+                                      [done](maidsafe_error error) {
+        if (error.code() == make_error_code(CommonErrors::success))
+          done->set_value();
+        else
+          done->set_exception(std::make_exception_ptr(error));
+      });
+    } catch (const std::exception&) {
+      done->set_exception(std::current_exception());
+    }
+  });
+  return done->get_future();
+}
+
 void VaultManager::HandleNewConnection(tcp::ConnectionPtr connection) {
+  // Rejected connections are closed before being started, so no read is ever posted for them.
+  if (!admission_control_.AdmitNewConnection(new_connections_->Size()))
+    return connection->Close();
   new_connections_->Add(connection);
   tcp::MessageReceivedFunctor on_message{
       [=](tcp::Message message) { HandleReceivedMessage(connection, std::move(message)); }};
@@ -180,6 +351,14 @@ void VaultManager::HandleNewConnection(tcp::ConnectionPtr connection) {
 }
 
 void VaultManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
+  vault_event_log_.RemoveSubscriber(connection);
+  // The vault's previous dir is still the one recorded, so it'll be restarted using that.
+  for (auto itr(std::begin(chunkstore_moves_)); itr != std::end(chunkstore_moves_);) {
+    if (itr->second.tcp_connection == connection)
+      itr = chunkstore_moves_.erase(itr);
+    else
+      ++itr;
+  }
   if (process_manager_->HandleConnectionClosed(connection) ||
       client_connections_->Remove(connection)) {
     return;
@@ -194,17 +373,63 @@ void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Mes
     Parse(binary_input_stream, tag);
     switch (tag) {
       case MessageTag::kValidateConnectionRequest:
-        HandleValidateConnectionRequest(connection);
+        HandleValidateConnectionRequest(connection,
+                                        Parse<ValidateConnectionRequest>(binary_input_stream));
         break;
       case MessageTag::kChallengeResponse:
         HandleChallengeResponse(connection, Parse<ChallengeResponse>(binary_input_stream));
         break;
+      case MessageTag::kResumeSessionRequest:
+        HandleResumeSessionRequest(connection, Parse<ResumeSessionRequest>(binary_input_stream));
+        break;
       case MessageTag::kStartVaultRequest:
         HandleStartVaultRequest(connection, Parse<StartVaultRequest>(binary_input_stream));
         break;
+      case MessageTag::kStartVaultsRequest:
+        HandleStartVaultsRequest(connection, Parse<StartVaultsRequest>(binary_input_stream));
+        break;
       case MessageTag::kTakeOwnershipRequest:
         HandleTakeOwnershipRequest(connection, Parse<TakeOwnershipRequest>(binary_input_stream));
         break;
+      case MessageTag::kListVaultsRequest:
+        HandleListVaultsRequest(connection, Parse<ListVaultsRequest>(binary_input_stream));
+        break;
+      case MessageTag::kSubscribeToVaultEventsRequest:
+        HandleSubscribeToVaultEventsRequest(
+            connection, Parse<SubscribeToVaultEventsRequest>(binary_input_stream));
+        break;
+      case MessageTag::kUnsubscribeFromVaultEventsRequest:
+        HandleUnsubscribeFromVaultEvents(connection);
+        break;
+      case MessageTag::kHostStatsRequest:
+        HandleHostStatsRequest(connection, Parse<HostStatsRequest>(binary_input_stream));
+        break;
+      case MessageTag::kTailVaultOutputRequest:
+        HandleTailVaultOutputRequest(connection,
+                                     Parse<TailVaultOutputRequest>(binary_input_stream));
+        break;
+      case MessageTag::kVaultStatsReport:
+        HandleVaultStatsReport(connection, Parse<VaultStatsReport>(binary_input_stream));
+        break;
+      case MessageTag::kMoveChunkstoreProgress:
+        HandleMoveChunkstoreProgress(connection,
+                                     Parse<MoveChunkstoreProgress>(binary_input_stream));
+        break;
+      case MessageTag::kMoveChunkstoreResponse:
+        HandleMoveChunkstoreResponse(connection,
+                                     Parse<MoveChunkstoreResponse>(binary_input_stream));
+        break;
+      case MessageTag::kHeartbeat:
+        process_manager_->HandleHeartbeat(connection,
+                                          Parse<Heartbeat>(binary_input_stream).progress);
+        break;
+      case MessageTag::kVaultDrainProgress:
+        process_manager_->HandleDrainProgress(
+            connection, Parse<VaultDrainProgress>(binary_input_stream).remaining);
+        break;
+      case MessageTag::kVaultDrained:
+        process_manager_->HandleDrained(connection);
+        break;
       case MessageTag::kVaultStarted:
         HandleVaultStarted(connection, Parse<VaultStarted>(binary_input_stream));
         break;
@@ -230,8 +455,13 @@ void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Mes
   }
 }
 
-void VaultManager::HandleValidateConnectionRequest(tcp::ConnectionPtr connection) {
+void VaultManager::HandleValidateConnectionRequest(
+    tcp::ConnectionPtr connection, ValidateConnectionRequest&& validate_connection_request) {
+  if (!IsCurrentProtocolVersion(validate_connection_request.protocol_version))
+    return connection->Close();
   RemoveFromNewConnections(connection);
+  if (!admission_control_.AdmitUnvalidatedClient(client_connections_->UnvalidatedCount()))
+    return connection->Close();
   asymm::PlainText plain_text{RandomBytes(100, 200)};
 
   client_connections_->Add(connection, plain_text);
@@ -242,43 +472,42 @@ void VaultManager::HandleChallengeResponse(tcp::ConnectionPtr connection,
                                            ChallengeResponse&& challenge_response) {
   client_connections_->Validate(connection, *challenge_response.public_maid,
                                 challenge_response.signature);
+  Send(connection, SessionTicket(CreateSessionTicket(challenge_response.public_maid->Name(),
+                                                     config_file_handler_.SessionTicketKey())));
 }
 
+void VaultManager::HandleResumeSessionRequest(tcp::ConnectionPtr connection,
+                                              ResumeSessionRequest&& resume_session_request) {
+  if (!IsCurrentProtocolVersion(resume_session_request.protocol_version))
+    return connection->Close();
+  if (!new_connections_->RecordResumeAttempt(connection)) {
+    LOG(kWarning) << "Only one session resumption attempt is allowed per new connection.";
+    return connection->Close();
+  }
+  try {
+    Identity client_name{
+        ParseSessionTicket(resume_session_request.ticket, config_file_handler_.SessionTicketKey())};
+    client_connections_->AddValidated(connection, client_name);
+    RemoveFromNewConnections(connection);
+    Send(connection, ResumeSessionResponse(CreateSessionTicket(
+                         client_name, config_file_handler_.SessionTicketKey())));
+  } catch (const maidsafe_error& error) {
+    // The client can fall back to requesting a Challenge on this connection, but must do so before
+    // the connection's original deadline.
+    Send(connection, ResumeSessionResponse(error));
+  }
+}
 
 void VaultManager::HandleStartVaultRequest(tcp::ConnectionPtr connection,
                                            StartVaultRequest&& start_vault_request) {
   maidsafe_error error{MakeError(CommonErrors::unknown)};
-  VaultInfo vault_info;
+  NonEmptyString label{start_vault_request.vault_label};
   try {
     Identity client_name{client_connections_->FindValidated(connection)};
-    vault_info.label = std::move(start_vault_request.vault_label);
-    vault_info.max_disk_usage = start_vault_request.max_disk_usage;
-    vault_info.owner_name = client_name;
-#ifdef TESTING
-    if (start_vault_request.pmid_list_index) {
-      vault_info.pmid_and_signer = std::make_shared<passport::PmidAndSigner>(
-          GetPmidAndSigner(*start_vault_request.pmid_list_index));
-    }
-#endif
-    if (!vault_info.pmid_and_signer) {
-      vault_info.pmid_and_signer =
-          std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
-      PutPmidAndSigner(*vault_info.pmid_and_signer);
-    }
-    if (start_vault_request.vault_dir.empty()) {
-      vault_info.vault_dir = GetVaultDir(hex::Substr(vault_info.pmid_and_signer->first.name()));
-      if (!fs::exists(vault_info.vault_dir))
-        fs::create_directories(vault_info.vault_dir);
-    } else {
-      vault_info.vault_dir = std::move(start_vault_request.vault_dir);
-    }
-#ifdef USE_VLOGGING
-    vault_info.vlog_session_id = std::move(start_vault_request.vlog_session_id);
-#ifdef TESTING
-    vault_info.send_hostname_to_visualiser_server =
-        start_vault_request.send_hostname_to_visualiser_server;
-#endif
-#endif
+    if (IsRepeatedStartVaultRequest(connection, client_name, label))
+      return;
+    VaultInfo vault_info{ToVaultInfo(client_name, std::move(start_vault_request))};
+    CreateKeysAndVaultDir(vault_info, ChooseStorageRoots({vault_info}).front());
     process_manager_->AddProcess(std::move(vault_info));
     config_file_handler_.WriteConfigFile(process_manager_->GetAll());
     return;
@@ -289,7 +518,90 @@ void VaultManager::HandleStartVaultRequest(tcp::ConnectionPtr connection,
     LOG(kWarning) << boost::diagnostic_information(e);
   }
   LOG(kError) << "VaultManager::HandleStartVaultRequest reporting error";
-  Send(connection, VaultRunningResponse(std::move(vault_info.label), std::move(error)));
+  Send(connection, VaultRunningResponse(std::move(label), std::move(error)));
+}
+
+void VaultManager::HandleStartVaultsRequest(tcp::ConnectionPtr connection,
+                                            StartVaultsRequest&& start_vaults_request) {
+  Identity client_name;
+  try {
+    client_name = client_connections_->FindValidated(connection);
+  } catch (const maidsafe_error& error) {
+    LOG(kError) << "VaultManager::HandleStartVaultsRequest reporting error: "
+                << boost::diagnostic_information(error);
+    for (auto& start_vault_request : start_vaults_request.vault_requests)
+      Send(connection, VaultRunningResponse(std::move(start_vault_request.vault_label), error));
+    return;
+  }
+
+  std::vector<VaultInfo> vault_infos;
+  for (auto& start_vault_request : start_vaults_request.vault_requests) {
+    try {
+      if (IsRepeatedStartVaultRequest(connection, client_name, start_vault_request.vault_label))
+        continue;
+    } catch (const maidsafe_error& error) {
+      Send(connection, VaultRunningResponse(start_vault_request.vault_label, error));
+      continue;
+    }
+    vault_infos.emplace_back(ToVaultInfo(client_name, std::move(start_vault_request)));
+  }
+  if (vault_infos.empty())
+    return;
+
+  // Key generation takes far too long to be done on the io_service's only thread.
+  const std::vector<fs::path> kStorageRoots{ChooseStorageRoots(vault_infos)};
+  for (const auto& vault_info : vault_infos)
+    creating_keys_.emplace(vault_info.label, client_name);
+  key_creations_.erase(std::remove_if(std::begin(key_creations_), std::end(key_creations_),
+                                      [](const std::future<void>& key_creation) {
+                         return key_creation.wait_for(std::chrono::seconds(0)) ==
+                                std::future_status::ready;
+                       }),
+                       std::end(key_creations_));
+  const int kMaxConcurrentStarts{start_vaults_request.max_concurrent_starts};
+  key_creations_.emplace_back(std::async(std::launch::async, [=]() mutable {
+    std::vector<maidsafe_error> results{CreateKeysAndVaultDirs(vault_infos, kStorageRoots)};
+    strand_.post([=]() mutable {
+      AddVaultsWithKeys(client_name, kMaxConcurrentStarts, std::move(vault_infos),
+                        std::move(results));
+    });
+  }));
+}
+
+void VaultManager::AddVaultsWithKeys(const Identity& client_name, int max_concurrent_starts,
+                                     std::vector<VaultInfo> vault_infos,
+                                     std::vector<maidsafe_error> results) {
+  for (const auto& vault_info : vault_infos)
+    creating_keys_.erase(vault_info.label);
+  if (stopping_)
+    return;
+
+  std::vector<VaultInfo> vaults_to_add;
+  for (std::size_t i(0); i < vault_infos.size(); ++i) {
+    if (results[i].code() == make_error_code(CommonErrors::success)) {
+      vaults_to_add.emplace_back(std::move(vault_infos[i]));
+      continue;
+    }
+    try {
+      tcp::ConnectionPtr client{client_connections_->FindValidated(client_name)};
+      Send(client, VaultRunningResponse(vault_infos[i].label, std::move(results[i])));
+    } catch (const std::exception&) {
+    }  // We don't care if the client isn't connected.
+  }
+
+  process_manager_->AddProcesses(
+      std::move(vaults_to_add), max_concurrent_starts,
+      [this, client_name](const NonEmptyString& label, maidsafe_error error) {
+        LOG(kError) << "Failed to start vault with label " << hex::Encode(label);
+        try {
+          tcp::ConnectionPtr client{client_connections_->FindValidated(client_name)};
+          Send(client, VaultRunningResponse(label, std::move(error)));
+        } catch (const std::exception&) {
+        }  // We don't care if the client isn't connected.
+        config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+      });
+  // Written once for the whole batch, including those vaults still queued for starting.
+  config_file_handler_.WriteConfigFile(process_manager_->GetAll());
 }
 
 void VaultManager::HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
@@ -308,16 +620,18 @@ void VaultManager::HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
       vault_info.vault_dir = new_vault_dir;
       vault_info.max_disk_usage = new_max_disk_usage;
       vault_info.owner_name = client_name;
-      return ChangeChunkstorePath(std::move(vault_info));
+      // The client is sent the VaultRunningResponse once the vault has been restarted.
+      if (!vault_info.tcp_connection)
+        return RestartWithVaultDir(std::move(vault_info));
+      ChangeChunkstorePath(vault_info);
     }
 
-    if (vault_info.max_disk_usage != new_max_disk_usage && new_max_disk_usage != 0U)
-      Send(vault_info.tcp_connection, MaxDiskUsageUpdate(new_max_disk_usage));
-
+    // The requested limit caps the vault's share of the disk budget; 0 removes the cap.
     process_manager_->AssignOwner(label, client_name, new_max_disk_usage);
+    RebalanceDiskBudget();
     config_file_handler_.WriteConfigFile(process_manager_->GetAll());
-    Send(connection,
-         VaultRunningResponse(std::move(label), std::move(*vault_info.pmid_and_signer)));
+    // The keys are shared with the process manager's copy, so mustn't be moved from.
+    Send(connection, VaultRunningResponse(std::move(label), *vault_info.pmid_and_signer));
     return;
   } catch (const maidsafe_error& e) {
     LOG(kWarning) << boost::diagnostic_information(e);
@@ -328,10 +642,104 @@ void VaultManager::HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
   Send(connection, VaultRunningResponse(std::move(vault_info.label), std::move(error)));
 }
 
+void VaultManager::HandleListVaultsRequest(tcp::ConnectionPtr connection,
+                                           ListVaultsRequest&& list_vaults_request) {
+  try {
+    client_connections_->FindValidated(connection);
+    std::vector<VaultStatus> statuses{process_manager_->GetStatuses()};
+    for (auto& vault_status : statuses) {
+      auto itr(disk_usage_.find(vault_status.label));
+      if (itr != std::end(disk_usage_)) {
+        vault_status.disk_usage = itr->second.bytes;
+        vault_status.disk_usage_growth = itr->second.bytes_per_second;
+      }
+    }
+    if (list_vaults_request.vault_label) {
+      statuses.erase(std::remove_if(std::begin(statuses), std::end(statuses),
+                                    [&](const VaultStatus& vault_status) {
+                       return vault_status.label != *list_vaults_request.vault_label;
+                     }),
+                     std::end(statuses));
+    }
+    Send(connection, ListVaultsResponse(list_vaults_request.request_id, std::move(statuses)));
+  } catch (const maidsafe_error& error) {
+    LOG(kWarning) << boost::diagnostic_information(error);
+    Send(connection, ListVaultsResponse(list_vaults_request.request_id, error));
+  }
+}
+
+void VaultManager::HandleSubscribeToVaultEventsRequest(
+    tcp::ConnectionPtr connection, SubscribeToVaultEventsRequest&& subscribe_request) {
+  client_connections_->FindValidated(connection);
+  vault_event_log_.AddSubscriber(connection);
+  // Replay before any new event can be published, so the subscriber sees them in order.
+  for (auto& vault_event : vault_event_log_.Since(subscribe_request.after_sequence_number))
+    Send(connection, VaultEventNotification(std::move(vault_event)));
+}
+
+void VaultManager::HandleUnsubscribeFromVaultEvents(tcp::ConnectionPtr connection) {
+  vault_event_log_.RemoveSubscriber(connection);
+}
+
+void VaultManager::HandleHostStatsRequest(tcp::ConnectionPtr connection,
+                                          HostStatsRequest&& host_stats_request) {
+  try {
+    client_connections_->FindValidated(connection);
+    Send(connection,
+         HostStatsResponse(host_stats_request.request_id,
+                           vault_stats_history_.GetHostStats(process_manager_->GetStatuses())));
+  } catch (const maidsafe_error& error) {
+    LOG(kWarning) << boost::diagnostic_information(error);
+    Send(connection, HostStatsResponse(host_stats_request.request_id, error));
+  }
+}
+
+void VaultManager::HandleTailVaultOutputRequest(
+    tcp::ConnectionPtr connection, TailVaultOutputRequest&& tail_vault_output_request) {
+  try {
+    Identity client_name{client_connections_->FindValidated(connection)};
+    // Vault output can include anything the vault logs, so is only available to its owner.
+    if (process_manager_->Find(tail_vault_output_request.vault_label).owner_name != client_name) {
+      LOG(kError) << "Vault " << hex::Encode(tail_vault_output_request.vault_label)
+                  << " isn't owned by the client requesting its output.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+    }
+    Send(connection, TailVaultOutputResponse(
+                         tail_vault_output_request.request_id,
+                         process_manager_->TailOutput(tail_vault_output_request.vault_label,
+                                                      tail_vault_output_request.cursor,
+                                                      kMaxVaultOutputChunkSize)));
+  } catch (const maidsafe_error& error) {
+    LOG(kWarning) << boost::diagnostic_information(error);
+    Send(connection, TailVaultOutputResponse(tail_vault_output_request.request_id, error));
+  }
+}
+
+void VaultManager::PublishVaultEvent(VaultEvent vault_event) {
+  VaultEvent recorded_event{vault_event_log_.Record(std::move(vault_event))};
+  for (const auto& subscriber : vault_event_log_.Subscribers())
+    Send(subscriber, VaultEventNotification(recorded_event));
+  if (recorded_event.type != VaultEventType::kSpawned)
+    return;
+  // The owner times the vault's start from now, since it may have been queued for some time.
+  try {
+    VaultInfo vault_info{process_manager_->Find(recorded_event.label)};
+    if (vault_info.owner_name.IsInitialised()) {
+      tcp::ConnectionPtr client{client_connections_->FindValidated(vault_info.owner_name)};
+      Send(client, VaultSpawned(recorded_event.label));
+    }
+  } catch (const std::exception&) {
+  }  // We don't care if the client isn't connected.
+}
+
 void VaultManager::ChangeChunkstorePath(VaultInfo vault_info) {
-  // TODO(Fraser#5#): 2014-05-13 - Handle sending a "MoveChunkstoreRequest" to avoid stopping then
-  //                               restarting the vault.
-  Send(vault_info.tcp_connection, VaultShutdownRequest());
+  Send(vault_info.tcp_connection,
+       MoveChunkstoreRequest(vault_info.vault_dir, kOptions_.chunkstore_move_bytes_per_second));
+  NonEmptyString label{vault_info.label};
+  chunkstore_moves_[label] = std::move(vault_info);
+}
+
+void VaultManager::RestartWithVaultDir(VaultInfo vault_info) {
   ProcessManager::OnExitFunctor on_exit{
       [this, vault_info](maidsafe_error /*error*/, int /*exit_code*/) {
         process_manager_->AddProcess(std::move(vault_info));
@@ -345,13 +753,22 @@ void VaultManager::HandleVaultStarted(tcp::ConnectionPtr connection, VaultStarte
   //                  could have spotted a new vault process starting and jumped in with this TCP
   //                  connection before the new vault can connect, passing itself off as the new
   //                  vault (i.e. lying about its own Process ID).
+  // A vault using another protocol version is treated like any vault which fails to start, so is
+  // restarted (or causes an upgrade to it to be rolled back).
+  if (!IsCurrentProtocolVersion(vault_started.protocol_version))
+    return connection->Close();
   RemoveFromNewConnections(connection);
   VaultInfo vault_info{
       process_manager_->HandleVaultStarted(connection, {vault_started.process_id})};
+  // Record the process ID so that the vault can be adopted if this VaultManager restarts.
+  config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+  RebalanceDiskBudget(connection);
+  vault_info.max_disk_usage = disk_budget_.Allocation(vault_info.label, vault_info.max_disk_usage);
 
   // Send vault its credentials
   Send(vault_info.tcp_connection,
-       VaultStartedResponse(vault_info, config_file_handler_.SymmKeyAndIV()));
+       VaultStartedResponse(vault_info, config_file_handler_.SymmKeyAndIV(),
+                            kOptions_.heartbeat_interval));
 
   // If the corresponding client is connected, send it the credentials too
   if (vault_info.owner_name.IsInitialised()) {
@@ -389,7 +806,7 @@ void VaultManager::HandleNetworkStableRequest(tcp::ConnectionPtr connection) {
 
 void VaultManager::HandleJoinedNetwork(tcp::ConnectionPtr connection) {
   try {
-    VaultInfo vault_info(process_manager_->Find(connection));
+    VaultInfo vault_info(process_manager_->HandleJoinedNetwork(connection));
     // TODO(Prakash) do vault_info need joined field
     std::string log_message("Vault running as " +
                             hex::Substr(vault_info.pmid_and_signer->first.name()));
@@ -410,6 +827,234 @@ void VaultManager::HandleLogMessage(tcp::ConnectionPtr connection, LogMessage&&
   }  // We don't care if the client isn't connected.
 }
 
+void VaultManager::HandleVaultStatsReport(tcp::ConnectionPtr connection,
+                                          VaultStatsReport&& vault_stats_report) {
+  VaultInfo vault_info{process_manager_->Find(connection)};
+  vault_stats_history_.Add(vault_info.label, vault_stats_report.stats);
+  UpdateReservation(vault_info, vault_stats_report.stats.bytes_used);
+}
+
+void VaultManager::HandleMoveChunkstoreProgress(
+    tcp::ConnectionPtr connection, MoveChunkstoreProgress&& move_chunkstore_progress) {
+  LOG(kInfo) << "Vault " << hex::Encode(process_manager_->Find(connection).label)
+             << " has moved " << move_chunkstore_progress.bytes_moved << " of "
+             << move_chunkstore_progress.bytes_total << " bytes of its chunkstore.";
+}
+
+void VaultManager::HandleMoveChunkstoreResponse(
+    tcp::ConnectionPtr connection, MoveChunkstoreResponse&& move_chunkstore_response) {
+  NonEmptyString label{process_manager_->Find(connection).label};
+  auto itr(chunkstore_moves_.find(label));
+  if (itr == std::end(chunkstore_moves_) ||
+      itr->second.vault_dir != move_chunkstore_response.vault_dir) {
+    LOG(kWarning) << "Ignoring response to superseded chunkstore move for vault "
+                  << hex::Encode(label);
+    return;
+  }
+  VaultInfo vault_info{std::move(itr->second)};
+  chunkstore_moves_.erase(itr);
+
+  if (move_chunkstore_response.error) {
+    LOG(kWarning) << "Vault " << hex::Encode(label) << " failed to move its chunkstore ("
+                  << move_chunkstore_response.error->what() << ").  Restarting it instead.";
+    return RestartWithVaultDir(std::move(vault_info));
+  }
+  process_manager_->SetVaultDir(label, vault_info.vault_dir);
+  config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+  RebalanceDiskBudget();
+  LOG(kSuccess) << "Vault " << hex::Encode(label) << " moved its chunkstore to "
+                << vault_info.vault_dir;
+}
+
+void VaultManager::ArmDiskBudgetTimer() {
+  if (kOptions_.disk_budget_interval <= std::chrono::seconds(0))
+    return;
+  disk_budget_timer_ =
+      TimingWheel::Get(asio_service_.service()).Arm(kOptions_.disk_budget_interval, [this] {
+        vault_placement_.SampleIoUtilisation();
+        RebalanceDiskBudget();
+        ArmDiskBudgetTimer();
+      });
+}
+
+std::vector<fs::path> VaultManager::ChooseStorageRoots(
+    const std::vector<VaultInfo>& vault_infos) const {
+  std::vector<fs::path> storage_roots(vault_infos.size());
+  if (!vault_placement_.Enabled())
+    return storage_roots;
+  std::vector<fs::path> vault_dirs;
+  for (const auto& vault_info : process_manager_->GetAll())
+    vault_dirs.push_back(vault_info.vault_dir);
+  for (std::size_t i(0); i < vault_infos.size(); ++i) {
+    if (!vault_infos[i].vault_dir.empty())
+      continue;
+    try {
+      storage_roots[i] = vault_placement_.ChooseRoot(vault_dirs);
+    } catch (const std::exception& e) {
+      LOG(kError) << "Falling back to default vault dir: " << boost::diagnostic_information(e);
+      continue;
+    }
+    // Counted against the chosen root when placing the rest of the batch.
+    vault_dirs.push_back(storage_roots[i]);
+  }
+  return storage_roots;
+}
+
+void VaultManager::RebalanceDiskBudget(tcp::ConnectionPtr starting_vault) {
+  std::vector<VaultInfo> vault_infos{process_manager_->GetAll()};
+  HostStats host_stats{vault_stats_history_.GetHostStats(process_manager_->GetStatuses())};
+  std::vector<DiskBudget::Vault> vaults;
+  for (const auto& vault_info : vault_infos) {
+    DiskBudget::Vault vault;
+    vault.label = vault_info.label;
+    vault.vault_dir = vault_info.vault_dir;
+    vault.requested = vault_info.max_disk_usage;
+    vault.bytes_used = 0;
+    auto itr(std::find_if(std::begin(host_stats.vaults), std::end(host_stats.vaults),
+                          [&](const VaultStatsSummary& summary) {
+      return summary.label == vault_info.label;
+    }));
+    if (itr != std::end(host_stats.vaults))
+      vault.bytes_used = itr->latest.bytes_used;
+    auto measured(disk_usage_.find(vault_info.label));
+    if (measured != std::end(disk_usage_))
+      vault.bytes_used = std::max(vault.bytes_used, measured->second.bytes);
+    auto reservation(reservations_.find(vault_info.label));
+    vault.reserved = reservation == std::end(reservations_) ? 0 : reservation->second.size;
+    vaults.push_back(std::move(vault));
+  }
+
+  for (const auto& allocation : disk_budget_.Rebalance(vaults)) {
+    auto itr(std::find_if(std::begin(vault_infos), std::end(vault_infos),
+                          [&](const VaultInfo& vault_info) {
+      return vault_info.label == allocation.first;
+    }));
+    if (itr->tcp_connection && itr->tcp_connection != starting_vault)
+      Send(itr->tcp_connection, MaxDiskUsageUpdate(allocation.second));
+  }
+  for (std::size_t i(0); i < vault_infos.size(); ++i)
+    UpdateReservation(vault_infos[i], vaults[i].bytes_used);
+}
+
+void VaultManager::ArmLogRotationTimer() {
+  if (kOptions_.vault_log_budget == 0)
+    return;
+  log_rotation_timer_ =
+      TimingWheel::Get(asio_service_.service()).Arm(kLogRotationInterval, [this] {
+        RotateVaultLogs();
+        ArmLogRotationTimer();
+      });
+}
+
+void VaultManager::RotateVaultLogs() {
+  if (log_rotation_.valid() &&
+      log_rotation_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    LOG(kWarning) << "Previous vault log rotation is still running.";
+    return;
+  }
+  // The start time of an adopted vault isn't known, so the logs of any vault with a process are
+  // all treated as open.  Those of a vault without one are closed, bar any created from now on.
+  const std::time_t kNow{std::time(nullptr)};
+  std::vector<VaultStatus> statuses{process_manager_->GetStatuses()};
+  std::vector<std::pair<fs::path, std::time_t>> log_folders;
+  for (const auto& vault_info : process_manager_->GetAll()) {
+    if (vault_info.vault_dir.empty())
+      continue;
+    auto itr(std::find_if(std::begin(statuses), std::end(statuses), [&](const VaultStatus& status) {
+      return status.label == vault_info.label;
+    }));
+    const bool kRunning{itr != std::end(statuses) && itr->status != ProcessStatus::kBeforeStarted};
+    log_folders.emplace_back(vault_info.vault_dir / "logs", kRunning ? 0 : kNow);
+  }
+  log_rotation_ = std::async(std::launch::async, [this, log_folders] {
+    LowerThreadPriority();
+    for (const auto& log_folder : log_folders)
+      vault_log_rotator_.Maintain(log_folder.first, log_folder.second);
+    RestoreThreadPriority();
+  });
+}
+
+void VaultManager::UpdateReservation(const VaultInfo& vault_info, std::uint64_t bytes_used) {
+  if (kOptions_.reservation_fraction <= 0.0 || vault_info.vault_dir.empty())
+    return;
+  auto itr(reservations_.find(vault_info.label));
+  if (itr == std::end(reservations_)) {
+    itr = reservations_.emplace(vault_info.label, Reservation{vault_info.vault_dir,
+                                                              GetReservation(vault_info.vault_dir)})
+              .first;
+  } else if (itr->second.vault_dir != vault_info.vault_dir) {
+    // The vault has moved its chunkstore, so the reservation in its old vault dir is released.
+    try {
+      SetReservation(itr->second.vault_dir, 0);
+    } catch (const std::exception&) {
+    }  // Logged by SetReservation.
+    itr->second = Reservation{vault_info.vault_dir, GetReservation(vault_info.vault_dir)};
+  }
+
+  const std::uint64_t kSize{
+      ReservationSize(disk_budget_.Allocation(vault_info.label, vault_info.max_disk_usage),
+                      bytes_used, kOptions_.reservation_fraction)};
+  if (kSize == itr->second.size)
+    return;
+  try {
+    SetReservation(vault_info.vault_dir, kSize);
+    itr->second.size = kSize;
+  } catch (const std::exception&) {
+    itr->second.size = GetReservation(vault_info.vault_dir);
+  }
+}
+
+void VaultManager::ArmDiskUsageScanTimer() {
+  if (kOptions_.disk_usage_scan_interval <= std::chrono::seconds(0))
+    return;
+  disk_usage_scan_timer_ =
+      TimingWheel::Get(asio_service_.service()).Arm(kOptions_.disk_usage_scan_interval, [this] {
+        ScanDiskUsage();
+        ArmDiskUsageScanTimer();
+      });
+}
+
+void VaultManager::ScanDiskUsage() {
+  if (disk_usage_scan_.valid() &&
+      disk_usage_scan_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    LOG(kWarning) << "Previous disk usage scan is still running.";
+    return;
+  }
+  std::vector<NonEmptyString> labels;
+  std::vector<fs::path> vault_dirs;
+  for (const auto& vault_info : process_manager_->GetAll()) {
+    labels.push_back(vault_info.label);
+    vault_dirs.push_back(vault_info.vault_dir);
+  }
+  disk_usage_scan_ = std::async(std::launch::async, [this, labels, vault_dirs] {
+    std::vector<std::uint64_t> totals{disk_usage_scanner_.Scan(vault_dirs)};
+    const auto kScannedAt(std::chrono::steady_clock::now());
+    asio_service_.service().post(
+        [this, labels, totals, kScannedAt] { RecordDiskUsage(labels, totals, kScannedAt); });
+  });
+}
+
+void VaultManager::RecordDiskUsage(const std::vector<NonEmptyString>& labels,
+                                   const std::vector<std::uint64_t>& totals,
+                                   std::chrono::steady_clock::time_point scanned_at) {
+  std::map<NonEmptyString, MeasuredDiskUsage> disk_usage;
+  for (std::size_t i(0); i < labels.size(); ++i) {
+    MeasuredDiskUsage measured{totals[i], 0, scanned_at};
+    auto itr(disk_usage_.find(labels[i]));
+    if (itr != std::end(disk_usage_)) {
+      const auto kElapsed(std::chrono::duration_cast<std::chrono::milliseconds>(
+          scanned_at - itr->second.scanned_at));
+      if (kElapsed.count() > 0) {
+        measured.bytes_per_second =
+            (static_cast<std::int64_t>(totals[i]) - static_cast<std::int64_t>(itr->second.bytes)) *
+            1000 / kElapsed.count();
+      }
+    }
+    disk_usage.emplace(labels[i], measured);
+  }
+  disk_usage_.swap(disk_usage);
+}
+
 void VaultManager::RemoveFromNewConnections(tcp::ConnectionPtr connection) {
   if (!new_connections_->Remove(connection)) {
     LOG(kWarning) << "Connection not found in new_connections_.";
@@ -417,6 +1062,38 @@ void VaultManager::RemoveFromNewConnections(tcp::ConnectionPtr connection) {
   }
 }
 
+// A reconnecting client re-sends requests which were in flight, so we may already have handled this
+// one.  If so, the vault's keys are re-sent if it's running (otherwise they'll be sent once it has
+// started) and true is returned.
+bool VaultManager::IsRepeatedStartVaultRequest(tcp::ConnectionPtr connection,
+                                               const Identity& client_name,
+                                               const NonEmptyString& label) {
+  // The client is sent the VaultRunningResponse once the vault has started.
+  auto creating_itr(creating_keys_.find(label));
+  if (creating_itr != std::end(creating_keys_)) {
+    if (creating_itr->second != client_name) {
+      LOG(kError) << "Vault label " << hex::Encode(label) << " is already owned by another client.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+    }
+    LOG(kInfo) << "Repeated request to start vault with label " << hex::Encode(label);
+    return true;
+  }
+
+  std::vector<VaultInfo> vaults{process_manager_->GetAll()};
+  auto itr(std::find_if(std::begin(vaults), std::end(vaults),
+                        [&label](const VaultInfo& vault) { return vault.label == label; }));
+  if (itr == std::end(vaults))
+    return false;
+  if (itr->owner_name != client_name) {
+    LOG(kError) << "Vault label " << hex::Encode(label) << " is already owned by another client.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  LOG(kInfo) << "Repeated request to start vault with label " << hex::Encode(label);
+  if (itr->tcp_connection)
+    Send(connection, VaultRunningResponse(label, *itr->pmid_and_signer));
+  return true;
+}
+
 }  // namespace vault_manager
 
 }  // namespace maidsafe
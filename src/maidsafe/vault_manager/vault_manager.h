@@ -19,20 +19,35 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_H_
 #define MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_H_
 
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "asio/io_service_strand.hpp"
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/crypto.h"
+#include "maidsafe/common/error.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/types.h"
 
+#include "maidsafe/vault_manager/admission_control.h"
 #include "maidsafe/vault_manager/config.h"
 #include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/disk_budget.h"
+#include "maidsafe/vault_manager/disk_usage_scanner.h"
+#include "maidsafe/vault_manager/timing_wheel.h"
+#include "maidsafe/vault_manager/vault_event_log.h"
 #include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/vault_log_rotator.h"
+#include "maidsafe/vault_manager/vault_placement.h"
+#include "maidsafe/vault_manager/vault_stats_history.h"
+#include "maidsafe/vault_manager/vault_manager_options.h"
 
 namespace maidsafe {
 
@@ -40,12 +55,22 @@ namespace vault_manager {
 
 struct ChallengeResponse;
 class ClientConnections;
+struct HostStatsRequest;
+struct ListVaultsRequest;
 struct LogMessage;
+struct MoveChunkstoreProgress;
+struct MoveChunkstoreResponse;
 class NewConnections;
 class ProcessManager;
+struct ResumeSessionRequest;
 struct StartVaultRequest;
+struct StartVaultsRequest;
+struct SubscribeToVaultEventsRequest;
+struct TailVaultOutputRequest;
 struct TakeOwnershipRequest;
+struct ValidateConnectionRequest;
 struct VaultStarted;
+struct VaultStatsReport;
 
 // The VaultManager has several responsibilities:
 // * Reads config file on startup and restarts vaults listed in file.
@@ -57,10 +82,16 @@ class VaultManager {
   VaultManager(VaultManager&&) = delete;
   VaultManager operator=(VaultManager) = delete;
 
-  VaultManager();
+  explicit VaultManager(VaultManagerOptions options = VaultManagerOptions());
   ~VaultManager();
 
   void TearDownWithInterval();
+  AdmissionCounters GetAdmissionCounters() const;
+  // Restarts all vaults onto 'new_executable_path' in waves of 'wave_size'.  The future throws if
+  // the upgrade was rolled back.  See ProcessManager::UpgradeVaults for details.
+  std::future<void> UpgradeVaults(
+      boost::filesystem::path new_executable_path, int wave_size = 1,
+      std::chrono::steady_clock::duration wave_timeout = kUpgradeWaveTimeout);
 
  private:
   void HandleNewConnection(tcp::ConnectionPtr connection);
@@ -68,13 +99,27 @@ class VaultManager {
   void HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Message&& message);
 
   // Messages from Client
-  void HandleValidateConnectionRequest(tcp::ConnectionPtr connection);
+  void HandleValidateConnectionRequest(tcp::ConnectionPtr connection,
+                                       ValidateConnectionRequest&& validate_connection_request);
   void HandleChallengeResponse(tcp::ConnectionPtr connection,
                                ChallengeResponse&& challenge_response);
+  void HandleResumeSessionRequest(tcp::ConnectionPtr connection,
+                                  ResumeSessionRequest&& resume_session_request);
   void HandleStartVaultRequest(tcp::ConnectionPtr connection,
                                StartVaultRequest&& start_vault_request);
+  void HandleStartVaultsRequest(tcp::ConnectionPtr connection,
+                                StartVaultsRequest&& start_vaults_request);
   void HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
                                   TakeOwnershipRequest&& take_ownership_request);
+  void HandleListVaultsRequest(tcp::ConnectionPtr connection,
+                               ListVaultsRequest&& list_vaults_request);
+  void HandleSubscribeToVaultEventsRequest(tcp::ConnectionPtr connection,
+                                           SubscribeToVaultEventsRequest&& subscribe_request);
+  void HandleUnsubscribeFromVaultEvents(tcp::ConnectionPtr connection);
+  void HandleHostStatsRequest(tcp::ConnectionPtr connection,
+                              HostStatsRequest&& host_stats_request);
+  void HandleTailVaultOutputRequest(tcp::ConnectionPtr connection,
+                                    TailVaultOutputRequest&& tail_vault_output_request);
   void HandleSetNetworkAsStable();
   void HandleNetworkStableRequest(tcp::ConnectionPtr connection);
 
@@ -82,18 +127,86 @@ class VaultManager {
   void HandleVaultStarted(tcp::ConnectionPtr connection, VaultStarted&& vault_started);
   void HandleJoinedNetwork(tcp::ConnectionPtr connection);
   void HandleLogMessage(tcp::ConnectionPtr connection, LogMessage&& log_message);
-
+  void HandleVaultStatsReport(tcp::ConnectionPtr connection,
+                              VaultStatsReport&& vault_stats_report);
+  void HandleMoveChunkstoreProgress(tcp::ConnectionPtr connection,
+                                    MoveChunkstoreProgress&& move_chunkstore_progress);
+  void HandleMoveChunkstoreResponse(tcp::ConnectionPtr connection,
+                                    MoveChunkstoreResponse&& move_chunkstore_response);
+
+  // Called once the keys for a batch of vaults have been created on a separate thread.
+  void AddVaultsWithKeys(const Identity& client_name, int max_concurrent_starts,
+                         std::vector<VaultInfo> vault_infos, std::vector<maidsafe_error> results);
   void RemoveFromNewConnections(tcp::ConnectionPtr connection);
+  bool IsRepeatedStartVaultRequest(tcp::ConnectionPtr connection, const Identity& client_name,
+                                   const NonEmptyString& label);
+  // Asks the running vault to move its chunkstore to 'vault_info.vault_dir'.
   void ChangeChunkstorePath(VaultInfo vault_info);
-
+  void RestartWithVaultDir(VaultInfo vault_info);
+  void PublishVaultEvent(VaultEvent vault_event);
+  void ArmDiskBudgetTimer();
+  // Returns the storage root for each of 'vault_infos' which has no vault dir, or an empty path if
+  // it has one, no storage roots are configured, or none of them can be used.
+  std::vector<boost::filesystem::path> ChooseStorageRoots(
+      const std::vector<VaultInfo>& vault_infos) const;
+  // Sends each connected vault whose allocation has changed its new limit, except for
+  // 'starting_vault' which is sent its limit in the VaultStartedResponse.
+  void RebalanceDiskBudget(tcp::ConnectionPtr starting_vault = nullptr);
+  void ArmDiskUsageScanTimer();
+  // Totals the vault dirs on a separate thread, unless the previous scan is still running.
+  void ScanDiskUsage();
+  void RecordDiskUsage(const std::vector<NonEmptyString>& labels,
+                       const std::vector<std::uint64_t>& totals,
+                       std::chrono::steady_clock::time_point scanned_at);
+
+  void ArmLogRotationTimer();
+  // Maintains the vaults' log folders on a low-priority thread, unless the previous pass is still
+  // running.
+  void RotateVaultLogs();
+  // Resizes the vault's reservation file to suit its allocation and 'bytes_used', if reservations
+  // are enabled.
+  void UpdateReservation(const VaultInfo& vault_info, std::uint64_t bytes_used);
+
+  struct MeasuredDiskUsage {
+    std::uint64_t bytes;
+    std::int64_t bytes_per_second;  // Since the previous scan.
+    std::chrono::steady_clock::time_point scanned_at;
+  };
+
+  struct Reservation {
+    boost::filesystem::path vault_dir;
+    std::uint64_t size;
+  };
+
+  const VaultManagerOptions kOptions_;
+  AdmissionControl admission_control_;
   ConfigFileHandler config_file_handler_;
-  bool network_stable_, tear_down_with_interval_;
+  VaultEventLog vault_event_log_;
+  VaultStatsHistory vault_stats_history_;
+  DiskBudget disk_budget_;
+  DiskUsageScanner disk_usage_scanner_;
+  VaultPlacement vault_placement_;
+  // Keyed by label, as at the last scan.
+  std::map<NonEmptyString, MeasuredDiskUsage> disk_usage_;
+  // Keyed by label.
+  std::map<NonEmptyString, Reservation> reservations_;
+  VaultLogRotator vault_log_rotator_;
+  // Keyed by label, holding the target of each vault which is moving its chunkstore.
+  std::map<NonEmptyString, VaultInfo> chunkstore_moves_;
+  bool network_stable_, tear_down_with_interval_, stopping_;
+  // Keyed by label, holding the owner of each vault whose keys are still being created.
+  std::map<NonEmptyString, Identity> creating_keys_;
   AsioService asio_service_;
   asio::io_service::strand strand_;
   std::shared_ptr<tcp::Listener> listener_;
   std::shared_ptr<ProcessManager> process_manager_;
   std::shared_ptr<ClientConnections> client_connections_;
   std::shared_ptr<NewConnections> new_connections_;
+  TimingWheel::Handle disk_budget_timer_, disk_usage_scan_timer_, log_rotation_timer_;
+  // Declared last, so that background work still running finishes before the members it uses are
+  // destroyed.
+  std::future<void> disk_usage_scan_, log_rotation_;
+  std::vector<std::future<void>> key_creations_;
 };
 
 }  // namespace vault_manager
@@ -22,6 +22,9 @@
 #include <signal.h>
 #endif
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <future>
 #include <iostream>
 #include <string>
@@ -133,9 +136,61 @@ BOOL CtrlHandler(DWORD control_type) {
 
 #endif
 
-void HandleProgramOptions(int argc, char** argv) {
+maidsafe::vault_manager::VaultManagerOptions HandleProgramOptions(int argc, char** argv) {
+  maidsafe::vault_manager::VaultManagerOptions vault_manager_options;
+  std::uint32_t heartbeat_interval_ms(
+      static_cast<std::uint32_t>(vault_manager_options.heartbeat_interval.count()));
+  std::uint32_t disk_budget_interval_s(
+      static_cast<std::uint32_t>(vault_manager_options.disk_budget_interval.count()));
+  std::uint32_t disk_usage_scan_interval_s(
+      static_cast<std::uint32_t>(vault_manager_options.disk_usage_scan_interval.count()));
+  std::uint32_t max_vault_log_file_age_h(
+      static_cast<std::uint32_t>(vault_manager_options.max_vault_log_file_age.count()));
+  std::uint32_t vault_drain_timeout_s(
+      static_cast<std::uint32_t>(vault_manager_options.vault_drain_timeout.count()));
   po::options_description options_description("Allowed options");
   options_description.add_options()
+      ("max_new_connections",
+       po::value<std::size_t>(&vault_manager_options.max_new_connections),
+       "Maximum number of accepted connections which haven't yet identified themselves")(
+          "max_unvalidated_clients",
+          po::value<std::size_t>(&vault_manager_options.max_unvalidated_clients),
+          "Maximum number of clients which haven't yet answered the validation challenge")(
+          "max_accepts_per_second",
+          po::value<std::uint32_t>(&vault_manager_options.max_accepts_per_second),
+          "Maximum rate of accepting new connections (0 for unlimited)")(
+          "heartbeat_interval_ms", po::value<std::uint32_t>(&heartbeat_interval_ms),
+          "Interval between vault heartbeats in milliseconds (0 to disable)")(
+          "heartbeat_miss_threshold",
+          po::value<int>(&vault_manager_options.heartbeat_miss_threshold),
+          "Consecutive heartbeat intervals without progress before a vault is restarted")(
+          "disk_budget_interval_s", po::value<std::uint32_t>(&disk_budget_interval_s),
+          "Interval in seconds between redistributing free disk space between vaults (0 to "
+          "disable)")(
+          "disk_budget_fraction", po::value<double>(&vault_manager_options.disk_budget_fraction),
+          "Fraction of free disk space which may be allocated to vaults")(
+          "disk_usage_scan_interval_s", po::value<std::uint32_t>(&disk_usage_scan_interval_s),
+          "Interval in seconds between totalling the disk usage of each vault (0 to disable)")(
+          "chunkstore_move_bytes_per_second",
+          po::value<std::uint64_t>(&vault_manager_options.chunkstore_move_bytes_per_second),
+          "I/O limit for a vault moving its chunkstore while running (0 for unlimited)")(
+          "keep_vaults_on_exit",
+          "Leave vaults running on exit, to be adopted by the next VaultManager")(
+          "no_vault_output_capture", "Don't capture vaults' stdout and stderr for clients to tail")(
+          "vault_drain_timeout_s", po::value<std::uint32_t>(&vault_drain_timeout_s),
+          "Seconds a stopping vault has to finish its in-flight work before being terminated")(
+          "storage_root", po::value<std::vector<std::string>>()->composing(),
+          "Directory under which new vaults may be placed (may be repeated, one per device)")(
+          "reservation_fraction",
+          po::value<double>(&vault_manager_options.reservation_fraction),
+          "Fraction of each vault's disk usage limit to preallocate for it (0 to disable)")(
+          "vault_log_budget", po::value<std::uint64_t>(&vault_manager_options.vault_log_budget),
+          "Maximum bytes of logs kept for each vault (0 to leave logs unmanaged)")(
+          "max_vault_log_file_size",
+          po::value<std::uint64_t>(&vault_manager_options.max_vault_log_file_size),
+          "Size in bytes at which a vault's log is rotated")(
+          "max_vault_log_file_age_h", po::value<std::uint32_t>(&max_vault_log_file_age_h),
+          "Hours after which a vault's log is rotated regardless of size")
 #ifdef TESTING
       ("port", po::value<int>(), "Listening port")("vault_path", po::value<std::string>(),
                                                    "Path to the vault executable including name")(
@@ -147,6 +202,19 @@ void HandleProgramOptions(int argc, char** argv) {
       po::command_line_parser(argc, argv).options(options_description).allow_unregistered().run(),
       variables_map);
   po::notify(variables_map);
+  vault_manager_options.heartbeat_interval = std::chrono::milliseconds(heartbeat_interval_ms);
+  vault_manager_options.disk_budget_interval = std::chrono::seconds(disk_budget_interval_s);
+  vault_manager_options.disk_usage_scan_interval =
+      std::chrono::seconds(disk_usage_scan_interval_s);
+  vault_manager_options.vault_drain_timeout = std::chrono::seconds(vault_drain_timeout_s);
+  vault_manager_options.max_vault_log_file_age = std::chrono::hours(max_vault_log_file_age_h);
+  vault_manager_options.stop_vaults_on_exit = (variables_map.count("keep_vaults_on_exit") == 0);
+  vault_manager_options.capture_vault_output =
+      (variables_map.count("no_vault_output_capture") == 0);
+  if (variables_map.count("storage_root") != 0) {
+    for (const auto& storage_root : variables_map.at("storage_root").as<std::vector<std::string>>())
+      vault_manager_options.storage_roots.emplace_back(storage_root);
+  }
 
   if (variables_map.count("help") != 0) {
     LOG(kError) << "Printing out help menu";
@@ -174,6 +242,7 @@ void HandleProgramOptions(int argc, char** argv) {
 
   maidsafe::vault_manager::test::SetEnvironment(port, root_dir, path_to_vault);
 #endif
+  return vault_manager_options;
 }
 
 }  // unnamed namespace
@@ -183,9 +252,9 @@ int main(int argc, char** argv) {
 #ifdef MAIDSAFE_WIN32
 #ifdef TESTING
   try {
-    HandleProgramOptions(argc, argv);
+    auto vault_manager_options(HandleProgramOptions(argc, argv));
     if (SetConsoleCtrlHandler(reinterpret_cast<PHANDLER_ROUTINE>(CtrlHandler), TRUE)) {
-      maidsafe::vault_manager::VaultManager vault_manager;
+      maidsafe::vault_manager::VaultManager vault_manager{vault_manager_options};
       g_shutdown_promise.get_future().get();
     } else {
       LOG(kError) << "Failed to set control handler.";
@@ -206,8 +275,7 @@ int main(int argc, char** argv) {
 #endif
 #else
   try {
-    HandleProgramOptions(argc, argv);
-    maidsafe::vault_manager::VaultManager vault_manager;
+    maidsafe::vault_manager::VaultManager vault_manager{HandleProgramOptions(argc, argv)};
     std::cout << "Successfully started vault_manager" << std::endl;
     signal(SIGINT, ShutDownVaultManager);
     signal(SIGTERM, ShutDownVaultManager);
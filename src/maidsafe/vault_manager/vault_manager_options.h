@@ -0,0 +1,111 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_OPTIONS_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_OPTIONS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Tunable settings for a VaultManager.  The defaults are taken from config.h.
+struct VaultManagerOptions {
+  VaultManagerOptions()
+      : max_new_connections(kMaxNewConnections),
+        max_unvalidated_clients(kMaxUnvalidatedClients),
+        max_accepts_per_second(kMaxAcceptsPerSecond),
+        accept_burst(kAcceptBurst),
+        max_concurrent_vault_starts(kMaxConcurrentVaultStarts),
+        heartbeat_interval(kHeartbeatInterval),
+        heartbeat_miss_threshold(kHeartbeatMissThreshold),
+        disk_budget_interval(kDiskBudgetInterval),
+        disk_budget_fraction(kDiskBudgetFraction),
+        disk_usage_scan_interval(kDiskUsageScanInterval),
+        chunkstore_move_bytes_per_second(kChunkstoreMoveBytesPerSecond),
+        stop_vaults_on_exit(true),
+        capture_vault_output(true),
+        vault_drain_timeout(kVaultDrainTimeout),
+        storage_roots(),
+        reservation_fraction(0.0),
+        vault_log_budget(kVaultLogBudget),
+        max_vault_log_file_size(kMaxVaultLogFileSize),
+        max_vault_log_file_age(kMaxVaultLogFileAge) {}
+
+  // Accepted connections which haven't yet identified themselves as a client or vault.
+  std::size_t max_new_connections;
+  // Clients which have requested validation but haven't yet answered the challenge.
+  std::size_t max_unvalidated_clients;
+  // Token-bucket limit on accepted connections.  A rate of 0 disables the limit.
+  std::uint32_t max_accepts_per_second;
+  std::uint32_t accept_burst;
+  // Vaults which have been spawned but haven't yet connected back.  Further starts are queued.
+  int max_concurrent_vault_starts;
+  // How often running vaults send a heartbeat, and how many consecutive intervals may pass without
+  // one showing progress before the vault is treated as hung and restarted.  An interval of 0
+  // disables heartbeats.
+  std::chrono::milliseconds heartbeat_interval;
+  int heartbeat_miss_threshold;
+  // How often free space on the filesystems hosting vault dirs is rechecked and the disk usage
+  // limits of the vaults redistributed (0 to only do this when a vault starts or changes owner),
+  // and the fraction of free space which may be allocated to vaults.
+  std::chrono::seconds disk_budget_interval;
+  double disk_budget_fraction;
+  // How often the files below each vault dir are totalled (0 to disable).  The totals are reported
+  // in each VaultStatus, and the disk budget treats each vault as using at least its total.
+  std::chrono::seconds disk_usage_scan_interval;
+  // I/O limit passed to a vault asked to move its chunkstore while running.  0 for unlimited.
+  std::uint64_t chunkstore_move_bytes_per_second;
+  // If false, running vaults are left running when the VaultManager is destroyed, to be adopted by
+  // the next VaultManager once they reconnect to it.  Ignored on Windows.
+  bool stop_vaults_on_exit;
+  // Whether each vault's stdout and stderr are piped to the VaultManager, which keeps the latest
+  // output for ClientInterface::TailVaultOutput.  A vault whose output is captured ignores SIGPIPE,
+  // so it survives the pipe's reader going away (the VaultManager crashing or releasing it), though
+  // its output is then discarded until it's restarted.  Vaults adopted from a previous VaultManager
+  // aren't captured.  Ignored on Windows.
+  bool capture_vault_output;
+  // How long a vault being stopped is given to finish its in-flight work before being terminated.
+  std::chrono::seconds vault_drain_timeout;
+  // Directories, ideally on separate devices, under which the dirs of vaults started without one
+  // are created.  See VaultPlacement for how a root is chosen.  If empty, such vault dirs are
+  // created in the VaultManager's app support dir.
+  std::vector<boost::filesystem::path> storage_roots;
+  // If non-zero, the fraction of each vault's disk usage limit which is held for it in a
+  // preallocated file in its vault dir until it's used.  See storage_reservation.h.
+  double reservation_fraction;
+  // Bytes which each vault's log folder may hold (0 to leave logs unmanaged), and the size and age
+  // at which a vault's log is rotated.  See VaultLogRotator.
+  std::uint64_t vault_log_budget;
+  std::uint64_t max_vault_log_file_size;
+  std::chrono::hours max_vault_log_file_age;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_OPTIONS_H_
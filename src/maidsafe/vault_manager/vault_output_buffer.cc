@@ -0,0 +1,141 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_output_buffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+VaultOutputBuffer::VaultOutputBuffer(std::size_t capacity) : buffer_(capacity), end_(0) {
+  assert(capacity != 0);
+}
+
+void VaultOutputBuffer::Append(const char* data, std::size_t size) {
+  // Only the part which won't be immediately overwritten needs copying.
+  if (size > buffer_.size()) {
+    end_ += size - buffer_.size();
+    data += size - buffer_.size();
+    size = buffer_.size();
+  }
+  while (size != 0) {
+    const std::size_t kOffset{static_cast<std::size_t>(end_ % buffer_.size())};
+    const std::size_t kCount{std::min(size, buffer_.size() - kOffset)};
+    std::memcpy(&buffer_[kOffset], data, kCount);
+    data += kCount;
+    size -= kCount;
+    end_ += kCount;
+  }
+}
+
+VaultOutput VaultOutputBuffer::Read(std::uint64_t cursor, std::size_t max_size) const {
+  VaultOutput output;
+  output.begin = (cursor < Begin() || cursor > end_) ? Begin() : cursor;
+  std::size_t size{static_cast<std::size_t>(std::min<std::uint64_t>(end_ - output.begin,
+                                                                     max_size))};
+  output.next_cursor = output.begin + size;
+  output.data.reserve(size);
+  std::size_t offset{static_cast<std::size_t>(output.begin % buffer_.size())};
+  while (size != 0) {
+    const std::size_t kCount{std::min(size, buffer_.size() - offset)};
+    output.data.append(&buffer_[offset], kCount);
+    size -= kCount;
+    offset = 0;
+  }
+  return output;
+}
+
+std::string VaultOutputBuffer::Tail(std::size_t size) const {
+  return Read(end_ - std::min<std::uint64_t>(size, end_ - Begin()), size).data;
+}
+
+std::uint64_t VaultOutputBuffer::Begin() const {
+  return end_ > buffer_.size() ? end_ - buffer_.size() : 0;
+}
+
+std::uint64_t VaultOutputBuffer::End() const { return end_; }
+
+#ifndef MAIDSAFE_WIN32
+VaultOutputReader::VaultOutputReader(asio::io_service& io_service, int pipe_fd,
+                                     std::shared_ptr<VaultOutputBuffer> output)
+    : descriptor_(io_service, pipe_fd),
+      output_(std::move(output)),
+      read_buffer_(),
+      closed_(false),
+      persist_path_(),
+      persist_size_(0) {}
+
+std::shared_ptr<VaultOutputReader> VaultOutputReader::MakeShared(
+    asio::io_service& io_service, int pipe_fd, std::shared_ptr<VaultOutputBuffer> output) {
+  std::shared_ptr<VaultOutputReader> reader{
+      new VaultOutputReader{io_service, pipe_fd, std::move(output)}};
+  reader->Read();
+  return reader;
+}
+
+void VaultOutputReader::PersistTailOnClose(fs::path path, std::size_t size) {
+  persist_path_ = std::move(path);
+  persist_size_ = size;
+  if (closed_)
+    PersistTail();
+}
+
+void VaultOutputReader::Read() {
+  auto self(shared_from_this());
+  descriptor_.async_read_some(asio::buffer(read_buffer_),
+                              [self](const std::error_code& error, std::size_t size) {
+    self->output_->Append(self->read_buffer_.data(), size);
+    if (!error) {
+      self->Read();
+      return;
+    }
+    if (error != asio::error::eof)
+      LOG(kWarning) << "Stopped reading vault output: " << error.message();
+    std::error_code ignored_ec;
+    self->descriptor_.close(ignored_ec);
+    self->closed_ = true;
+    if (!self->persist_path_.empty())
+      self->PersistTail();
+  });
+}
+
+void VaultOutputReader::PersistTail() {
+  boost::system::error_code ec;
+  fs::create_directories(persist_path_.parent_path(), ec);
+  if (!WriteFile(persist_path_, output_->Tail(persist_size_)))
+    LOG(kWarning) << "Failed to write vault output to " << persist_path_;
+  else
+    LOG(kInfo) << "Wrote last " << persist_size_ << " bytes of vault output to " << persist_path_;
+  persist_path_.clear();
+}
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
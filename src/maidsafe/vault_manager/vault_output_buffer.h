@@ -0,0 +1,92 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_OUTPUT_BUFFER_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_OUTPUT_BUFFER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#ifndef MAIDSAFE_WIN32
+#include "asio/posix/stream_descriptor.hpp"
+#endif
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/vault_manager/vault_output.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Retains the most recent 'capacity' bytes of a vault's console output.  Not threadsafe.
+class VaultOutputBuffer {
+ public:
+  explicit VaultOutputBuffer(std::size_t capacity);
+
+  void Append(const char* data, std::size_t size);
+  // Returns up to 'max_size' bytes from 'cursor', or from the oldest byte retained if 'cursor' has
+  // been overwritten or lies beyond End() (e.g. it was issued by a previous VaultManager).
+  VaultOutput Read(std::uint64_t cursor, std::size_t max_size) const;
+  // Returns the last 'size' bytes retained.
+  std::string Tail(std::size_t size) const;
+  std::uint64_t Begin() const;
+  std::uint64_t End() const;
+
+ private:
+  std::vector<char> buffer_;
+  std::uint64_t end_;
+};
+
+#ifndef MAIDSAFE_WIN32
+// Reads from the read end of a vault's stdout/stderr pipe into 'output' until the vault closes the
+// write end, normally by exiting.  Not threadsafe, so 'io_service' must be run by a single thread
+// which is also the one using 'output'.
+class VaultOutputReader : public std::enable_shared_from_this<VaultOutputReader> {
+ public:
+  // Takes ownership of 'pipe_fd' and starts reading.
+  static std::shared_ptr<VaultOutputReader> MakeShared(asio::io_service& io_service, int pipe_fd,
+                                                       std::shared_ptr<VaultOutputBuffer> output);
+  // Once the pipe has been closed (which may already be the case), writes the last 'size' bytes of
+  // output to 'path', so that the output leading up to a crash survives the VaultManager.
+  void PersistTailOnClose(boost::filesystem::path path, std::size_t size);
+
+ private:
+  VaultOutputReader(asio::io_service& io_service, int pipe_fd,
+                    std::shared_ptr<VaultOutputBuffer> output);
+  void Read();
+  void PersistTail();
+
+  asio::posix::stream_descriptor descriptor_;
+  std::shared_ptr<VaultOutputBuffer> output_;
+  std::array<char, 4096> read_buffer_;
+  bool closed_;
+  boost::filesystem::path persist_path_;
+  std::size_t persist_size_;
+};
+#endif
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_OUTPUT_BUFFER_H_
@@ -0,0 +1,135 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_placement.h"
+
+#ifdef __linux__
+#include <sys/sysmacros.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+std::uint64_t GetDeviceIoTicks(std::uint64_t filesystem_id) {
+#ifdef __linux__
+  // Field 10 of the block device's stat file is the time spent doing I/O in milliseconds.
+  const auto kDevice(static_cast<dev_t>(filesystem_id));
+  std::ifstream stat_file{"/sys/dev/block/" + std::to_string(major(kDevice)) + ":" +
+                          std::to_string(minor(kDevice)) + "/stat"};
+  std::uint64_t field(0);
+  for (int i(0); i < 10 && stat_file >> field; ++i) {
+  }
+  if (!stat_file) {
+    LOG(kVerbose) << "No I/O statistics for device " << major(kDevice) << ":" << minor(kDevice);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  return field;
+#else
+  static_cast<void>(filesystem_id);
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+#endif
+}
+
+VaultPlacement::VaultPlacement(std::vector<fs::path> storage_roots, GetSpaceFunctor get_space,
+                               GetIoTicksFunctor get_io_ticks)
+    : kStorageRoots_(std::move(storage_roots)),
+      kGetSpace_(std::move(get_space)),
+      kGetIoTicks_(std::move(get_io_ticks)),
+      io_samples_() {}
+
+bool VaultPlacement::Enabled() const { return !kStorageRoots_.empty(); }
+
+void VaultPlacement::SampleIoUtilisation() {
+  std::map<std::uint64_t, IoSample> io_samples;
+  for (const auto& storage_root : kStorageRoots_) {
+    try {
+      const std::uint64_t kId{kGetSpace_(storage_root).id};
+      if (io_samples.count(kId) != 0)
+        continue;
+      IoSample sample{kGetIoTicks_(kId), std::chrono::steady_clock::now(), 0.0};
+      auto itr(io_samples_.find(kId));
+      if (itr != std::end(io_samples_) && sample.io_ticks >= itr->second.io_ticks) {
+        const auto kElapsed(std::chrono::duration_cast<std::chrono::milliseconds>(
+            sample.sampled_at - itr->second.sampled_at));
+        if (kElapsed.count() > 0) {
+          sample.utilisation =
+              std::min(1.0, static_cast<double>(sample.io_ticks - itr->second.io_ticks) /
+                                static_cast<double>(kElapsed.count()));
+        }
+      }
+      io_samples.emplace(kId, sample);
+    } catch (const std::exception&) {
+    }  // Treated as idle.
+  }
+  io_samples_.swap(io_samples);
+}
+
+fs::path VaultPlacement::ChooseRoot(const std::vector<fs::path>& vault_dirs) const {
+  std::map<std::uint64_t, std::size_t> vault_counts;
+  for (const auto& vault_dir : vault_dirs) {
+    try {
+      ++vault_counts[kGetSpace_(vault_dir).id];
+    } catch (const std::exception&) {
+    }  // A vault whose dir can't be queried doesn't count against any root.
+  }
+
+  const fs::path* chosen_root(nullptr);
+  double best_score(-1.0);
+  for (const auto& storage_root : kStorageRoots_) {
+    try {
+      FilesystemSpace space{kGetSpace_(storage_root)};
+      auto count_itr(vault_counts.find(space.id));
+      const std::size_t kVaultCount{count_itr == std::end(vault_counts) ? 0 : count_itr->second};
+      auto sample_itr(io_samples_.find(space.id));
+      const double kUtilisation{
+          sample_itr == std::end(io_samples_) ? 0.0 : sample_itr->second.utilisation};
+      // A saturated device keeps a small weighting, so that space still separates such roots.
+      const double kScore{static_cast<double>(space.available) /
+                          static_cast<double>(kVaultCount + 1) *
+                          (1.0 - std::min(kUtilisation, 0.95))};
+      if (kScore > best_score) {
+        best_score = kScore;
+        chosen_root = &storage_root;
+      }
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Can't place a vault under " << storage_root << ": "
+                    << boost::diagnostic_information(e);
+    }
+  }
+
+  if (!chosen_root) {
+    LOG(kError) << "None of the " << kStorageRoots_.size() << " storage roots can be used.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  return *chosen_root;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
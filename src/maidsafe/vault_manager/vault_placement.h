@@ -0,0 +1,81 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_PLACEMENT_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_PLACEMENT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/vault_manager/disk_budget.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Returns the cumulative milliseconds the device hosting filesystem 'filesystem_id' has spent doing
+// I/O.  Throws if this isn't available, which is always the case other than on Linux.
+std::uint64_t GetDeviceIoTicks(std::uint64_t filesystem_id);
+
+// Chooses the storage root under which the dir of a new vault is created, so that vaults spread
+// across the devices hosting the roots.  Each root is scored as its free space shared between the
+// vaults already on its filesystem plus the new one, reduced in proportion to how busy its device
+// was over the last sampling interval, and the highest score wins.  Not threadsafe; the
+// VaultManager only uses this on its own thread.
+class VaultPlacement {
+ public:
+  typedef DiskBudget::GetSpaceFunctor GetSpaceFunctor;
+  typedef std::function<std::uint64_t(std::uint64_t)> GetIoTicksFunctor;
+
+  explicit VaultPlacement(std::vector<boost::filesystem::path> storage_roots,
+                          GetSpaceFunctor get_space = GetFilesystemSpace,
+                          GetIoTicksFunctor get_io_ticks = GetDeviceIoTicks);
+
+  // False if no storage roots were configured, in which case vault dirs default to GetVaultDir.
+  bool Enabled() const;
+  // Records the utilisation of each root's device since the previous call.  Devices whose I/O
+  // statistics can't be read are treated as idle.
+  void SampleIoUtilisation();
+  // Returns the root for a new vault, given the dirs of the existing vaults.  Throws if no root can
+  // be queried.
+  boost::filesystem::path ChooseRoot(const std::vector<boost::filesystem::path>& vault_dirs) const;
+
+ private:
+  struct IoSample {
+    std::uint64_t io_ticks;
+    std::chrono::steady_clock::time_point sampled_at;
+    double utilisation;
+  };
+
+  const std::vector<boost::filesystem::path> kStorageRoots_;
+  const GetSpaceFunctor kGetSpace_;
+  const GetIoTicksFunctor kGetIoTicks_;
+  // Keyed by filesystem ID.
+  std::map<std::uint64_t, IoSample> io_samples_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_PLACEMENT_H_
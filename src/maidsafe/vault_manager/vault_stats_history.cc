@@ -0,0 +1,93 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_stats_history.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+double PerSecond(std::uint64_t count, std::chrono::steady_clock::duration duration) {
+  return static_cast<double>(count) /
+         std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+}
+
+}  // unnamed namespace
+
+VaultStatsHistory::VaultStatsHistory(std::size_t samples_per_vault)
+    : kSamplesPerVault_(std::max(samples_per_vault, std::size_t{2})), history_() {}
+
+void VaultStatsHistory::Add(const NonEmptyString& label, const VaultStats& stats,
+                            TimePoint time) {
+  auto& samples(history_[label]);
+  if (samples.size() == kSamplesPerVault_)
+    samples.pop_front();
+  samples.push_back(Sample{time, stats});
+}
+
+HostStats VaultStatsHistory::GetHostStats(const std::vector<VaultStatus>& vaults) {
+  HostStats host_stats;
+  std::map<NonEmptyString, std::deque<Sample>> current_history;
+  for (const auto& vault : vaults) {
+    auto itr(history_.find(vault.label));
+    if (itr == std::end(history_))
+      continue;
+    VaultStatsSummary summary{Summarise(itr->second)};
+    summary.label = vault.label;
+    summary.max_disk_usage = vault.max_disk_usage;
+    host_stats.chunk_count += summary.latest.chunk_count;
+    host_stats.bytes_used += summary.latest.bytes_used;
+    host_stats.max_disk_usage = DiskUsage{host_stats.max_disk_usage.data +
+                                          summary.max_disk_usage.data};
+    host_stats.get_requests_per_second += summary.get_requests_per_second;
+    host_stats.put_requests_per_second += summary.put_requests_per_second;
+    host_stats.vaults.push_back(std::move(summary));
+    current_history.insert(std::move(*itr));
+  }
+  history_.swap(current_history);
+  return host_stats;
+}
+
+VaultStatsSummary VaultStatsHistory::Summarise(const std::deque<Sample>& samples) const {
+  VaultStatsSummary summary;
+  summary.latest = samples.back().stats;
+  // Counts are reset if the vault restarts, so only use samples since the latest restart.
+  auto first(std::prev(std::end(samples)));
+  while (first != std::begin(samples) &&
+         std::prev(first)->stats.get_requests <= first->stats.get_requests &&
+         std::prev(first)->stats.put_requests <= first->stats.put_requests) {
+    --first;
+  }
+  const auto kElapsed(samples.back().time - first->time);
+  if (kElapsed > std::chrono::steady_clock::duration::zero()) {
+    summary.get_requests_per_second =
+        PerSecond(summary.latest.get_requests - first->stats.get_requests, kElapsed);
+    summary.put_requests_per_second =
+        PerSecond(summary.latest.put_requests - first->stats.put_requests, kElapsed);
+  }
+  return summary;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,68 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_STATS_HISTORY_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_STATS_HISTORY_H_
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_stats.h"
+#include "maidsafe/vault_manager/vault_status.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Retains the most recent 'samples_per_vault' stats reports of each vault and aggregates them for
+// the host.  Not threadsafe; the VaultManager only uses this on its own thread.
+class VaultStatsHistory {
+ public:
+  typedef std::chrono::steady_clock::time_point TimePoint;
+
+  explicit VaultStatsHistory(std::size_t samples_per_vault = kVaultStatsHistorySize);
+
+  void Add(const NonEmptyString& label, const VaultStats& stats,
+           TimePoint time = std::chrono::steady_clock::now());
+  // Summarises each of 'vaults' which has reported stats, and sums these for the host.  History of
+  // any vault not in 'vaults' is discarded.
+  HostStats GetHostStats(const std::vector<VaultStatus>& vaults);
+
+ private:
+  struct Sample {
+    TimePoint time;
+    VaultStats stats;
+  };
+
+  VaultStatsSummary Summarise(const std::deque<Sample>& samples) const;
+
+  const std::size_t kSamplesPerVault_;
+  std::map<NonEmptyString, std::deque<Sample>> history_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_STATS_HISTORY_H_